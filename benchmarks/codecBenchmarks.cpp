@@ -0,0 +1,406 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "PcapPacketParser.h"
+#include "../src/pmu/c37118.h"
+#include "../src/pmu/c37118Crc.h"
+#include "../src/pmu/FrameExtractor.hpp"
+#include "../src/pmu/FrameLayout.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace c37118;
+
+/* the frames of a capture with the configuration of each data source*/
+class CaptureFrames
+{
+  public:
+    std::vector<std::vector<std::uint8_t>> configFrames;
+    std::vector<std::vector<std::uint8_t>> dataFrames;
+    std::vector<std::vector<std::uint8_t>> allFrames;
+    std::map<std::uint16_t, Config> configs;
+    std::size_t dataBytes{0U};
+    std::size_t allBytes{0U};
+
+    const Config &configFor(const std::vector<std::uint8_t> &frame) const
+    {
+        return configs.at(getIdCode(frame.data(), frame.size()));
+    }
+};
+
+static const CaptureFrames &loadCapture(const std::string &file)
+{
+    static std::map<std::string, CaptureFrames> captures;
+    auto found = captures.find(file);
+    if (found != captures.end())
+    {
+        return found->second;
+    }
+    auto &capture = captures[file];
+    PcapPacketParser parser(std::string(TEST_DIR "/") + file);
+    // the packets are pushed as a stream so frames split across TCP segments are reassembled
+    FrameExtractor extractor;
+    FrameSpan span;
+    for (std::size_t ii = 0; ii < parser.packetCount(); ++ii)
+    {
+        const auto &pkt = parser.getPacket(ii);
+        extractor.push(pkt.data(), pkt.size());
+        while (extractor.next(span))
+        {
+            capture.allFrames.emplace_back(span.data, span.data + span.size);
+        }
+    }
+    for (const auto &frame : capture.allFrames)
+    {
+        capture.allBytes += frame.size();
+        if (getPacketType(frame.data(), frame.size()) == PmuPacketType::config2)
+        {
+            Config cfg;
+            if (parseConfig2(frame.data(), frame.size(), cfg) == ParseResult::parse_complete)
+            {
+                capture.configFrames.push_back(frame);
+                capture.configs[cfg.idcode] = std::move(cfg);
+            }
+        }
+    }
+    for (const auto &frame : capture.allFrames)
+    {
+        if (getPacketType(frame.data(), frame.size()) == PmuPacketType::data &&
+            capture.configs.count(getIdCode(frame.data(), frame.size())) > 0)
+        {
+            capture.dataFrames.push_back(frame);
+            capture.dataBytes += frame.size();
+        }
+    }
+    return capture;
+}
+
+/* a single PMU with phasorCount phasors,  four analogs and a digital word in integer or floating point format*/
+static Config wideConfig(std::uint16_t phasorCount, bool floating)
+{
+    Config cfg;
+    cfg.idcode = 101;
+    PmuConfig pmu{};
+    pmu.stationName = "BENCH";
+    pmu.sourceID = 101;
+    pmu.phasorFormat = floating ? floating_point_format : integer_format;
+    pmu.analogFormat = floating ? floating_point_format : integer_format;
+    pmu.freqFormat = floating ? floating_point_format : integer_format;
+    pmu.phasorCoordinates = rectangular_phasor;
+    pmu.phasorCount = phasorCount;
+    pmu.analogCount = 4;
+    pmu.digitalWordCount = 1;
+    for (std::uint16_t ii = 0; ii < phasorCount; ++ii)
+    {
+        pmu.phasorNames.push_back("PH" + std::to_string(ii));
+        pmu.phasorType.push_back(PhasorType::voltage);
+        pmu.phasorConversion.push_back(915527U);
+    }
+    for (std::uint16_t ii = 0; ii < pmu.analogCount; ++ii)
+    {
+        pmu.analogNames.push_back("AN" + std::to_string(ii));
+        pmu.analogType.push_back(AnalogType::rms);
+        pmu.analogConversion.push_back(1);
+    }
+    for (int ii = 0; ii < 16; ++ii)
+    {
+        pmu.digitChannelNames.push_back("D" + std::to_string(ii));
+    }
+    pmu.digitalNominal.push_back(0);
+    pmu.digitalActive.push_back(0xFFFF);
+    cfg.pmus.push_back(std::move(pmu));
+    updateFrameLayout(cfg);
+    return cfg;
+}
+
+/* bits of the formats argument of the codec benchmarks*/
+static constexpr int float_phasors{1};
+static constexpr int polar_phasors{2};
+static constexpr int float_frequency{4};
+static constexpr int float_analogs{8};
+
+/* the wide configuration with the phasor coordinates and the format of each field selected by the bits of formats*/
+static Config codecConfig(std::uint16_t phasorCount, int formats)
+{
+    auto cfg = wideConfig(phasorCount, false);
+    auto &pmu = cfg.pmus[0];
+    pmu.phasorFormat = ((formats & float_phasors) != 0) ? floating_point_format : integer_format;
+    pmu.phasorCoordinates = ((formats & polar_phasors) != 0) ? polar_phasor : rectangular_phasor;
+    pmu.freqFormat = ((formats & float_frequency) != 0) ? floating_point_format : integer_format;
+    pmu.analogFormat = ((formats & float_analogs) != 0) ? floating_point_format : integer_format;
+    updateFrameLayout(cfg);
+    return cfg;
+}
+
+static PmuDataFrame wideFrame(const Config &cfg)
+{
+    PmuDataFrame frame;
+    frame.idcode = cfg.idcode;
+    frame.soc = 1600000000U;
+    frame.fracSec = 0.5;
+    frame.timeQuality = 0;
+    frame.pmus.resize(cfg.pmus.size());
+    for (std::size_t ii = 0; ii < cfg.pmus.size(); ++ii)
+    {
+        auto &pmu = frame.pmus[ii];
+        pmu.stat = 0;
+        pmu.freq = 0.01;
+        pmu.rocof = 0.0;
+        for (std::uint16_t jj = 0; jj < cfg.pmus[ii].phasorCount; ++jj)
+        {
+            pmu.phasors.push_back(std::polar(1000.0 + jj, 0.01 * jj));
+        }
+        pmu.analog.assign(cfg.pmus[ii].analogCount, 12.0);
+        pmu.digital.assign(cfg.pmus[ii].digitalWordCount, 0x00FF);
+    }
+    return frame;
+}
+
+static void setRates(benchmark::State &state, std::size_t framesPerIteration, std::size_t bytesPerIteration)
+{
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * framesPerIteration));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytesPerIteration));
+    state.counters["frames/s"] = benchmark::Counter(static_cast<double>(state.iterations() * framesPerIteration),
+                                                    benchmark::Counter::kIsRate);
+}
+
+static void BM_parseCommon(benchmark::State &state, const char *file)
+{
+    const auto &capture = loadCapture(file);
+    CommonFrame common;
+    for (auto _ : state)
+    {
+        for (const auto &frame : capture.allFrames)
+        {
+            benchmark::DoNotOptimize(parseCommon(frame.data(), frame.size(), common));
+        }
+    }
+    setRates(state, capture.allFrames.size(), capture.allBytes);
+}
+
+static void BM_parseConfig2(benchmark::State &state, const char *file)
+{
+    const auto &capture = loadCapture(file);
+    std::size_t bytes{0U};
+    for (const auto &frame : capture.configFrames)
+    {
+        bytes += frame.size();
+    }
+    for (auto _ : state)
+    {
+        for (const auto &frame : capture.configFrames)
+        {
+            Config cfg;
+            benchmark::DoNotOptimize(parseConfig2(frame.data(), frame.size(), cfg));
+        }
+    }
+    setRates(state, capture.configFrames.size(), bytes);
+}
+
+static void BM_parseDataFrame(benchmark::State &state, const char *file)
+{
+    const auto &capture = loadCapture(file);
+    PmuDataFrame pdf;
+    for (auto _ : state)
+    {
+        for (const auto &frame : capture.dataFrames)
+        {
+            benchmark::DoNotOptimize(parseDataFrame(frame.data(), frame.size(), capture.configFor(frame), pdf));
+        }
+    }
+    setRates(state, capture.dataFrames.size(), capture.dataBytes);
+}
+
+static void BM_generateDataFrame(benchmark::State &state, const char *file)
+{
+    const auto &capture = loadCapture(file);
+    std::vector<PmuDataFrame> frames;
+    for (const auto &frame : capture.dataFrames)
+    {
+        frames.push_back(parseDataFrame(frame.data(), frame.size(), capture.configFor(frame)));
+    }
+    std::vector<std::uint8_t> buffer(max_frame_size);
+    for (auto _ : state)
+    {
+        for (std::size_t ii = 0; ii < frames.size(); ++ii)
+        {
+            benchmark::DoNotOptimize(generateDataFrame(
+              buffer.data(), buffer.size(), capture.configFor(capture.dataFrames[ii]), frames[ii]));
+        }
+        benchmark::ClobberMemory();
+    }
+    setRates(state, frames.size(), capture.dataBytes);
+}
+
+#define CAPTURE_BENCHMARKS(func)                                                                                     \
+    BENCHMARK_CAPTURE(func, pmu1_tcp, "C37.118_1PMU_TCP.pcap");                                                    \
+    BENCHMARK_CAPTURE(func, pmu1_udp, "C37.118_1PMU_UDP.pcap");                                                    \
+    BENCHMARK_CAPTURE(func, pmu2_tcp, "C37.118_2PMUsInSync_TCP.pcap");                                             \
+    BENCHMARK_CAPTURE(func, pmu4_tcp, "C37.118_4in1PMU_TCP.pcap")
+
+CAPTURE_BENCHMARKS(BM_parseCommon);
+CAPTURE_BENCHMARKS(BM_parseConfig2);
+CAPTURE_BENCHMARKS(BM_parseDataFrame);
+CAPTURE_BENCHMARKS(BM_generateDataFrame);
+
+/* synthetic configurations,  arguments are the phasor count and 1 for floating point formats*/
+static void wideArguments(benchmark::internal::Benchmark *bench)
+{
+    bench->ArgNames({"phasors", "float"});
+    for (int floating : {0, 1})
+    {
+        for (int phasors : {1, 8, 64, 256})
+        {
+            bench->Args({phasors, floating});
+        }
+    }
+}
+
+static void BM_parseConfig2Wide(benchmark::State &state)
+{
+    auto cfg = wideConfig(static_cast<std::uint16_t>(state.range(0)), state.range(1) != 0);
+    std::vector<std::uint8_t> buffer(max_frame_size);
+    auto size = generateConfig2(buffer.data(), buffer.size(), cfg);
+    Config check;
+    if (parseConfig2(buffer.data(), size, check) != ParseResult::parse_complete)
+    {
+        state.SkipWithError("generated configuration does not parse");
+        return;
+    }
+    for (auto _ : state)
+    {
+        Config parsed;
+        benchmark::DoNotOptimize(parseConfig2(buffer.data(), size, parsed));
+    }
+    setRates(state, 1U, size);
+}
+BENCHMARK(BM_parseConfig2Wide)->Apply(wideArguments);
+
+static void BM_parseDataFrameWide(benchmark::State &state)
+{
+    auto cfg = wideConfig(static_cast<std::uint16_t>(state.range(0)), state.range(1) != 0);
+    std::vector<std::uint8_t> buffer(max_frame_size);
+    auto size = generateDataFrame(buffer.data(), buffer.size(), cfg, wideFrame(cfg));
+    PmuDataFrame pdf;
+    if (parseDataFrame(buffer.data(), size, cfg, pdf) != ParseResult::parse_complete)
+    {
+        state.SkipWithError("generated data frame does not parse");
+        return;
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(parseDataFrame(buffer.data(), size, cfg, pdf));
+    }
+    setRates(state, 1U, size);
+}
+BENCHMARK(BM_parseDataFrameWide)->Apply(wideArguments);
+
+static void BM_generateDataFrameWide(benchmark::State &state)
+{
+    auto cfg = wideConfig(static_cast<std::uint16_t>(state.range(0)), state.range(1) != 0);
+    auto frame = wideFrame(cfg);
+    std::vector<std::uint8_t> buffer(max_frame_size);
+    std::uint16_t size{0U};
+    for (auto _ : state)
+    {
+        size = generateDataFrame(buffer.data(), buffer.size(), cfg, frame);
+        benchmark::ClobberMemory();
+    }
+    setRates(state, 1U, size);
+}
+BENCHMARK(BM_generateDataFrameWide)->Apply(wideArguments);
+
+/* every combination of phasor coordinates and field formats,  each selects its own block codec,  arguments are the
+phasor count and the bits of the formats*/
+static void codecArguments(benchmark::internal::Benchmark *bench)
+{
+    bench->ArgNames({"phasors", "formats"});
+    for (int formats = 0; formats < 16; ++formats)
+    {
+        for (int phasors : {8, 64})
+        {
+            bench->Args({phasors, formats});
+        }
+    }
+}
+
+static void BM_parseDataFrameCodec(benchmark::State &state)
+{
+    auto cfg = codecConfig(static_cast<std::uint16_t>(state.range(0)), static_cast<int>(state.range(1)));
+    std::vector<std::uint8_t> buffer(max_frame_size);
+    auto size = generateDataFrame(buffer.data(), buffer.size(), cfg, wideFrame(cfg));
+    PmuDataFrame pdf;
+    if (parseDataFrame(buffer.data(), size, cfg, pdf) != ParseResult::parse_complete)
+    {
+        state.SkipWithError("generated data frame does not parse");
+        return;
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(parseDataFrame(buffer.data(), size, cfg, pdf));
+    }
+    setRates(state, 1U, size);
+}
+BENCHMARK(BM_parseDataFrameCodec)->Apply(codecArguments);
+
+static void BM_generateDataFrameCodec(benchmark::State &state)
+{
+    auto cfg = codecConfig(static_cast<std::uint16_t>(state.range(0)), static_cast<int>(state.range(1)));
+    auto frame = wideFrame(cfg);
+    std::vector<std::uint8_t> buffer(max_frame_size);
+    std::uint16_t size{0U};
+    for (auto _ : state)
+    {
+        size = generateDataFrame(buffer.data(), buffer.size(), cfg, frame);
+        benchmark::ClobberMemory();
+    }
+    setRates(state, 1U, size);
+}
+BENCHMARK(BM_generateDataFrameCodec)->Apply(codecArguments);
+
+static void BM_generateCommand(benchmark::State &state)
+{
+    std::uint8_t buffer[64];
+    std::uint16_t size{0U};
+    for (auto _ : state)
+    {
+        size = generateCommand(buffer, sizeof(buffer), PmuCommand::data_on, 7);
+        benchmark::ClobberMemory();
+    }
+    setRates(state, 1U, size);
+}
+BENCHMARK(BM_generateCommand);
+
+/* the CRC over the frame of a synthetic configuration,  argument is the phasor count*/
+static void BM_calculateCRC(benchmark::State &state)
+{
+    auto cfg = wideConfig(static_cast<std::uint16_t>(state.range(0)), true);
+    std::vector<std::uint8_t> buffer(max_frame_size);
+    auto size = generateDataFrame(buffer.data(), buffer.size(), cfg, wideFrame(cfg));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(crcCCITT(buffer.data(), size - 2U));
+    }
+    setRates(state, 1U, size);
+}
+BENCHMARK(BM_calculateCRC)->ArgName("phasors")->Arg(1)->Arg(8)->Arg(64)->Arg(256);
+
+static void BM_generateTimeCodes(benchmark::State &state)
+{
+    std::chrono::nanoseconds tp{1'600'000'000'000'000'000LL};
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(generateTimeCodes(tp, 1'000'000U));
+        tp += std::chrono::nanoseconds(33'333'333);
+    }
+    setRates(state, 1U, 0U);
+}
+BENCHMARK(BM_generateTimeCodes);
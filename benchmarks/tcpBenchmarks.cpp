@@ -0,0 +1,198 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "../src/pmu/TcpHelperClasses.h"
+#include "../src/pmu/c37118.h"
+
+#include <asio/executor_work_guard.hpp>
+#include <asio/write.hpp>
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace c37118;
+using tcp = asio::ip::tcp;
+
+/* the bytes received in each iteration*/
+static constexpr std::size_t bytes_per_iteration{8U << 20U};
+
+/* a stream of data frames with the given number of phasors*/
+static std::vector<std::uint8_t> frameStream(std::uint16_t phasorCount, std::size_t &frameSize)
+{
+    Config cfg;
+    cfg.idcode = 11;
+    PmuConfig pmu;
+    pmu.stationName = "BENCH";
+    pmu.sourceID = 11;
+    pmu.phasorFormat = floating_point_format;
+    pmu.freqFormat = floating_point_format;
+    pmu.phasorCount = phasorCount;
+    pmu.analogCount = 0;
+    pmu.digitalWordCount = 0;
+    for (std::uint16_t ii = 0; ii < phasorCount; ++ii)
+    {
+        pmu.phasorNames.push_back("V" + std::to_string(ii));
+    }
+    pmu.phasorType.assign(phasorCount, PhasorType::voltage);
+    pmu.phasorConversion.assign(phasorCount, 1U);
+    cfg.pmus.push_back(pmu);
+
+    PmuDataFrame frame;
+    frame.idcode = cfg.idcode;
+    frame.pmus.resize(1);
+    frame.pmus[0].phasors.assign(phasorCount, std::complex<double>(120.0, 0.0));
+    std::vector<std::uint8_t> buffer(max_frame_size);
+    frameSize = generateDataFrame(buffer.data(), buffer.size(), cfg, frame);
+    // the stream length is not a multiple of the receive buffer so frames are split across reads
+    std::vector<std::uint8_t> stream;
+    while (stream.size() < (1U << 20U))
+    {
+        stream.insert(stream.end(), buffer.begin(), buffer.begin() + frameSize);
+    }
+    return stream;
+}
+
+/* the size of the complete frames at the start of the data,  the rest is left in the connection buffer*/
+static std::size_t completeFrames(const char *data, std::size_t size)
+{
+    const auto *bytes = reinterpret_cast<const std::uint8_t *>(data);
+    std::size_t used{0U};
+    while (size - used >= 16U)
+    {
+        const std::size_t frameSize = getPacketSize(bytes + used, size - used);
+        if (frameSize == 0U || frameSize > size - used)
+        {
+            break;
+        }
+        used += frameSize;
+    }
+    return used;
+}
+
+/* the work the connection did after every read before the receive buffer became a sliding window,  the unconsumed
+bytes were moved to the front of the buffer and the whole buffer was cleared when everything was consumed*/
+static void compactBuffer(std::vector<char> &buffer, const char *data, std::size_t size, std::size_t used)
+{
+    if (used < size)
+    {
+        std::copy(data + used, data + size, buffer.data());
+    }
+    else
+    {
+        std::fill(buffer.begin(), buffer.end(), 0);
+    }
+}
+
+/* the throughput of a TcpConnection receiving a stream of data frames over loopback
+@details with legacy set the data callback also repeats the per read buffer maintenance the connection did before
+the sliding window on a buffer of the same size,  for comparison with the current receive path.  With aligned set
+the sender has no delay set and writes one frame at a time,  as a PMU does,  so reads end on frame boundaries and
+the legacy path clears the whole buffer after every read.  Only that case shows a measurable difference,  and only
+with a large buffer,  the other cases measure the same with and without legacy so there the change is a cleanup*/
+static void BM_tcpConnectionReceive(benchmark::State &state)
+{
+    std::size_t frameSize{0U};
+    const auto stream = frameStream(static_cast<std::uint16_t>(state.range(0)), frameSize);
+    const bool legacy = (state.range(2) != 0);
+    const bool aligned = (state.range(3) != 0);
+    std::vector<char> legacyBuffer(static_cast<std::size_t>(state.range(1)));
+
+    asio::io_context context;
+    auto work = asio::make_work_guard(context);
+    std::thread runner([&context]() { context.run(); });
+
+    tcp::acceptor acceptor(context, tcp::endpoint(asio::ip::make_address("127.0.0.1"), 0));
+    auto connection = helics::tcp::TcpConnection::create(
+      context, "127.0.0.1", std::to_string(acceptor.local_endpoint().port()), static_cast<std::size_t>(state.range(1)));
+    tcp::socket sender(context);
+    acceptor.accept(sender);
+    if (aligned)
+    {
+        sender.set_option(tcp::no_delay(true));
+    }
+    connection->waitUntilConnected(std::chrono::milliseconds(4000));
+
+    std::mutex mutex;
+    std::condition_variable received;
+    std::size_t total{0U};
+    bool ended{false};
+    connection->setDataCall([&](helics::tcp::TcpConnection::pointer, const char *data, std::size_t size) {
+        const auto used = completeFrames(data, size);
+        if (legacy)
+        {
+            compactBuffer(legacyBuffer, data, size, used);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        total += used;
+        received.notify_one();
+        return used;
+    });
+    connection->setErrorCall([&](helics::tcp::TcpConnection::pointer, const std::error_code &) {
+        std::lock_guard<std::mutex> lock(mutex);
+        ended = true;
+        received.notify_one();
+        return false;
+    });
+    connection->startReceive();
+
+    std::atomic<bool> sending{true};
+    std::thread writer([&]() {
+        asio::error_code ec;
+        const std::size_t writeSize = aligned ? frameSize : stream.size();
+        while (sending.load() && !ec)
+        {
+            for (std::size_t offset = 0; offset < stream.size() && !ec; offset += writeSize)
+            {
+                asio::write(sender, asio::buffer(stream.data() + offset, writeSize), ec);
+            }
+        }
+    });
+
+    std::size_t target{0U};
+    for (auto _ : state)
+    {
+        target += bytes_per_iteration;
+        std::unique_lock<std::mutex> lock(mutex);
+        received.wait(lock, [&]() { return total >= target; });
+    }
+    // the connection keeps reading until the writer stops,  then halts on the end of the stream
+    sending = false;
+    writer.join();
+    asio::error_code ec;
+    sender.shutdown(tcp::socket::shutdown_both, ec);
+    sender.close(ec);
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        received.wait(lock, [&]() { return ended; });
+    }
+    connection->close();
+    work.reset();
+    context.stop();
+    runner.join();
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes_per_iteration));
+    state.counters["frames/s"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * bytes_per_iteration / frameSize), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_tcpConnectionReceive)
+  ->ArgNames({"phasors", "buffer", "legacy", "aligned"})
+  ->Args({1, 65536, 0, 0})
+  ->Args({1, 65536, 1, 0})
+  ->Args({64, 65536, 0, 0})
+  ->Args({64, 65536, 1, 0})
+  ->Args({1000, 65536, 0, 0})
+  ->Args({1000, 65536, 1, 0})
+  ->Args({64, 1 << 20, 0, 0})
+  ->Args({64, 1 << 20, 1, 0})
+  ->Args({64, 65536, 0, 1})
+  ->Args({64, 65536, 1, 1})
+  ->Args({64, 1 << 20, 0, 1})
+  ->Args({64, 1 << 20, 1, 1})
+  ->UseRealTime();
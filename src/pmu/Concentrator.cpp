@@ -0,0 +1,456 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "Concentrator.hpp"
+
+#include "FrameLayout.hpp"
+#include "c37118Fields.h"
+
+#include <limits>
+#include <thread>
+
+namespace pmu
+{
+/* marks an idcode without a stream in the routing table*/
+static constexpr std::uint32_t no_stream{std::numeric_limits<std::uint32_t>::max()};
+
+/* the phases of an entry,  stored in the low bits of the entry state below the time*/
+static constexpr std::uint64_t entry_writing{1U};
+static constexpr std::uint64_t entry_ready{2U};
+static constexpr std::uint64_t entry_closed{3U};
+
+/* the state of an entry for a time and phase,  any state below entryState(time, 0) is empty for that time*/
+static constexpr std::uint64_t entryState(std::int64_t time, std::uint64_t phase)
+{
+    return ((static_cast<std::uint64_t>(time) + 1U) << 2U) | phase;
+}
+
+/* the value of a free slot which may be claimed for times from minTime,  active slots hold their time*/
+static constexpr std::int64_t freeSlot(std::int64_t minTime) { return -minTime - 1; }
+
+/* a time slot of the ring,  on its own cache line since every producer of the slot updates the fill count*/
+class alignas(64) Concentrator::Slot
+{
+  public:
+    std::atomic<std::int64_t> time{freeSlot(0)};
+    std::atomic<std::size_t> filled{0U};  //!< the number of entries written or being written
+    std::atomic<std::int64_t> opened{0};  //!< the arrival of the first frame in steady clock ticks,  0 until set
+};
+
+/* the frame of one stream in one slot,  the state records the time it belongs to so a producer delayed past the
+ * release of its slot cannot write into the slot of a later time.  Entries are written by different producers so
+ * each has its own cache line*/
+class alignas(64) Concentrator::Entry
+{
+  public:
+    std::atomic<std::uint64_t> state{0U};
+    bool raw{false};  //!< the frame was pushed as bytes
+    c37118::PmuDataFrame frame;
+    std::vector<std::uint8_t> bytes;
+};
+
+/* a data frame with the storage for the measurements of a stream,  so copying a frame of the stream into it reuses
+ * the storage*/
+static void shapeFrame(c37118::PmuDataFrame &frame, const c37118::Config &config)
+{
+    frame.pmus.resize(config.pmus.size());
+    for (std::size_t ii = 0; ii < config.pmus.size(); ++ii)
+    {
+        frame.pmus[ii].phasors.resize(config.pmus[ii].phasorCount);
+        frame.pmus[ii].analog.resize(config.pmus[ii].analogCount);
+        frame.pmus[ii].digital.resize(config.pmus[ii].digitalWordCount);
+    }
+}
+
+Concentrator::Concentrator(const std::vector<c37118::Config> &streams,
+                           std::int16_t dataRate,
+                           std::chrono::nanoseconds waitWindow,
+                           std::size_t slotCount):
+    mStreamIndex(std::numeric_limits<std::uint16_t>::max() + 1U, no_stream),
+    mSlotCount(slotCount), mDataRate((dataRate == 0) ? 1 : dataRate), mWaitWindow(waitWindow)
+{
+    for (const auto &config : streams)
+    {
+        if (mStreamIndex[config.idcode] != no_stream)
+        {
+            continue;
+        }
+        mStreamIndex[config.idcode] = static_cast<std::uint32_t>(mStreams.size());
+        Stream stream;
+        stream.idcode = config.idcode;
+        stream.timeBase = (config.timeBase == 0U) ? 1U : config.timeBase;
+        mStreams.push_back(stream);
+    }
+    if (mSlotCount == 0U)
+    {
+        mSlotCount = (mDataRate > 0) ? static_cast<std::size_t>(mDataRate) : 1U;
+    }
+    mSlots = std::make_unique<Slot[]>(mSlotCount);
+    mEntries = std::make_unique<Entry[]>(mSlotCount * mStreams.size());
+    for (const auto &config : streams)
+    {
+        std::shared_ptr<const c37118::FrameLayout> layout;
+        const auto frameSize = c37118::getFrameLayout(config, layout).frameSize;
+        const auto index = mStreamIndex[config.idcode];
+        for (std::size_t slot = 0; slot < mSlotCount; ++slot)
+        {
+            auto &entry = mEntries[slot * mStreams.size() + index];
+            shapeFrame(entry.frame, config);
+            entry.bytes.reserve(frameSize);
+        }
+    }
+    mOutput.frames.resize(mStreams.size(), nullptr);
+    mOutput.rawFrames.resize(mStreams.size());
+}
+
+Concentrator::~Concentrator() = default;
+
+void Concentrator::setTime(const Entry &entry, std::uint32_t timeBase)
+{
+    mOutput.timeBase = timeBase;
+    if (entry.raw)
+    {
+        const auto fracSec = c37118::readUInt32(entry.bytes.data() + 10);
+        mOutput.soc = c37118::readUInt32(entry.bytes.data() + 6);
+        mOutput.fracSecTicks = fracSec & 0x00FFFFFFU;
+        mOutput.timeQuality = static_cast<std::uint8_t>(fracSec >> 24U);
+        return;
+    }
+    mOutput.soc = entry.frame.soc;
+    mOutput.fracSecTicks = entry.frame.fracSecTicks;
+    mOutput.timeQuality = entry.frame.timeQuality;
+}
+
+std::size_t Concentrator::streamIndex(std::uint16_t idcode) const
+{
+    const auto index = mStreamIndex[idcode];
+    return (index == no_stream) ? mStreams.size() : index;
+}
+
+std::int64_t Concentrator::timeIndex(std::uint32_t soc, std::uint32_t fracSecTicks, const Stream &stream) const
+{
+    if (mDataRate < 0)
+    {
+        return static_cast<std::int64_t>(soc) / (-mDataRate);
+    }
+    // round to the nearest frame so timestamps jittered by a tick still align
+    const std::int64_t rate = mDataRate;
+    const std::int64_t frameInSecond =
+      (static_cast<std::int64_t>(fracSecTicks) * rate + stream.timeBase / 2) / stream.timeBase;
+    return static_cast<std::int64_t>(soc) * rate + frameInSecond;
+}
+
+AlignResult Concentrator::push(const c37118::PmuDataFrame &frame, std::chrono::steady_clock::time_point arrival)
+{
+    const auto index = mStreamIndex[frame.idcode];
+    if (index == no_stream)
+    {
+        ++mUnknown;
+        return AlignResult::unknown_stream;
+    }
+    const auto time = timeIndex(frame.soc, frame.fracSecTicks, mStreams[index]);
+    Entry *entry{nullptr};
+    const auto result = claimEntry(index, time, arrival, entry);
+    if (result != AlignResult::accepted)
+    {
+        return result;
+    }
+    entry->raw = false;
+    entry->frame = frame;
+    return publishEntry(*entry, time);
+}
+
+AlignResult Concentrator::push(const c37118::FrameSpan &frame, std::chrono::steady_clock::time_point arrival)
+{
+    if (frame.size < c37118::common_frame_size + 2U ||
+        c37118::getPacketType(frame.data, frame.size) != c37118::PmuPacketType::data)
+    {
+        ++mUnknown;
+        return AlignResult::unknown_stream;
+    }
+    const auto index = mStreamIndex[c37118::readUInt16(frame.data + 4)];
+    if (index == no_stream)
+    {
+        ++mUnknown;
+        return AlignResult::unknown_stream;
+    }
+    const auto time = timeIndex(
+      c37118::readUInt32(frame.data + 6), c37118::readUInt32(frame.data + 10) & 0x00FFFFFFU, mStreams[index]);
+    Entry *entry{nullptr};
+    const auto result = claimEntry(index, time, arrival, entry);
+    if (result != AlignResult::accepted)
+    {
+        return result;
+    }
+    entry->raw = true;
+    entry->bytes.assign(frame.data, frame.data + frame.size);
+    return publishEntry(*entry, time);
+}
+
+AlignResult Concentrator::claimEntry(std::uint32_t stream,
+                                     std::int64_t time,
+                                     std::chrono::steady_clock::time_point arrival,
+                                     Entry *&entry)
+{
+    const auto next = mNextTime.load(std::memory_order_acquire);
+    if (next >= 0)
+    {
+        if (time < next)
+        {
+            ++mLate;
+            return AlignResult::late;
+        }
+        if (time >= next + static_cast<std::int64_t>(mSlotCount))
+        {
+            ++mEarly;
+            return AlignResult::early;
+        }
+    }
+    const auto slotIndex = static_cast<std::size_t>(time % static_cast<std::int64_t>(mSlotCount));
+    auto &slot = mSlots[slotIndex];
+    const auto claim = claimSlot(slot, time, arrival);
+    if (claim != AlignResult::accepted)
+    {
+        if (claim == AlignResult::late)
+        {
+            ++mLate;
+        }
+        else
+        {
+            ++mEarly;
+        }
+        return claim;
+    }
+
+    auto &claimed = mEntries[slotIndex * mStreams.size() + stream];
+    const auto empty = entryState(time, 0U);
+    auto state = claimed.state.load(std::memory_order_acquire);
+    do
+    {
+        if (state >= empty)
+        {
+            // the entry holds this stream for the time or was closed when the slot was released
+            if (state >= entryState(time, entry_closed))
+            {
+                ++mLate;
+                return AlignResult::late;
+            }
+            ++mDuplicate;
+            return AlignResult::duplicate;
+        }
+    } while (!claimed.state.compare_exchange_weak(state, entryState(time, entry_writing), std::memory_order_acq_rel));
+    entry = &claimed;
+    return AlignResult::accepted;
+}
+
+AlignResult Concentrator::publishEntry(Entry &entry, std::int64_t time)
+{
+    auto &slot = mSlots[static_cast<std::size_t>(time % static_cast<std::int64_t>(mSlotCount))];
+    // counted before the entry is published so release never resets the count under a producer
+    const auto filled = slot.filled.fetch_add(1U, std::memory_order_acq_rel) + 1U;
+    entry.state.store(entryState(time, entry_ready), std::memory_order_release);
+    ++mAccepted;
+    return (filled == mStreams.size()) ? AlignResult::completed : AlignResult::accepted;
+}
+
+AlignResult Concentrator::claimSlot(Slot &slot, std::int64_t time, std::chrono::steady_clock::time_point arrival)
+{
+    auto current = slot.time.load(std::memory_order_acquire);
+    while (current != time)
+    {
+        if (current >= 0)
+        {
+            // the slot holds another time which has not been released
+            return (current > time) ? AlignResult::late : AlignResult::early;
+        }
+        if (time < -current - 1)
+        {
+            return AlignResult::late;
+        }
+        if (slot.time.compare_exchange_weak(current, time, std::memory_order_acq_rel))
+        {
+            // 0 means not yet set so the first tick is moved forward by one
+            const auto ticks = arrival.time_since_epoch().count();
+            slot.opened.store((ticks == 0) ? 1 : ticks, std::memory_order_release);
+            break;
+        }
+    }
+    return AlignResult::accepted;
+}
+
+bool Concentrator::releasable(const Slot &slot, std::chrono::steady_clock::time_point now) const
+{
+    if (slot.filled.load(std::memory_order_acquire) == mStreams.size())
+    {
+        return true;
+    }
+    const auto opened = slot.opened.load(std::memory_order_acquire);
+    return opened != 0 &&
+      now - std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(opened)) >= mWaitWindow;
+}
+
+bool Concentrator::laterReleasable(std::chrono::steady_clock::time_point now) const
+{
+    const auto next = mNextTime.load(std::memory_order_relaxed);
+    for (std::size_t ii = 0; ii < mSlotCount; ++ii)
+    {
+        const auto time = mSlots[ii].time.load(std::memory_order_acquire);
+        if (time > next && releasable(mSlots[ii], now))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::size_t Concentrator::release(std::chrono::steady_clock::time_point now)
+{
+    auto next = mNextTime.load(std::memory_order_relaxed);
+    if (next < 0)
+    {
+        // start from the oldest time which has arrived
+        for (std::size_t ii = 0; ii < mSlotCount; ++ii)
+        {
+            const auto time = mSlots[ii].time.load(std::memory_order_acquire);
+            if (time >= 0 && (next < 0 || time < next))
+            {
+                next = time;
+            }
+        }
+        if (next < 0)
+        {
+            return 0U;
+        }
+        mNextTime.store(next, std::memory_order_release);
+    }
+    const auto slots = static_cast<std::int64_t>(mSlotCount);
+    std::size_t released{0U};
+    while (true)
+    {
+        auto &slot = mSlots[static_cast<std::size_t>(next % slots)];
+        auto time = slot.time.load(std::memory_order_acquire);
+        if (time == next)
+        {
+            if (!releasable(slot, now))
+            {
+                break;
+            }
+            deliver(next);
+            ++released;
+        }
+        else if (time >= 0 && time < next)
+        {
+            // claimed for a released time by a producer which read the next time before it was first set
+            deliver(time);
+            continue;
+        }
+        else if (time < 0)
+        {
+            // no frame has arrived for the time,  it is skipped once a later slot is ready
+            if (!laterReleasable(now))
+            {
+                break;
+            }
+            if (!slot.time.compare_exchange_strong(time, freeSlot(next + slots), std::memory_order_acq_rel))
+            {
+                continue;
+            }
+        }
+        // otherwise the slot was claimed for a later time before the next time was first set and the time is skipped
+        ++next;
+        mNextTime.store(next, std::memory_order_release);
+    }
+    return released;
+}
+
+void Concentrator::deliver(std::int64_t time)
+{
+    const auto slots = static_cast<std::int64_t>(mSlotCount);
+    const auto slotIndex = static_cast<std::size_t>(time % slots);
+    auto &slot = mSlots[slotIndex];
+    Entry *entries = &mEntries[slotIndex * mStreams.size()];
+    const bool stale = time < mNextTime.load(std::memory_order_relaxed);
+
+    // close the missing entries so no producer writes into the slot while it is read
+    mOutput.present = 0U;
+    const Entry *first{nullptr};
+    std::size_t firstStream{0U};
+    for (std::size_t ii = 0; ii < mStreams.size(); ++ii)
+    {
+        auto &entry = entries[ii];
+        auto state = entry.state.load(std::memory_order_acquire);
+        mOutput.frames[ii] = nullptr;
+        mOutput.rawFrames[ii] = c37118::FrameSpan{};
+        while (true)
+        {
+            if (state == entryState(time, entry_ready))
+            {
+                if (entry.raw)
+                {
+                    mOutput.rawFrames[ii] = c37118::FrameSpan{entry.bytes.data(), entry.bytes.size()};
+                }
+                else
+                {
+                    mOutput.frames[ii] = &entry.frame;
+                }
+                if (first == nullptr)
+                {
+                    first = &entry;
+                    firstStream = ii;
+                }
+                ++mOutput.present;
+                break;
+            }
+            if (state == entryState(time, entry_writing))
+            {
+                // a producer is copying its frame
+                std::this_thread::yield();
+                state = entry.state.load(std::memory_order_acquire);
+                continue;
+            }
+            if (entry.state.compare_exchange_weak(state, entryState(time, entry_closed), std::memory_order_acq_rel))
+            {
+                break;
+            }
+        }
+    }
+
+    if (stale)
+    {
+        mLate += mOutput.present;
+    }
+    else
+    {
+        const bool complete = (mOutput.present == mStreams.size());
+        mOutput.timeIndex = time;
+        mOutput.complete = complete;
+        if (first != nullptr)
+        {
+            setTime(*first, mStreams[firstStream].timeBase);
+        }
+        if (complete)
+        {
+            ++mComplete;
+        }
+        else
+        {
+            ++mPartial;
+        }
+        if (mOutputCall)
+        {
+            mOutputCall(mOutput);
+        }
+    }
+
+    // the entries stay closed for this time,  the next claim of the slot is for a later time
+    slot.filled.store(0U, std::memory_order_relaxed);
+    slot.opened.store(0, std::memory_order_relaxed);
+    const auto next = mNextTime.load(std::memory_order_relaxed);
+    const auto minTime = stale ? next + ((time - next) % slots + slots) % slots : time + slots;
+    slot.time.store(freeSlot(minTime), std::memory_order_release);
+}
+
+}  // namespace pmu
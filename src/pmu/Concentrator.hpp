@@ -0,0 +1,155 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+#include "FrameExtractor.hpp"
+#include "c37118.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace pmu
+{
+/** the outcome of adding a frame to a Concentrator*/
+enum class AlignResult : std::uint8_t
+{
+    accepted = 0,  //!< the frame was stored in its time slot
+    completed = 1,  //!< the frame was stored and was the last one missing from its time slot
+    late = 2,  //!< the time slot of the frame has already been released
+    early = 3,  //!< the frame is further ahead of the oldest unreleased slot than the ring can hold
+    duplicate = 4,  //!< a frame from the same stream is already stored for the time
+    unknown_stream = 5  //!< the idcode is not one of the expected streams
+};
+
+/** a set of data frames with the same timestamp released by a Concentrator*/
+class AlignedFrames
+{
+  public:
+    std::int64_t timeIndex{0};  //!< the timestamp as a count of frames at the concentrator data rate
+    std::uint32_t soc{0U};
+    std::uint32_t fracSecTicks{0U};  //!< the FRACSEC count of the first frame in the set
+    std::uint32_t timeBase{1U};  //!< the time base of the fracSecTicks count
+    std::uint8_t timeQuality{0U};  //!< the time quality of the first frame in the set
+    /** the decoded frame of each expected stream in the order they were given,  nullptr for a stream which was
+     * pushed as raw bytes or did not arrive within the wait window,  only valid during the callback*/
+    std::vector<const c37118::PmuDataFrame *> frames;
+    /** the bytes of each stream pushed as a raw data frame,  empty for a stream which was pushed decoded or did not
+     * arrive within the wait window,  only valid during the callback*/
+    std::vector<c37118::FrameSpan> rawFrames;
+    std::size_t present{0U};  //!< the number of frames in the set
+    bool complete{false};  //!< true if every stream is present
+};
+
+/** a phasor data concentrator stage aligning the data frames of many streams by timestamp
+@details frames are stored in a preallocated ring of time slots,  each with one entry for every expected stream.  A
+slot is released in time order once every stream has arrived or once the wait window has passed since its first
+frame arrived.  Frames for a slot which has been released are counted as late and discarded.  Frames may be pushed
+decoded or as the raw bytes of the data frame,  which avoids decoding frames which are passed on as they are.
+
+push is lock free and may be called from any number of threads,  it copies the frame into storage sized from the
+stream configurations so it does not allocate for frames matching them.  release must only be called from one
+thread at a time and calls the output function for each released slot.
+*/
+class Concentrator
+{
+  public:
+    /** construct a concentrator
+    @param streams the configurations of the expected streams
+    @param dataRate the frames per second to align to if positive or the seconds per frame if negative
+    @param waitWindow the time to wait for the missing streams of a slot after its first frame arrives
+    @param slotCount the number of time slots,  0 for one second of frames*/
+    Concentrator(const std::vector<c37118::Config> &streams,
+                 std::int16_t dataRate,
+                 std::chrono::nanoseconds waitWindow,
+                 std::size_t slotCount = 0U);
+    Concentrator(const Concentrator &) = delete;
+    Concentrator &operator=(const Concentrator &) = delete;
+    ~Concentrator();
+
+    /** set the function called with each released set of frames*/
+    void setOutputCall(std::function<void(const AlignedFrames &frames)> outputCall)
+    {
+        mOutputCall = std::move(outputCall);
+    }
+
+    /** add a data frame,  may be called from any thread
+    @param frame a data frame with soc and fracSecTicks set as by parseDataFrame
+    @param arrival the time the frame arrived,  which starts the wait window of a new slot*/
+    AlignResult push(const c37118::PmuDataFrame &frame,
+                     std::chrono::steady_clock::time_point arrival = std::chrono::steady_clock::now());
+    /** add the raw bytes of a data frame,  may be called from any thread
+    @details the frame is only checked for a data frame header,  the caller is expected to have checked the CRC*/
+    AlignResult push(const c37118::FrameSpan &frame,
+                     std::chrono::steady_clock::time_point arrival = std::chrono::steady_clock::now());
+    /** release the slots which are complete or whose wait window has passed,  in time order
+    @return the number of slots released*/
+    std::size_t release(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+    std::size_t streamCount() const { return mStreams.size(); }
+    std::size_t slotCount() const { return mSlotCount; }
+    /** get the index of a stream in the released sets or streamCount() if the idcode is not expected*/
+    std::size_t streamIndex(std::uint16_t idcode) const;
+
+    std::uint64_t framesAccepted() const { return mAccepted.load(); }
+    std::uint64_t lateFrames() const { return mLate.load(); }
+    std::uint64_t earlyFrames() const { return mEarly.load(); }
+    std::uint64_t duplicateFrames() const { return mDuplicate.load(); }
+    std::uint64_t unknownFrames() const { return mUnknown.load(); }
+    std::uint64_t completeSets() const { return mComplete.load(); }
+    /** get the number of sets released by the wait window with streams missing*/
+    std::uint64_t partialSets() const { return mPartial.load(); }
+
+  private:
+    class Slot;
+    class Entry;
+    class Stream
+    {
+      public:
+        std::uint16_t idcode{0U};
+        std::uint32_t timeBase{1U};
+    };
+
+    std::int64_t timeIndex(std::uint32_t soc, std::uint32_t fracSecTicks, const Stream &stream) const;
+    /* claim the entry of a stream for a time,  the entry is set when the result is accepted*/
+    AlignResult claimEntry(std::uint32_t stream,
+                           std::int64_t time,
+                           std::chrono::steady_clock::time_point arrival,
+                           Entry *&entry);
+    /* make a written entry visible to release*/
+    AlignResult publishEntry(Entry &entry, std::int64_t time);
+    /* find the slot for a time,  claiming it if it is free*/
+    AlignResult claimSlot(Slot &slot, std::int64_t time, std::chrono::steady_clock::time_point arrival);
+    bool releasable(const Slot &slot, std::chrono::steady_clock::time_point now) const;
+    /* true if a slot after the next time is ready to be released so an empty next time can be skipped*/
+    bool laterReleasable(std::chrono::steady_clock::time_point now) const;
+    void deliver(std::int64_t time);
+    /* set the time fields of the output from the first frame of a set*/
+    void setTime(const Entry &entry, std::uint32_t timeBase);
+
+    std::vector<Stream> mStreams;
+    std::vector<std::uint32_t> mStreamIndex;  //!< the stream index of each idcode or no_stream
+    std::unique_ptr<Slot[]> mSlots;
+    std::unique_ptr<Entry[]> mEntries;  //!< streamCount entries for each slot
+    std::size_t mSlotCount{0U};
+    std::int16_t mDataRate{30};
+    std::chrono::nanoseconds mWaitWindow;
+    std::function<void(const AlignedFrames &frames)> mOutputCall;
+    AlignedFrames mOutput;  //!< reused for each released set
+    /** the oldest time which has not been released,  -1 until the first slot is released*/
+    std::atomic<std::int64_t> mNextTime{-1};
+
+    std::atomic<std::uint64_t> mAccepted{0U};
+    std::atomic<std::uint64_t> mLate{0U};
+    std::atomic<std::uint64_t> mEarly{0U};
+    std::atomic<std::uint64_t> mDuplicate{0U};
+    std::atomic<std::uint64_t> mUnknown{0U};
+    std::atomic<std::uint64_t> mComplete{0U};
+    std::atomic<std::uint64_t> mPartial{0U};
+};
+}  // namespace pmu
@@ -0,0 +1,256 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "ConcentratorOutput.hpp"
+
+#include "c37118Crc.h"
+#include "c37118Fields.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace pmu
+{
+/* the bits of a quiet NaN,  the invalid value of a floating point measurement*/
+static constexpr std::uint32_t float_invalid{0x7FC00000U};
+/* the invalid value of an integer measurement*/
+static constexpr std::uint16_t integer_invalid{0x8000U};
+
+/* fill the measurements from begin to end with their invalid value*/
+static void fillInvalid(std::uint8_t *begin, const std::uint8_t *end, bool floatingPoint)
+{
+    if (floatingPoint)
+    {
+        for (; begin + 4 <= end; begin += 4)
+        {
+            c37118::writeUInt32(begin, float_invalid);
+        }
+    }
+    else
+    {
+        for (; begin + 2 <= end; begin += 2)
+        {
+            c37118::writeUInt16(begin, integer_invalid);
+        }
+    }
+}
+
+/* the size of a PMU block in a data frame*/
+static std::size_t blockSize(const c37118::PmuConfig &pmu)
+{
+    const std::size_t phasorSize = (pmu.phasorFormat == c37118::floating_point_format) ? 8U : 4U;
+    const std::size_t freqSize = (pmu.freqFormat == c37118::floating_point_format) ? 8U : 4U;
+    const std::size_t analogSize = (pmu.analogFormat == c37118::floating_point_format) ? 4U : 2U;
+    return 2U + pmu.phasorCount * phasorSize + freqSize + pmu.analogCount * analogSize +
+      pmu.digitalWordCount * 2U;
+}
+
+ConcentratorOutput::ConcentratorOutput(const std::vector<c37118::Config> &streams,
+                                       std::uint16_t idcode,
+                                       std::int16_t dataRate,
+                                       std::uint32_t timeBase,
+                                       ConcentratedFormat format)
+{
+    mConfig.idcode = idcode;
+    mConfig.dataRate = dataRate;
+    mConfig.timeBase = timeBase;
+
+    // a repeated idcode is ignored by the Concentrator so it has no blocks here either
+    std::vector<bool> seen(65536U, false);
+    std::size_t frameBytes{c37118::common_frame_size + 2U};
+    std::uint16_t maxPhasors{0U};
+    std::uint16_t maxAnalogs{0U};
+    std::uint16_t maxDigitals{0U};
+    for (const auto &config : streams)
+    {
+        if (seen[config.idcode])
+        {
+            continue;
+        }
+        seen[config.idcode] = true;
+        StreamBlocks blocks;
+        blocks.layout = (config.layout && config.layout->matches(config)) ? config.layout :
+                                                                            c37118::compileFrameLayout(config);
+        blocks.firstBlock = mConfig.pmus.size();
+        for (const auto &pmu : config.pmus)
+        {
+            auto output = pmu;
+            BlockPlan plan;
+            if (format == ConcentratedFormat::floating_point)
+            {
+                output.phasorFormat = c37118::floating_point_format;
+                output.freqFormat = c37118::floating_point_format;
+                output.analogFormat = c37118::floating_point_format;
+                plan.copy = pmu.phasorFormat == output.phasorFormat && pmu.freqFormat == output.freqFormat &&
+                  pmu.analogFormat == output.analogFormat;
+                // integer frequencies are decoded as the deviation from nominal
+                if (pmu.freqFormat != c37118::floating_point_format)
+                {
+                    plan.frequencyOffset = pmu.nominalFrequency;
+                }
+            }
+            frameBytes += blockSize(output);
+            maxPhasors = std::max(maxPhasors, output.phasorCount);
+            maxAnalogs = std::max(maxAnalogs, output.analogCount);
+            maxDigitals = std::max(maxDigitals, output.digitalWordCount);
+            blocks.blocks.push_back(plan);
+            mConfig.pmus.push_back(std::move(output));
+        }
+        mStreams.push_back(std::move(blocks));
+    }
+    if (frameBytes > c37118::max_frame_size)
+    {
+        return;
+    }
+    c37118::updateFrameLayout(mConfig);
+    mLayout = mConfig.layout;
+    mFrameSize = mLayout->frameSize;
+
+    mScratch.phasors.reserve(maxPhasors);
+    mScratch.analog.reserve(maxAnalogs);
+    mScratch.digital.reserve(maxDigitals);
+
+    // the header comes from an ordinary frame,  each block holds the invalid data values
+    mTemplate.resize(mFrameSize);
+    c37118::PmuDataFrame shape;
+    shape.idcode = idcode;
+    shape.pmus.resize(mConfig.pmus.size());
+    for (std::size_t ii = 0; ii < mConfig.pmus.size(); ++ii)
+    {
+        shape.pmus[ii].phasors.resize(mConfig.pmus[ii].phasorCount);
+        shape.pmus[ii].analog.resize(mConfig.pmus[ii].analogCount);
+        shape.pmus[ii].digital.resize(mConfig.pmus[ii].digitalWordCount);
+    }
+    c37118::generateDataFrame(mTemplate.data(), mTemplate.size(), mConfig, *mLayout, shape);
+    for (const auto &block : mLayout->pmus)
+    {
+        auto *data = mTemplate.data();
+        c37118::writeUInt16(data + block.offset, c37118::stat_data_invalid);
+        fillInvalid(data + block.phasorOffset,
+                    data + block.freqOffset,
+                    block.phasorEncoding == c37118::PhasorEncoding::float_rectangular ||
+                      block.phasorEncoding == c37118::PhasorEncoding::float_polar);
+        fillInvalid(
+          data + block.freqOffset, data + block.analogOffset, block.freqFormat == c37118::floating_point_format);
+        fillInvalid(data + block.analogOffset,
+                    data + block.digitalOffset,
+                    block.analogFormat == c37118::floating_point_format);
+        std::memset(data + block.digitalOffset, 0, block.digitalWordCount * 2U);
+    }
+}
+
+std::uint16_t ConcentratorOutput::encode(const AlignedFrames &set, std::uint8_t *data, std::size_t dataSize)
+{
+    if (mFrameSize == 0U || dataSize < mFrameSize)
+    {
+        return 0U;
+    }
+    std::memcpy(data, mTemplate.data(), c37118::common_frame_size);
+
+    std::uint32_t soc{0U};
+    std::uint64_t ticks{0U};
+    if (set.present > 0U)
+    {
+        soc = set.soc;
+        ticks = (static_cast<std::uint64_t>(set.fracSecTicks) * mConfig.timeBase + set.timeBase / 2U) / set.timeBase;
+        if (ticks >= mConfig.timeBase)
+        {
+            ticks -= mConfig.timeBase;
+            ++soc;
+        }
+    }
+    else if (mConfig.dataRate > 0)
+    {
+        soc = static_cast<std::uint32_t>(set.timeIndex / mConfig.dataRate);
+        ticks = static_cast<std::uint64_t>(set.timeIndex % mConfig.dataRate) * mConfig.timeBase / mConfig.dataRate;
+    }
+    else
+    {
+        soc = static_cast<std::uint32_t>(set.timeIndex * (-mConfig.dataRate));
+    }
+    c37118::writeUInt32(data + 6, soc);
+    c37118::writeUInt32(data + 10,
+                        (static_cast<std::uint32_t>(set.timeQuality) << 24U) |
+                          (static_cast<std::uint32_t>(ticks) & 0x00FFFFFFU));
+
+    for (std::size_t ii = 0; ii < mStreams.size(); ++ii)
+    {
+        encodeStream(set, ii, data);
+    }
+    c37118::writeUInt16(data + mFrameSize - 2, c37118::crcCCITT(data, mFrameSize - 2));
+    return mFrameSize;
+}
+
+void ConcentratorOutput::encodeStream(const AlignedFrames &set, std::size_t stream, std::uint8_t *data)
+{
+    const auto &blocks = mStreams[stream];
+    const auto &source = *blocks.layout;
+    const auto *output = mLayout->pmus.data() + blocks.firstBlock;
+    const auto count = source.pmus.size();
+
+    const auto *raw = (stream < set.rawFrames.size()) ? &set.rawFrames[stream] : nullptr;
+    if (raw != nullptr && raw->data != nullptr && raw->size == source.frameSize)
+    {
+        for (std::size_t ii = 0; ii < count; ++ii)
+        {
+            const auto &block = source.pmus[ii];
+            if (blocks.blocks[ii].copy)
+            {
+                std::memcpy(data + output[ii].offset, raw->data + block.offset, block.size);
+                ++mCopied;
+            }
+            else
+            {
+                block.decoder(raw->data, block, mScratch);
+                encodeBlock(mScratch, blocks.blocks[ii], output[ii], data);
+            }
+        }
+        return;
+    }
+
+    const auto *frame = (stream < set.frames.size()) ? set.frames[stream] : nullptr;
+    for (std::size_t ii = 0; ii < count; ++ii)
+    {
+        const auto &block = output[ii];
+        if (frame == nullptr || ii >= frame->pmus.size() || frame->pmus[ii].phasors.size() < block.phasorCount ||
+            frame->pmus[ii].analog.size() < block.analogCount ||
+            frame->pmus[ii].digital.size() < block.digitalWordCount)
+        {
+            fillMissing(block, data);
+            continue;
+        }
+        encodeBlock(frame->pmus[ii], blocks.blocks[ii], block, data);
+    }
+}
+
+void ConcentratorOutput::encodeBlock(const c37118::PmuData &pmuData,
+                                     const BlockPlan &plan,
+                                     const c37118::PmuBlockLayout &block,
+                                     std::uint8_t *data)
+{
+    if (plan.frequencyOffset != 0.0)
+    {
+        if (&pmuData != &mScratch)
+        {
+            mScratch = pmuData;
+        }
+        mScratch.freq += plan.frequencyOffset;
+        block.encoder(data, block, mScratch);
+    }
+    else
+    {
+        block.encoder(data, block, pmuData);
+    }
+    ++mEncoded;
+}
+
+void ConcentratorOutput::fillMissing(const c37118::PmuBlockLayout &block, std::uint8_t *data)
+{
+    std::memcpy(data + block.offset, mTemplate.data() + block.offset, block.size);
+    ++mMissing;
+}
+
+}  // namespace pmu
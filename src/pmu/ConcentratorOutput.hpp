@@ -0,0 +1,98 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+#include "Concentrator.hpp"
+#include "FrameLayout.hpp"
+#include "c37118.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace pmu
+{
+/** the data format of the PMU blocks of a concentrated stream*/
+enum class ConcentratedFormat : std::uint8_t
+{
+    source = 0,  //!< keep the format of each source stream so raw blocks are copied unchanged
+    floating_point = 1  //!< send the phasors,  frequency and analogs of every PMU as floating point
+};
+
+/** encodes the sets released by a Concentrator as the data frames of one concentrated C37.118 stream
+@details the configuration of the concentrated stream lists the PMUs of every source stream in the order the streams
+were given to the Concentrator.  The PMU blocks of frames pushed as raw bytes are copied into the concentrated frame
+when the source and output formats match and are decoded and encoded again only when they differ,  frames pushed
+decoded are encoded directly.  The block of a PMU missing from a set has the invalid data STAT value with NaN or
+0x8000 measurements.  Encoding does not allocate.
+*/
+class ConcentratorOutput
+{
+  public:
+    /** construct an output
+    @param streams the configurations of the source streams in the order given to the Concentrator
+    @param idcode the idcode of the concentrated stream
+    @param dataRate the data rate of the concentrated stream,  the same as the Concentrator
+    @param timeBase the time base of the concentrated stream*/
+    ConcentratorOutput(const std::vector<c37118::Config> &streams,
+                       std::uint16_t idcode,
+                       std::int16_t dataRate,
+                       std::uint32_t timeBase = c37118::default_time_base,
+                       ConcentratedFormat format = ConcentratedFormat::source);
+
+    /** get the configuration of the concentrated stream,  used to generate its configuration frames*/
+    const c37118::Config &config() const { return mConfig; }
+    /** get the size of a concentrated data frame or 0 if the PMUs do not fit in one frame*/
+    std::uint16_t frameSize() const { return mFrameSize; }
+
+    /** encode a set of aligned frames
+    @return the size of the frame or 0 if the buffer is too small or the PMUs do not fit in one frame*/
+    std::uint16_t encode(const AlignedFrames &set, std::uint8_t *data, std::size_t dataSize);
+
+    /** get the number of PMU blocks copied from raw frames*/
+    std::uint64_t copiedBlocks() const { return mCopied; }
+    /** get the number of PMU blocks encoded from decoded or converted data*/
+    std::uint64_t encodedBlocks() const { return mEncoded; }
+    /** get the number of PMU blocks filled as invalid data*/
+    std::uint64_t missingBlocks() const { return mMissing; }
+
+  private:
+    /* how a PMU block of a source stream is written into the concentrated frame*/
+    class BlockPlan
+    {
+      public:
+        bool copy{true};  //!< the source and output formats match
+        /** added to the decoded frequency,  the nominal frequency when an integer frequency deviation is sent as a
+         * floating point frequency*/
+        double frequencyOffset{0.0};
+    };
+    /* the PMU blocks of a source stream within the concentrated frame*/
+    class StreamBlocks
+    {
+      public:
+        std::shared_ptr<const c37118::FrameLayout> layout;  //!< the data frame layout of the source stream
+        std::size_t firstBlock{0U};  //!< the index of the first block in the concentrated layout
+        std::vector<BlockPlan> blocks;
+    };
+
+    void encodeStream(const AlignedFrames &set, std::size_t stream, std::uint8_t *data);
+    void encodeBlock(const c37118::PmuData &pmuData,
+                     const BlockPlan &plan,
+                     const c37118::PmuBlockLayout &block,
+                     std::uint8_t *data);
+    void fillMissing(const c37118::PmuBlockLayout &block, std::uint8_t *data);
+
+    c37118::Config mConfig;
+    std::shared_ptr<const c37118::FrameLayout> mLayout;
+    std::vector<StreamBlocks> mStreams;
+    std::vector<std::uint8_t> mTemplate;  //!< the header and the invalid data value of every block
+    c37118::PmuData mScratch;  //!< decoded data of a block being converted
+    std::uint16_t mFrameSize{0U};
+
+    std::uint64_t mCopied{0U};
+    std::uint64_t mEncoded{0U};
+    std::uint64_t mMissing{0U};
+};
+}  // namespace pmu
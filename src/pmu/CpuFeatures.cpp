@@ -0,0 +1,80 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "CpuFeatures.hpp"
+
+#if defined(HELICS_PMU_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace pmu
+{
+#if defined(HELICS_PMU_X86)
+static void cpuid(int leaf, unsigned int regs[4])
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, leaf, 0);
+    for (int ii = 0; ii < 4; ++ii)
+    {
+        regs[ii] = static_cast<unsigned int>(info[ii]);
+    }
+#else
+    __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+/* the extended control register indicating which register sets the operating system saves*/
+static unsigned long long xgetbv0()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned int eax{0U};
+    unsigned int edx{0U};
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32U) | eax;
+#endif
+}
+#endif
+
+static CpuFeatures detectFeatures()
+{
+    CpuFeatures features;
+#if defined(HELICS_PMU_X86)
+    unsigned int regs[4] = {0U, 0U, 0U, 0U};
+    cpuid(0, regs);
+    const auto maxLeaf = regs[0];
+    if (maxLeaf >= 1)
+    {
+        cpuid(1, regs);
+        features.ssse3 = (regs[2] & (1U << 9)) != 0;
+        features.sse41 = (regs[2] & (1U << 19)) != 0;
+        features.pclmul = (regs[2] & (1U << 1)) != 0;
+        const bool osxsave = (regs[2] & (1U << 27)) != 0;
+        const bool avx = (regs[2] & (1U << 28)) != 0;
+        // the xmm and ymm state must both be enabled by the OS
+        const bool avxEnabled = osxsave && avx && ((xgetbv0() & 0x6U) == 0x6U);
+        if (maxLeaf >= 7 && avxEnabled)
+        {
+            cpuid(7, regs);
+            features.avx2 = (regs[1] & (1U << 5)) != 0;
+        }
+    }
+#endif
+    return features;
+}
+
+const CpuFeatures &cpuFeatures()
+{
+    static const CpuFeatures features = detectFeatures();
+    return features;
+}
+}  // namespace pmu
@@ -0,0 +1,37 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+
+/** @file
+runtime detection of the instruction set extensions used by the accelerated codec paths
+*/
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define HELICS_PMU_X86 1
+#endif
+
+#if defined(HELICS_PMU_X86) && (defined(__GNUC__) || defined(__clang__))
+/** mark a function as compiled for a specific instruction set so it can be selected at runtime*/
+#define HELICS_PMU_TARGET(isa) __attribute__((target(isa)))
+#else
+#define HELICS_PMU_TARGET(isa)
+#endif
+
+namespace pmu
+{
+/** the set of processor features the codec can make use of*/
+class CpuFeatures
+{
+  public:
+    bool ssse3{false};
+    bool sse41{false};
+    bool pclmul{false};
+    bool avx2{false};  //!< only set if the operating system also saves the AVX registers
+};
+
+/** get the features of the processor running the program,  detected once on first use*/
+const CpuFeatures &cpuFeatures();
+}  // namespace pmu
@@ -0,0 +1,140 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "DataFrameView.hpp"
+
+#include "FrameLayout.hpp"
+#include "c37118Fields.h"
+
+namespace c37118
+{
+DataFrameView::DataFrameView(const std::uint8_t *data, size_t dataSize, const Config &config)
+{
+    attach(data, dataSize, config);
+}
+
+ParseResult DataFrameView::attach(const std::uint8_t *data, size_t dataSize, const Config &config)
+{
+    mData = nullptr;
+    mConfig = nullptr;
+    mLayout = nullptr;
+    CommonFrame frame;
+    if ((mResult = parseCommon(data, dataSize, frame)) != ParseResult::parse_complete)
+    {
+        return mResult;
+    }
+    if (frame.type != PmuPacketType::data)
+    {
+        mResult = ParseResult::incorrect_type;
+        return mResult;
+    }
+    const auto &layout = getFrameLayout(config, mTempLayout);
+    if (layout.frameSize != frame.byteCount)
+    {
+        mResult = ParseResult::config_mismatch;
+        return mResult;
+    }
+    if (frame.sourceID != config.idcode)
+    {
+        mResult = ParseResult::id_mismatch;
+    }
+    mData = data;
+    mConfig = &config;
+    mLayout = &layout;
+    return mResult;
+}
+
+std::uint16_t DataFrameView::idcode() const { return readUInt16(mData + 4); }
+
+std::uint32_t DataFrameView::soc() const { return readUInt32(mData + 6); }
+
+double DataFrameView::fracSec() const
+{
+    return static_cast<double>(fracSecTicks()) / static_cast<double>(mConfig->timeBase);
+}
+
+std::uint32_t DataFrameView::fracSecTicks() const { return readUInt32(mData + 10) & 0x00FFFFFFU; }
+
+std::uint8_t DataFrameView::timeQuality() const { return mData[10]; }
+
+std::size_t DataFrameView::pmuCount() const { return mLayout->pmus.size(); }
+
+std::uint16_t DataFrameView::phasorCount(std::size_t pmu) const { return block(pmu).phasorCount; }
+
+std::uint16_t DataFrameView::analogCount(std::size_t pmu) const { return block(pmu).analogCount; }
+
+std::uint16_t DataFrameView::digitalWordCount(std::size_t pmu) const { return block(pmu).digitalWordCount; }
+
+const PmuBlockLayout &DataFrameView::block(std::size_t pmu) const { return mLayout->pmus[pmu]; }
+
+std::uint16_t DataFrameView::stat(std::size_t pmu) const { return readUInt16(mData + block(pmu).offset); }
+
+std::complex<double> DataFrameView::phasor(std::size_t pmu, std::size_t channel) const
+{
+    const auto &blk = block(pmu);
+    switch (blk.phasorEncoding)
+    {
+    case PhasorEncoding::integer_rectangular:
+    {
+        const std::uint8_t *phasorData = mData + blk.phasorOffset + 4U * channel;
+        return {static_cast<double>(readInt16(phasorData)) * blk.phasorScale[channel],
+                static_cast<double>(readInt16(phasorData + 2)) * blk.phasorScale[channel]};
+    }
+    case PhasorEncoding::integer_polar:
+    {
+        const std::uint8_t *phasorData = mData + blk.phasorOffset + 4U * channel;
+        return std::polar<double>(static_cast<double>(readUInt16(phasorData)) * blk.phasorScale[channel],
+                                  static_cast<double>(readInt16(phasorData + 2)) * integer_angle_scale);
+    }
+    case PhasorEncoding::float_rectangular:
+    {
+        const std::uint8_t *phasorData = mData + blk.phasorOffset + 8U * channel;
+        return {readFloat(phasorData), readFloat(phasorData + 4)};
+    }
+    case PhasorEncoding::float_polar:
+    default:
+    {
+        const std::uint8_t *phasorData = mData + blk.phasorOffset + 8U * channel;
+        return std::polar<double>(readFloat(phasorData), readFloat(phasorData + 4));
+    }
+    }
+}
+
+double DataFrameView::freq(std::size_t pmu) const
+{
+    const auto &blk = block(pmu);
+    if (blk.freqFormat == floating_point_format)
+    {
+        return static_cast<double>(readFloat(mData + blk.freqOffset));
+    }
+    return static_cast<double>(readInt16(mData + blk.freqOffset)) * integer_frequency_scale;
+}
+
+double DataFrameView::rocof(std::size_t pmu) const
+{
+    const auto &blk = block(pmu);
+    if (blk.freqFormat == floating_point_format)
+    {
+        return static_cast<double>(readFloat(mData + blk.freqOffset + 4));
+    }
+    return static_cast<double>(readInt16(mData + blk.freqOffset + 2)) * integer_frequency_scale;
+}
+
+double DataFrameView::analog(std::size_t pmu, std::size_t channel) const
+{
+    const auto &blk = block(pmu);
+    if (blk.analogFormat == floating_point_format)
+    {
+        return readFloat(mData + blk.analogOffset + 4U * channel);
+    }
+    return static_cast<double>(readInt16(mData + blk.analogOffset + 2U * channel));
+}
+
+std::uint16_t DataFrameView::digital(std::size_t pmu, std::size_t word) const
+{
+    return readUInt16(mData + block(pmu).digitalOffset + 2U * word);
+}
+}  // namespace c37118
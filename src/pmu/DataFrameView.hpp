@@ -0,0 +1,74 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+#include "c37118.h"
+
+#include <complex>
+#include <memory>
+
+/** @file
+lazy access to the fields of a data frame without decoding the entire frame
+*/
+namespace c37118
+{
+class FrameLayout;
+class PmuBlockLayout;
+
+/** non-owning view of a validated data frame that decodes each field when it is accessed
+@details the view holds pointers to the frame buffer and the configuration,  both must outlive the view and
+remain unchanged while it is in use.  The values returned are identical to the corresponding fields produced by
+parseDataFrame.  The pmu and channel indices are not checked against the configuration.
+*/
+class DataFrameView
+{
+  public:
+    DataFrameView() = default;
+    /** construct a view and validate the frame,  check parseResult() for the outcome*/
+    DataFrameView(const std::uint8_t *data, size_t dataSize, const Config &config);
+
+    /** validate a frame and attach the view to it
+    @details the CRC, frame type, and size are checked against the configuration,  an id mismatch is reported
+    but the fields remain accessible as they are with parseDataFrame
+    @return the result of the validation
+    */
+    ParseResult attach(const std::uint8_t *data, size_t dataSize, const Config &config);
+
+    ParseResult parseResult() const { return mResult; }
+    /** true if the fields of the frame can be accessed*/
+    bool valid() const { return mLayout != nullptr; }
+
+    std::uint16_t idcode() const;
+    std::uint32_t soc() const;
+    /** the fraction of second in seconds*/
+    double fracSec() const;
+    /** the fraction of second as a count of 1/timeBase*/
+    std::uint32_t fracSecTicks() const;
+    std::uint8_t timeQuality() const;
+
+    std::size_t pmuCount() const;
+    std::uint16_t phasorCount(std::size_t pmu) const;
+    std::uint16_t analogCount(std::size_t pmu) const;
+    std::uint16_t digitalWordCount(std::size_t pmu) const;
+
+    std::uint16_t stat(std::size_t pmu) const;
+    std::complex<double> phasor(std::size_t pmu, std::size_t channel) const;
+    double freq(std::size_t pmu) const;
+    double rocof(std::size_t pmu) const;
+    double analog(std::size_t pmu, std::size_t channel) const;
+    std::uint16_t digital(std::size_t pmu, std::size_t word) const;
+
+  private:
+    const PmuBlockLayout &block(std::size_t pmu) const;
+
+    const std::uint8_t *mData{nullptr};
+    const Config *mConfig{nullptr};
+    const FrameLayout *mLayout{nullptr};
+    /** storage for a layout compiled when the configuration does not have a valid one*/
+    std::shared_ptr<const FrameLayout> mTempLayout;
+    ParseResult mResult{ParseResult::not_parsed};
+};
+}  // namespace c37118
@@ -0,0 +1,98 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "DatagramBatch.hpp"
+
+#include <algorithm>
+
+#ifdef __linux__
+#    include <cerrno>
+#endif
+
+namespace pmu
+{
+/* the most messages the kernel accepts in one sendmmsg call*/
+static constexpr std::size_t max_batch_size{1024U};
+
+#ifdef __linux__
+/* true if a send failed because the socket buffer is full,  EAGAIN and EWOULDBLOCK are the same value on Linux*/
+static bool wouldBlock(int error)
+{
+#    if EAGAIN != EWOULDBLOCK
+    if (error == EWOULDBLOCK)
+    {
+        return true;
+    }
+#    endif
+    return error == EAGAIN;
+}
+#endif
+
+void DatagramBatch::reserve(std::size_t count)
+{
+    mDatagrams.reserve(count);
+#ifdef __linux__
+    mMessages.reserve(count);
+    mVectors.reserve(count);
+#endif
+}
+
+std::size_t DatagramBatch::send(asio::ip::udp::socket &socket, std::uint64_t &calls)
+{
+    std::size_t sent{0U};
+#ifdef __linux__
+    mMessages.assign(mDatagrams.size(), mmsghdr{});
+    mVectors.resize(mDatagrams.size());
+    for (std::size_t ii = 0; ii < mDatagrams.size(); ++ii)
+    {
+        auto &datagram = mDatagrams[ii];
+        mVectors[ii].iov_base = const_cast<std::uint8_t *>(datagram.data);
+        mVectors[ii].iov_len = datagram.size;
+        auto &header = mMessages[ii].msg_hdr;
+        header.msg_name = datagram.destination.data();
+        header.msg_namelen = static_cast<socklen_t>(datagram.destination.size());
+        header.msg_iov = &mVectors[ii];
+        header.msg_iovlen = 1;
+    }
+    std::size_t next{0U};
+    while (next < mMessages.size())
+    {
+        const auto count = std::min(mMessages.size() - next, max_batch_size);
+        ++calls;
+        const int result = ::sendmmsg(socket.native_handle(), mMessages.data() + next, static_cast<unsigned int>(count), 0);
+        if (result > 0)
+        {
+            sent += static_cast<std::size_t>(result);
+            next += static_cast<std::size_t>(result);
+        }
+        else if (wouldBlock(errno))
+        {
+            // the socket buffer is full,  the rest of the batch is dropped rather than delaying the caller
+            break;
+        }
+        else if (errno != EINTR)
+        {
+            // the message at the front of the batch failed,  continue with the messages after it
+            ++next;
+        }
+    }
+#else
+    for (const auto &datagram : mDatagrams)
+    {
+        asio::error_code ec;
+        ++calls;
+        socket.send_to(asio::buffer(datagram.data, datagram.size), datagram.destination, 0, ec);
+        if (!ec)
+        {
+            ++sent;
+        }
+    }
+#endif
+    mDatagrams.clear();
+    return sent;
+}
+
+}  // namespace pmu
@@ -0,0 +1,61 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+#include <asio/ip/udp.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifdef __linux__
+#    include <sys/socket.h>
+#endif
+
+namespace pmu
+{
+/** a batch of UDP datagrams sent with as few system calls as the platform allows
+@details on Linux the datagrams are sent with sendmmsg,  elsewhere with one send_to per datagram.  The socket is
+expected to be non blocking,  the datagrams which do not fit in the socket buffer are dropped rather than delaying
+the caller.*/
+class DatagramBatch
+{
+  public:
+    /** add a datagram,  the bytes must remain valid until the batch is sent*/
+    void add(const std::uint8_t *data, std::size_t size, const asio::ip::udp::endpoint &destination)
+    {
+        mDatagrams.push_back({data, size, destination});
+    }
+    /** add a datagram,  the frame must remain valid until the batch is sent*/
+    void add(const std::vector<std::uint8_t> &frame, const asio::ip::udp::endpoint &destination)
+    {
+        add(frame.data(), frame.size(), destination);
+    }
+    bool empty() const { return mDatagrams.empty(); }
+    std::size_t size() const { return mDatagrams.size(); }
+    /** reserve space for a number of datagrams*/
+    void reserve(std::size_t count);
+
+    /** send and clear the batch
+    @param[in,out] calls incremented for each system call
+    @return the number of datagrams sent*/
+    std::size_t send(asio::ip::udp::socket &socket, std::uint64_t &calls);
+
+  private:
+    class Datagram
+    {
+      public:
+        const std::uint8_t *data;
+        std::size_t size;
+        asio::ip::udp::endpoint destination;
+    };
+    std::vector<Datagram> mDatagrams;
+#ifdef __linux__
+    std::vector<mmsghdr> mMessages;
+    std::vector<iovec> mVectors;
+#endif
+};
+
+}  // namespace pmu
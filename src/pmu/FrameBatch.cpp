@@ -0,0 +1,280 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "FrameBatch.hpp"
+
+#include "FrameLayout.hpp"
+
+namespace c37118
+{
+PmuColumns::PmuColumns(const allocator_type &alloc):
+    stat(alloc), phasorReal(alloc), phasorImag(alloc), freq(alloc), rocof(alloc), analog(alloc), digital(alloc)
+{
+}
+
+FrameBatch::FrameBatch(const allocator_type &alloc):
+    parseResult(alloc), soc(alloc), fracSec(alloc), fracSecTicks(alloc), timeQuality(alloc), pmus(alloc)
+{
+}
+
+void FrameBatch::resize(const FrameLayout &layout, std::size_t frames)
+{
+    frameCount = frames;
+    parseResult.resize(frames);
+    soc.resize(frames);
+    fracSec.resize(frames);
+    fracSecTicks.resize(frames);
+    timeQuality.resize(frames);
+    pmus.resize(layout.pmus.size());
+    for (std::size_t ii = 0; ii < pmus.size(); ++ii)
+    {
+        const auto &block = layout.pmus[ii];
+        auto &columns = pmus[ii];
+        columns.frameCount = frames;
+        columns.phasorCount = block.phasorCount;
+        columns.analogCount = block.analogCount;
+        columns.digitalWordCount = block.digitalWordCount;
+        columns.stat.resize(frames);
+        columns.phasorReal.resize(frames * block.phasorCount);
+        columns.phasorImag.resize(frames * block.phasorCount);
+        columns.freq.resize(frames);
+        columns.rocof.resize(frames);
+        columns.analog.resize(frames * block.analogCount);
+        columns.digital.resize(frames * block.digitalWordCount);
+    }
+}
+
+static void clearRow(FrameBatch &batch, std::size_t row)
+{
+    batch.soc[row] = 0;
+    batch.fracSec[row] = 0.0;
+    batch.fracSecTicks[row] = 0U;
+    batch.timeQuality[row] = 0;
+    for (auto &columns : batch.pmus)
+    {
+        const std::size_t stride = columns.frameCount;
+        columns.stat[row] = 0;
+        columns.freq[row] = 0.0;
+        columns.rocof[row] = 0.0;
+        for (std::size_t ii = 0; ii < columns.phasorCount; ++ii)
+        {
+            columns.phasorReal[ii * stride + row] = 0.0;
+            columns.phasorImag[ii * stride + row] = 0.0;
+        }
+        for (std::size_t ii = 0; ii < columns.analogCount; ++ii)
+        {
+            columns.analog[ii * stride + row] = 0.0;
+        }
+        for (std::size_t ii = 0; ii < columns.digitalWordCount; ++ii)
+        {
+            columns.digital[ii * stride + row] = 0;
+        }
+    }
+}
+
+static ParseResult decodeRow(const std::uint8_t *data,
+                             std::size_t dataSize,
+                             const Config &config,
+                             const FrameLayout &layout,
+                             FrameBatch &batch,
+                             std::size_t row)
+{
+    CommonFrame frame;
+    auto result = parseCommon(data, dataSize, frame);
+    if (result == ParseResult::parse_complete)
+    {
+        if (frame.type != PmuPacketType::data)
+        {
+            result = ParseResult::incorrect_type;
+        }
+        else if (frame.byteCount != layout.frameSize)
+        {
+            result = ParseResult::config_mismatch;
+        }
+    }
+    if (result != ParseResult::parse_complete)
+    {
+        clearRow(batch, row);
+        return result;
+    }
+    if (frame.sourceID != config.idcode)
+    {
+        result = ParseResult::id_mismatch;
+    }
+    batch.soc[row] = frame.soc;
+    batch.timeQuality[row] = static_cast<std::uint8_t>(frame.fracSec >> 24U);
+    batch.fracSecTicks[row] = frame.fracSec & 0x00FFFFFFU;
+    batch.fracSec[row] = static_cast<double>(batch.fracSecTicks[row]) / static_cast<double>(config.timeBase);
+    for (std::size_t ii = 0; ii < layout.pmus.size(); ++ii)
+    {
+        layout.pmus[ii].columnDecoder(data, layout.pmus[ii], batch.pmus[ii], row);
+    }
+    return result;
+}
+
+std::size_t parseDataFrames(const std::uint8_t *const *frames,
+                            const std::size_t *frameSizes,
+                            std::size_t frameCount,
+                            const Config &config,
+                            FrameBatch &batch)
+{
+    const auto &layout = getFrameLayout(config);
+    batch.resize(layout, frameCount);
+    batch.timeBase = config.timeBase;
+    std::size_t decoded{0U};
+    for (std::size_t ii = 0; ii < frameCount; ++ii)
+    {
+        batch.parseResult[ii] = decodeRow(frames[ii], frameSizes[ii], config, layout, batch, ii);
+        if (batch.parseResult[ii] == ParseResult::parse_complete)
+        {
+            ++decoded;
+        }
+    }
+    return decoded;
+}
+
+std::size_t parseDataFrames(const std::uint8_t *data, std::size_t dataSize, const Config &config, FrameBatch &batch)
+{
+    // count the frames first so the columns can be sized once
+    std::size_t frameCount{0U};
+    std::size_t offset{0U};
+    while (offset < dataSize)
+    {
+        auto size = getPacketSize(data + offset, dataSize - offset);
+        if (size < min_packet_size || size > dataSize - offset)
+        {
+            break;
+        }
+        offset += size;
+        ++frameCount;
+    }
+
+    const auto &layout = getFrameLayout(config);
+    batch.resize(layout, frameCount);
+    batch.timeBase = config.timeBase;
+    std::size_t decoded{0U};
+    offset = 0U;
+    for (std::size_t ii = 0; ii < frameCount; ++ii)
+    {
+        auto size = getPacketSize(data + offset, dataSize - offset);
+        batch.parseResult[ii] = decodeRow(data + offset, size, config, layout, batch, ii);
+        if (batch.parseResult[ii] == ParseResult::parse_complete)
+        {
+            ++decoded;
+        }
+        offset += size;
+    }
+    return decoded;
+}
+
+std::size_t generateDataFrames(const PmuDataFrame *frames,
+                               std::size_t frameCount,
+                               const Config &config,
+                               std::vector<std::uint8_t> &buffer,
+                               std::vector<std::size_t> &offsets)
+{
+    const auto &layout = getFrameLayout(config);
+    // every frame of a configuration has the same size so the buffer is sized once
+    buffer.resize(frameCount * layout.frameSize);
+    offsets.reserve(frameCount + 1U);
+    offsets.resize(1);
+    offsets[0] = 0U;
+    std::size_t offset{0U};
+    for (std::size_t ii = 0; ii < frameCount; ++ii)
+    {
+        auto size = generateDataFrame(buffer.data() + offset, buffer.size() - offset, config, layout, frames[ii]);
+        if (size == 0U)
+        {
+            break;
+        }
+        offset += size;
+        offsets.push_back(offset);
+    }
+    buffer.resize(offset);
+    return offsets.size() - 1U;
+}
+
+/* copy a row of a batch into a frame,  the storage of frame is reused between rows*/
+static void loadRow(const FrameBatch &batch, std::size_t row, PmuDataFrame &frame)
+{
+    frame.soc = batch.soc[row];
+    frame.fracSec = batch.fracSec[row];
+    frame.fracSecTicks = batch.fracSecTicks[row];
+    frame.tickTimeBase = batch.timeBase;
+    frame.exactTime = true;
+    frame.timeQuality = batch.timeQuality[row];
+    frame.pmus.resize(batch.pmus.size());
+    for (std::size_t ii = 0; ii < batch.pmus.size(); ++ii)
+    {
+        const auto &columns = batch.pmus[ii];
+        auto &pmu = frame.pmus[ii];
+        pmu.stat = columns.stat[row];
+        pmu.freq = columns.freq[row];
+        pmu.rocof = columns.rocof[row];
+        pmu.phasors.resize(columns.phasorCount);
+        for (std::size_t jj = 0; jj < columns.phasorCount; ++jj)
+        {
+            pmu.phasors[jj] = std::complex<double>(columns.real(jj)[row], columns.imag(jj)[row]);
+        }
+        pmu.analog.resize(columns.analogCount);
+        for (std::size_t jj = 0; jj < columns.analogCount; ++jj)
+        {
+            pmu.analog[jj] = columns.analogChannel(jj)[row];
+        }
+        pmu.digital.resize(columns.digitalWordCount);
+        for (std::size_t jj = 0; jj < columns.digitalWordCount; ++jj)
+        {
+            pmu.digital[jj] = columns.digitalWord(jj)[row];
+        }
+    }
+}
+
+std::size_t generateDataFrames(const FrameBatch &batch,
+                               const Config &config,
+                               std::vector<std::uint8_t> &buffer,
+                               std::vector<std::size_t> &offsets)
+{
+    const auto &layout = getFrameLayout(config);
+    offsets.reserve(batch.frameCount + 1U);
+    offsets.resize(1);
+    offsets[0] = 0U;
+    buffer.clear();
+    if (batch.pmus.size() != layout.pmus.size())
+    {
+        return 0U;
+    }
+    for (std::size_t ii = 0; ii < layout.pmus.size(); ++ii)
+    {
+        const auto &columns = batch.pmus[ii];
+        const auto &block = layout.pmus[ii];
+        if (columns.phasorCount != block.phasorCount || columns.analogCount != block.analogCount ||
+            columns.digitalWordCount != block.digitalWordCount)
+        {
+            return 0U;
+        }
+    }
+    buffer.resize(batch.frameCount * layout.frameSize);
+    std::size_t offset{0U};
+    PmuDataFrame frame;
+    for (std::size_t ii = 0; ii < batch.frameCount; ++ii)
+    {
+        if (batch.parseResult[ii] != ParseResult::parse_complete)
+        {
+            continue;
+        }
+        loadRow(batch, ii, frame);
+        auto size = generateDataFrame(buffer.data() + offset, buffer.size() - offset, config, layout, frame);
+        if (size == 0U)
+        {
+            break;
+        }
+        offset += size;
+        offsets.push_back(offset);
+    }
+    buffer.resize(offset);
+    return offsets.size() - 1U;
+}
+}  // namespace c37118
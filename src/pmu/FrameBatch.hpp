@@ -0,0 +1,136 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+#include "c37118.h"
+
+#include <vector>
+
+/** @file
+columnar (structure of arrays) decoding of batches of data frames and encoding of batches of frames into a single
+buffer
+*/
+namespace c37118
+{
+class FrameLayout;
+
+/** decoded values of a single PMU across all the frames of a batch
+@details the values of each channel are contiguous,  channel ch of frame ii is located at index
+ch*frameCount+ii of the corresponding column*/
+class PmuColumns
+{
+  public:
+    using allocator_type = FrameAllocator;
+
+    PmuColumns() = default;
+    explicit PmuColumns(const allocator_type &alloc);
+    PmuColumns(const PmuColumns &other) = default;
+    PmuColumns(PmuColumns &&other) = default;
+    PmuColumns(const PmuColumns &other, const allocator_type &alloc): PmuColumns(alloc) { *this = other; }
+    PmuColumns(PmuColumns &&other, const allocator_type &alloc): PmuColumns(alloc) { *this = std::move(other); }
+    PmuColumns &operator=(const PmuColumns &other) = default;
+    PmuColumns &operator=(PmuColumns &&other) = default;
+    allocator_type get_allocator() const { return stat.get_allocator(); }
+
+    std::size_t frameCount{0U};
+    std::uint16_t phasorCount{0U};
+    std::uint16_t analogCount{0U};
+    std::uint16_t digitalWordCount{0U};
+    std::pmr::vector<std::uint16_t> stat;  //!< [frame]
+    std::pmr::vector<double> phasorReal;  //!< [phasor][frame] real part of the phasors
+    std::pmr::vector<double> phasorImag;  //!< [phasor][frame] imaginary part of the phasors
+    std::pmr::vector<double> freq;  //!< [frame]
+    std::pmr::vector<double> rocof;  //!< [frame]
+    std::pmr::vector<double> analog;  //!< [analog][frame]
+    std::pmr::vector<std::uint16_t> digital;  //!< [digital word][frame]
+
+    const double *real(std::size_t phasor) const { return phasorReal.data() + phasor * frameCount; }
+    const double *imag(std::size_t phasor) const { return phasorImag.data() + phasor * frameCount; }
+    const double *analogChannel(std::size_t channel) const { return analog.data() + channel * frameCount; }
+    const std::uint16_t *digitalWord(std::size_t word) const { return digital.data() + word * frameCount; }
+};
+
+/** decoded contents of a set of data frames for a single configuration*/
+class FrameBatch
+{
+  public:
+    using allocator_type = FrameAllocator;
+
+    FrameBatch() = default;
+    explicit FrameBatch(const allocator_type &alloc);
+    FrameBatch(const FrameBatch &other) = default;
+    FrameBatch(FrameBatch &&other) = default;
+    FrameBatch(const FrameBatch &other, const allocator_type &alloc): FrameBatch(alloc) { *this = other; }
+    FrameBatch(FrameBatch &&other, const allocator_type &alloc): FrameBatch(alloc) { *this = std::move(other); }
+    FrameBatch &operator=(const FrameBatch &other) = default;
+    FrameBatch &operator=(FrameBatch &&other) = default;
+    allocator_type get_allocator() const { return soc.get_allocator(); }
+
+    std::size_t frameCount{0U};
+    std::pmr::vector<ParseResult> parseResult;  //!< [frame] result of decoding each frame
+    std::pmr::vector<std::uint32_t> soc;  //!< [frame]
+    std::pmr::vector<double> fracSec;  //!< [frame] fracSecTicks/timeBase,  not used when encoding
+    std::pmr::vector<std::uint32_t> fracSecTicks;  //!< [frame] the FRACSEC count in units of 1/timeBase
+    std::uint32_t timeBase{default_time_base};  //!< the time base of the configuration the frames were decoded with
+    std::pmr::vector<std::uint8_t> timeQuality;  //!< [frame]
+    std::pmr::vector<PmuColumns> pmus;
+
+    /** size all the columns for a number of frames of a particular layout
+    @details existing storage is reused so a batch that is decoded repeatedly does not allocate after the first
+    use*/
+    void resize(const FrameLayout &layout, std::size_t frames);
+};
+
+/** decode a set of data frames into columns
+@details every frame produces a row in the batch,  the parseResult column records the outcome for each frame and
+the values of frames that failed are set to 0
+@param frames array of pointers to the start of each frame
+@param frameSizes the size of the buffer for each frame
+@param frameCount the number of frames
+@param config the configuration describing the frames
+@param batch the batch to store the results in
+@return the number of frames decoded without error
+*/
+std::size_t parseDataFrames(const std::uint8_t *const *frames,
+                            const std::size_t *frameSizes,
+                            std::size_t frameCount,
+                            const Config &config,
+                            FrameBatch &batch);
+
+/** decode a buffer containing a sequence of concatenated data frames into columns
+@details frames are located using the size field of each frame,  decoding stops at the first incomplete or
+invalid frame header
+@return the number of frames decoded without error
+*/
+std::size_t parseDataFrames(const std::uint8_t *data, std::size_t dataSize, const Config &config, FrameBatch &batch);
+
+/** encode a set of data frames back to back into a single buffer
+@details the frames can be sent with a single gather write or appended to a file in one operation.  The storage
+of buffer and offsets is reused so encoding batches of the same size repeatedly does not allocate
+@param frames the frames to encode
+@param frameCount the number of frames
+@param config the configuration describing the frames
+@param buffer storage for the encoded frames,  resized to the total size of the frames
+@param offsets set to the byte offset of each frame within buffer followed by the total size,  so frame ii
+occupies [offsets[ii], offsets[ii+1])
+@return the number of frames encoded,  encoding stops at the first frame which does not match the configuration
+*/
+std::size_t generateDataFrames(const PmuDataFrame *frames,
+                               std::size_t frameCount,
+                               const Config &config,
+                               std::vector<std::uint8_t> &buffer,
+                               std::vector<std::size_t> &offsets);
+
+/** encode the rows of a columnar batch back to back into a single buffer
+@details rows whose parseResult is not parse_complete are skipped,  the time of each row is encoded from
+fracSecTicks and timeBase
+@return the number of frames encoded,  0 if the columns of the batch do not match the configuration
+*/
+std::size_t generateDataFrames(const FrameBatch &batch,
+                               const Config &config,
+                               std::vector<std::uint8_t> &buffer,
+                               std::vector<std::size_t> &offsets);
+}  // namespace c37118
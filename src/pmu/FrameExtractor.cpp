@@ -0,0 +1,150 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "FrameExtractor.hpp"
+
+#include "c37118Crc.h"
+#include "c37118Fields.h"
+#include "c37118Kernels.h"
+
+#include <algorithm>
+
+namespace c37118
+{
+/* the number of bytes getPacketSize requires to read a frame header*/
+static constexpr std::size_t header_scan_size{16U};
+/* the largest frame type code defined by the standard (configuration frame 3)*/
+static constexpr std::uint8_t max_frame_type{5U};
+
+void FrameExtractor::push(const std::uint8_t *data, std::size_t size)
+{
+    // frames of the previous chunk which were not retrieved must be kept before the new chunk
+    retainChunk();
+    mChunk = data;
+    mChunkSize = size;
+}
+
+bool FrameExtractor::next(FrameSpan &frame)
+{
+    while (true)
+    {
+        const bool retained = mStart < mBuffer.size();
+        const std::uint8_t *data = retained ? mBuffer.data() + mStart : mChunk;
+        const std::size_t available = retained ? mBuffer.size() - mStart : mChunkSize;
+        if (available == 0U)
+        {
+            retainChunk();
+            return false;
+        }
+        std::size_t bytes{0U};
+        switch (scan(data, available, bytes))
+        {
+        case ScanResult::frame:
+            frame.data = data;
+            frame.size = bytes;
+            consume(retained, bytes);
+            ++mFrames;
+            return true;
+        case ScanResult::skip:
+            mDropped += bytes;
+            consume(retained, bytes);
+            break;
+        case ScanResult::need_data:
+            if (!retained || mChunkSize == 0U)
+            {
+                // the caller may reuse the chunk once next returns false so the partial frame is copied now
+                retainChunk();
+                return false;
+            }
+            {
+                // complete the retained frame from the current chunk,  the rest of the chunk is not copied
+                const std::size_t extra = std::min(bytes - available, mChunkSize);
+                mBuffer.insert(mBuffer.end(), mChunk, mChunk + extra);
+                mChunk += extra;
+                mChunkSize -= extra;
+            }
+            break;
+        }
+    }
+}
+
+FrameExtractor::ScanResult FrameExtractor::scan(const std::uint8_t *data, std::size_t available, std::size_t &bytes)
+{
+    if (data[0] != sync_lead)
+    {
+        bytes = findByte(data, available, sync_lead);
+        return ScanResult::skip;
+    }
+    if (available < header_scan_size)
+    {
+        bytes = header_scan_size;
+        return ScanResult::need_data;
+    }
+    const std::uint8_t frameType = (data[1] & typeMask) >> 4U;
+    const std::uint16_t size = getPacketSize(data, available);
+    if (size < min_packet_size || frameType > max_frame_type || (data[1] & versionMask) == 0U)
+    {
+        bytes = 1U;
+        return ScanResult::skip;
+    }
+    if (available < size)
+    {
+        bytes = size;
+        return ScanResult::need_data;
+    }
+    if (mCheckCrc && crcCCITT(data, size - 2U) != readUInt16(data + size - 2U))
+    {
+        ++mCrcFailures;
+        bytes = 1U;
+        return ScanResult::skip;
+    }
+    bytes = size;
+    return ScanResult::frame;
+}
+
+void FrameExtractor::consume(bool retained, std::size_t bytes)
+{
+    if (retained)
+    {
+        // the retained bytes are released once the extractor runs out of frames
+        mStart += bytes;
+    }
+    else
+    {
+        mChunk += bytes;
+        mChunkSize -= bytes;
+    }
+}
+
+void FrameExtractor::retainChunk()
+{
+    if (mStart > 0U)
+    {
+        mBuffer.erase(mBuffer.begin(), mBuffer.begin() + static_cast<std::ptrdiff_t>(mStart));
+        mStart = 0U;
+    }
+    mBuffer.insert(mBuffer.end(), mChunk, mChunk + mChunkSize);
+    mChunk = nullptr;
+    mChunkSize = 0U;
+}
+
+void FrameExtractor::flush()
+{
+    mDropped += pending();
+    mBuffer.clear();
+    mStart = 0U;
+    mChunk = nullptr;
+    mChunkSize = 0U;
+}
+
+void FrameExtractor::reset()
+{
+    flush();
+    mFrames = 0U;
+    mDropped = 0U;
+    mCrcFailures = 0U;
+}
+}  // namespace c37118
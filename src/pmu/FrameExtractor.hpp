@@ -0,0 +1,85 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+#include "c37118.h"
+
+#include <cstddef>
+#include <vector>
+
+/** @file
+incremental extraction of complete frames from a stream of bytes
+*/
+namespace c37118
+{
+/** a contiguous range of bytes holding a single frame*/
+class FrameSpan
+{
+  public:
+    const std::uint8_t *data{nullptr};
+    std::size_t size{0U};
+};
+
+/** split arbitrary chunks of a byte stream into complete C37.118 frames
+@details chunks are supplied with push and complete frames are retrieved with next.  Frames are located with the
+size field of the frame header,  if the stream is corrupt the extractor discards bytes until the next sync byte and
+continues from there.  The same object handles TCP streams,  where frames may be split across reads,  and UDP
+datagrams,  which may contain several frames;  call flush at the end of each datagram to discard any incomplete
+frame.
+
+Frames which are entirely contained in a pushed chunk are returned without copying,  only the bytes of frames split
+across chunks are copied.  A returned span is valid until the next call to any of the non-const methods and a
+pushed chunk must remain valid until next returns false,  at which point any partial frame has been copied.
+*/
+class FrameExtractor
+{
+  public:
+    /** add a chunk of the stream,  any frames of the previous chunk not retrieved with next remain available*/
+    void push(const std::uint8_t *data, std::size_t size);
+    /** get the next complete frame
+    @return true if a frame was found,  false if more data is needed*/
+    bool next(FrameSpan &frame);
+    /** discard any incomplete frame,  the discarded bytes are counted as dropped*/
+    void flush();
+    /** discard all buffered data and reset the counters*/
+    void reset();
+
+    /** enable or disable checking the CRC of each frame,  frames with invalid CRCs are dropped and the stream is
+     * resynchronized from the following sync byte*/
+    void setCrcCheck(bool check) { mCheckCrc = check; }
+
+    /** the number of bytes buffered or not yet scanned*/
+    std::size_t pending() const { return mBuffer.size() - mStart + mChunkSize; }
+    std::size_t frameCount() const { return mFrames; }
+    /** the number of bytes skipped while searching for the start of a frame*/
+    std::size_t droppedBytes() const { return mDropped; }
+    std::size_t crcFailures() const { return mCrcFailures; }
+
+  private:
+    enum class ScanResult
+    {
+        frame,
+        skip,
+        need_data
+    };
+    /** examine the bytes at the front of the stream
+    @param[out] bytes the size of the frame for frame,  the number of bytes to discard for skip,  or the number of
+    bytes required for need_data*/
+    ScanResult scan(const std::uint8_t *data, std::size_t available, std::size_t &bytes);
+    void consume(bool retained, std::size_t bytes);
+    /** copy the unscanned part of the current chunk behind the retained bytes and release the chunk*/
+    void retainChunk();
+
+    std::vector<std::uint8_t> mBuffer;  //!< bytes retained from earlier chunks,  scanned before the current chunk
+    std::size_t mStart{0U};  //!< the first unscanned byte of mBuffer
+    const std::uint8_t *mChunk{nullptr};  //!< the unscanned part of the last chunk
+    std::size_t mChunkSize{0U};
+    std::size_t mFrames{0U};
+    std::size_t mDropped{0U};
+    std::size_t mCrcFailures{0U};
+    bool mCheckCrc{true};
+};
+}  // namespace c37118
@@ -0,0 +1,125 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "FrameLayout.hpp"
+
+#include <algorithm>
+
+namespace c37118
+{
+static PhasorEncoding getPhasorEncoding(const PmuConfig &pmu)
+{
+    if (pmu.phasorFormat == integer_format)
+    {
+        return (pmu.phasorCoordinates == rectangular_phasor) ? PhasorEncoding::integer_rectangular :
+                                                               PhasorEncoding::integer_polar;
+    }
+    return (pmu.phasorCoordinates == rectangular_phasor) ? PhasorEncoding::float_rectangular :
+                                                           PhasorEncoding::float_polar;
+}
+
+static std::uint16_t compileBlock(const PmuConfig &pmu, std::uint16_t offset, PmuBlockLayout &block)
+{
+    block.offset = offset;
+    block.phasorCount = pmu.phasorCount;
+    block.analogCount = pmu.analogCount;
+    block.digitalWordCount = pmu.digitalWordCount;
+    block.phasorEncoding = getPhasorEncoding(pmu);
+    block.freqFormat = pmu.freqFormat;
+    block.analogFormat = pmu.analogFormat;
+    assignPmuCodec(block);
+
+    const std::uint16_t phasorSize = (pmu.phasorFormat == integer_format) ? 4U : 8U;
+    const std::uint16_t freqSize = (pmu.freqFormat == integer_format) ? 4U : 8U;
+    const std::uint16_t analogSize = (pmu.analogFormat == integer_format) ? 2U : 4U;
+
+    block.phasorOffset = offset + 2U;
+    block.freqOffset = block.phasorOffset + phasorSize * pmu.phasorCount;
+    block.analogOffset = block.freqOffset + freqSize;
+    block.digitalOffset = block.analogOffset + analogSize * pmu.analogCount;
+    block.size = block.digitalOffset + 2U * pmu.digitalWordCount - offset;
+
+    block.phasorConversion.assign(pmu.phasorCount, 0U);
+    std::copy_n(pmu.phasorConversion.begin(),
+                std::min<std::size_t>(pmu.phasorConversion.size(), pmu.phasorCount),
+                block.phasorConversion.begin());
+    block.phasorScale.resize(pmu.phasorCount);
+    block.phasorInverseScale.resize(pmu.phasorCount);
+    for (std::size_t ii = 0; ii < pmu.phasorCount; ++ii)
+    {
+        const auto conversion = static_cast<double>(block.phasorConversion[ii]);
+        block.phasorScale[ii] = conversion * integer_phasor_scale;
+        block.phasorInverseScale[ii] = (conversion != 0.0) ? 1.0 / block.phasorScale[ii] : 0.0;
+    }
+    return block.size;
+}
+
+bool FrameLayout::matches(const Config &config) const
+{
+    if (pmus.size() != config.pmus.size())
+    {
+        return false;
+    }
+    for (std::size_t ii = 0; ii < pmus.size(); ++ii)
+    {
+        const auto &block = pmus[ii];
+        const auto &pmu = config.pmus[ii];
+        if (block.phasorCount != pmu.phasorCount || block.analogCount != pmu.analogCount ||
+            block.digitalWordCount != pmu.digitalWordCount || block.phasorEncoding != getPhasorEncoding(pmu) ||
+            block.freqFormat != pmu.freqFormat || block.analogFormat != pmu.analogFormat)
+        {
+            return false;
+        }
+        // the raw conversion words are compared rather than the scale factors computed from them
+        const auto stored = std::min<std::size_t>(pmu.phasorConversion.size(), block.phasorCount);
+        const auto words = block.phasorConversion.begin();
+        if (!std::equal(words, words + stored, pmu.phasorConversion.begin()) ||
+            std::any_of(words + stored, block.phasorConversion.end(), [](std::uint32_t word) {
+                return word != 0U;
+            }))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::shared_ptr<const FrameLayout> compileFrameLayout(const Config &config)
+{
+    auto layout = std::make_shared<FrameLayout>();
+    layout->pmus.resize(config.pmus.size());
+    std::uint16_t offset{common_frame_size};
+    for (std::size_t ii = 0; ii < config.pmus.size(); ++ii)
+    {
+        offset += compileBlock(config.pmus[ii], offset, layout->pmus[ii]);
+    }
+    // for the CRC
+    layout->frameSize = offset + 2U;
+    return layout;
+}
+
+void updateFrameLayout(Config &config) { config.layout = compileFrameLayout(config); }
+
+const FrameLayout &getFrameLayout(const Config &config, std::shared_ptr<const FrameLayout> &storage)
+{
+    if (config.layout && config.layout->matches(config))
+    {
+        return *config.layout;
+    }
+    if (!storage || !storage->matches(config))
+    {
+        storage = compileFrameLayout(config);
+    }
+    return *storage;
+}
+
+const FrameLayout &getFrameLayout(const Config &config)
+{
+    // one layout per thread,  reused for as long as the configurations without a layout have the same structure
+    thread_local std::shared_ptr<const FrameLayout> storage;
+    return getFrameLayout(config, storage);
+}
+}  // namespace c37118
@@ -0,0 +1,115 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+#include "c37118.h"
+
+#include <memory>
+#include <vector>
+
+/** @file
+precompiled description of the data frames produced by a configuration
+*/
+namespace c37118
+{
+/** the combination of phasor format and coordinate system used by a PMU block*/
+enum class PhasorEncoding : std::uint8_t
+{
+    integer_rectangular = 0,
+    integer_polar = 1,
+    float_rectangular = 2,
+    float_polar = 3
+};
+
+class PmuBlockLayout;
+class PmuColumns;
+
+/** decode the data of a single PMU from a data frame*/
+template <class Value>
+using BasicPmuDecoder = void (*)(const std::uint8_t *data, const PmuBlockLayout &block, BasicPmuData<Value> &pmuData);
+using PmuDecoder = BasicPmuDecoder<double>;
+/** decode the data of a single PMU from a data frame into float32 storage*/
+using CompactPmuDecoder = BasicPmuDecoder<float>;
+/** decode the data of a single PMU from a data frame into a row of the columns of a batch*/
+using ColumnPmuDecoder =
+  void (*)(const std::uint8_t *data, const PmuBlockLayout &block, PmuColumns &columns, std::size_t row);
+/** encode the data of a single PMU into a data frame*/
+using PmuEncoder = void (*)(std::uint8_t *data, const PmuBlockLayout &block, const PmuData &pmuData);
+
+/** location and conversion information for the data of a single PMU within a data frame*/
+class PmuBlockLayout
+{
+  public:
+    std::uint16_t offset{0U};  //!< byte offset of the STAT word from the start of the frame
+    std::uint16_t phasorOffset{0U};  //!< byte offset of the first phasor
+    std::uint16_t freqOffset{0U};  //!< byte offset of the frequency
+    std::uint16_t analogOffset{0U};  //!< byte offset of the first analog value
+    std::uint16_t digitalOffset{0U};  //!< byte offset of the first digital word
+    std::uint16_t size{0U};  //!< total number of bytes in the block
+    std::uint16_t phasorCount{0U};
+    std::uint16_t analogCount{0U};
+    std::uint16_t digitalWordCount{0U};
+    PhasorEncoding phasorEncoding{PhasorEncoding::float_rectangular};
+    std::uint8_t freqFormat{floating_point_format};
+    std::uint8_t analogFormat{floating_point_format};
+    /** the phasor conversion words the scale factors were computed from,  0 for missing words*/
+    std::vector<std::uint32_t> phasorConversion;
+    /** integer phasor scale factors (phasorConversion*1e-5) */
+    std::vector<double> phasorScale;
+    /** inverse of the phasor scale factors used for encoding*/
+    std::vector<double> phasorInverseScale;
+    /** codec specialized for the phasor, frequency, and analog formats of the block*/
+    PmuDecoder decoder{nullptr};
+    PmuEncoder encoder{nullptr};
+    CompactPmuDecoder compactDecoder{nullptr};
+    ColumnPmuDecoder columnDecoder{nullptr};
+};
+
+/** byte offsets, field kinds, and scale factors for all the PMU blocks in a data frame*/
+class FrameLayout
+{
+  public:
+    std::uint16_t frameSize{0U};  //!< total size of a data frame including the CRC
+    std::vector<PmuBlockLayout> pmus;
+
+    /** check if the layout still matches a configuration
+    @details the counts,  formats,  and phasor conversion words are checked so a layout is never used with
+    conversion factors it was not compiled for*/
+    bool matches(const Config &config) const;
+};
+
+/** select the specialized codec functions matching the formats of a block*/
+void assignPmuCodec(PmuBlockLayout &block);
+
+/** generate the data frame layout of a configuration*/
+std::shared_ptr<const FrameLayout> compileFrameLayout(const Config &config);
+
+/** compile and store the data frame layout in the layout field of a configuration*/
+void updateFrameLayout(Config &config);
+
+/** get the layout of a configuration,  compiling one into storage if the configuration does not have a valid layout
+@details a layout already in storage is reused if it matches the configuration*/
+const FrameLayout &getFrameLayout(const Config &config, std::shared_ptr<const FrameLayout> &storage);
+
+/** get the layout of a configuration,  compiling one into storage owned by the calling thread if the configuration
+does not have a valid layout
+@details configurations built by hand should be given a layout with updateFrameLayout,  otherwise the layout is
+compiled again,  and allocates,  whenever the calling thread alternates between configurations of different structure.
+The reference is valid until the next call on the same thread*/
+const FrameLayout &getFrameLayout(const Config &config);
+
+/** generate a data frame using a layout already obtained for the configuration
+@details used when encoding many frames to avoid looking up the layout for each frame*/
+std::uint16_t generateDataFrame(std::uint8_t *data,
+                                size_t dataSize,
+                                const Config &config,
+                                const FrameLayout &layout,
+                                const PmuDataFrame &frame);
+
+static constexpr double integer_phasor_scale{1e-5};
+static constexpr double integer_angle_scale{1e-4};
+static constexpr double integer_frequency_scale{1e-3};
+}  // namespace c37118
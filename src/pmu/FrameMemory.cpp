@@ -0,0 +1,24 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "FrameMemory.hpp"
+
+namespace c37118
+{
+FrameArena::FrameArena(std::size_t initialSize, std::pmr::memory_resource *upstream):
+    mInitial(std::make_unique<std::byte[]>(initialSize)), mResource(mInitial.get(), initialSize, upstream)
+{
+}
+
+static std::pmr::pool_options framePoolOptions()
+{
+    std::pmr::pool_options options;
+    options.largest_required_pool_block = frame_pool_largest_block;
+    return options;
+}
+
+FramePool::FramePool(std::pmr::memory_resource *upstream): mResource(framePoolOptions(), upstream) {}
+}  // namespace c37118
@@ -0,0 +1,64 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+#include "c37118.h"
+
+#include <memory>
+#include <memory_resource>
+
+/** @file
+memory resources for allocating configurations and data frames in bulk
+*/
+namespace c37118
+{
+static constexpr std::size_t default_arena_size{64U * 1024U};
+/** the largest block served from the pools of a FramePool,  enough for 256 phasors*/
+static constexpr std::size_t frame_pool_largest_block{4096U};
+
+/** a monotonic memory resource for a batch of frames
+@details allocations are taken sequentially from a block that grows as needed and deallocation does nothing.  All
+the memory is reclaimed at once by release,  the initial block is kept so a stream of similar batches stops
+allocating from the upstream resource once the initial block is large enough.  Not thread safe.
+*/
+class FrameArena
+{
+  public:
+    explicit FrameArena(std::size_t initialSize = default_arena_size,
+                        std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    std::pmr::memory_resource *resource() { return &mResource; }
+    FrameAllocator allocator() { return FrameAllocator(&mResource); }
+    /** reclaim everything allocated from the arena,  objects using the arena must be destroyed or no longer used*/
+    void release() { mResource.release(); }
+
+  private:
+    std::unique_ptr<std::byte[]> mInitial;
+    std::pmr::monotonic_buffer_resource mResource;
+};
+
+/** a pooled memory resource for frames allocated and freed individually
+@details blocks are recycled through pools of fixed sizes so a receiver which creates and discards frames at a
+steady rate stops allocating from the upstream resource once the pools are populated.  Not thread safe.
+*/
+class FramePool
+{
+  public:
+    explicit FramePool(std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+    FramePool(const FramePool &) = delete;
+    FramePool &operator=(const FramePool &) = delete;
+
+    std::pmr::memory_resource *resource() { return &mResource; }
+    FrameAllocator allocator() { return FrameAllocator(&mResource); }
+    /** return all memory to the upstream resource,  objects using the pool must be destroyed first*/
+    void release() { mResource.release(); }
+
+  private:
+    std::pmr::unsynchronized_pool_resource mResource;
+};
+}  // namespace c37118
@@ -0,0 +1,241 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "FrameRelay.hpp"
+
+#include "DatagramBatch.hpp"
+#include "c37118Crc.h"
+#include "c37118Fields.h"
+
+#include <asio/ip/udp.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+using udp = asio::ip::udp;  // from <asio/ip/udp.hpp>
+
+// LCOV_EXCL_START
+// Report a failure
+static void fail(asio::error_code ec, char const *what) { std::cerr << what << ": " << ec.message() << "\n"; }
+
+// LCOV_EXCL_STOP
+
+namespace pmu
+{
+/* marks an idcode which is forwarded unchanged*/
+static constexpr std::uint32_t no_rewrite{std::numeric_limits<std::uint32_t>::max()};
+/* the most frames queued by a UDP output before they are sent without waiting for the end of the chunk*/
+static constexpr std::size_t max_queued_frames{64U};
+
+/* the socket and queued frames of a UdpRelayOutput*/
+class UdpRelayOutput::Sender
+{
+  public:
+    explicit Sender(asio::io_context &context): mContext(context), mSocket(context) {}
+
+    bool addDestination(const std::string &address, const std::string &port);
+    void queue(const c37118::FrameSpan &frame)
+    {
+        mFrames.push_back({mBytes.size(), frame.size});
+        mBytes.insert(mBytes.end(), frame.data, frame.data + frame.size);
+    }
+    std::size_t queued() const { return mFrames.size(); }
+    /* send every queued frame to every destination and clear the queue
+    @param[in,out] calls incremented for each system call
+    @return the number of datagrams sent*/
+    std::size_t send(std::uint64_t &calls);
+    std::size_t destinationCount() const { return mDestinations.size(); }
+    void close()
+    {
+        asio::error_code ec;
+        mSocket.close(ec);
+    }
+
+  private:
+    class QueuedFrame
+    {
+      public:
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    asio::io_context &mContext;
+    udp::socket mSocket;
+    std::vector<udp::endpoint> mDestinations;
+    std::vector<std::uint8_t> mBytes;  //!< the bytes of the queued frames
+    std::vector<QueuedFrame> mFrames;
+    DatagramBatch mBatch;
+};
+
+bool UdpRelayOutput::Sender::addDestination(const std::string &address, const std::string &port)
+{
+    asio::error_code ec;
+    udp::resolver resolver(mContext);
+    auto endpoints = resolver.resolve(address, port, ec);
+    if (ec || endpoints.empty())
+    {
+        fail(ec, "relay udp resolve");
+        return false;
+    }
+    const udp::endpoint endpoint = *endpoints.begin();
+    if (!mSocket.is_open())
+    {
+        mSocket.open(endpoint.protocol(), ec);
+        if (ec)
+        {
+            fail(ec, "relay udp socket open");
+            return false;
+        }
+        // sends never block the relay,  datagrams which do not fit in the socket buffer are counted as errors
+        mSocket.non_blocking(true, ec);
+    }
+    else if (mDestinations.front().protocol() != endpoint.protocol())
+    {
+        fail(asio::error::address_family_not_supported, "relay udp destination");
+        return false;
+    }
+    mDestinations.push_back(endpoint);
+    mFrames.reserve(max_queued_frames);
+    mBatch.reserve(mDestinations.size() * max_queued_frames);
+    return true;
+}
+
+std::size_t UdpRelayOutput::Sender::send(std::uint64_t &calls)
+{
+    // the frames are added once the queue is complete since the queued bytes may move while frames are queued
+    for (const auto &frame : mFrames)
+    {
+        for (const auto &destination : mDestinations)
+        {
+            mBatch.add(mBytes.data() + frame.offset, frame.size, destination);
+        }
+    }
+    const auto sent = mBatch.send(mSocket, calls);
+    mFrames.clear();
+    mBytes.clear();
+    return sent;
+}
+
+UdpRelayOutput::UdpRelayOutput(asio::io_context &io_context): mSender(std::make_unique<Sender>(io_context)) {}
+
+UdpRelayOutput::~UdpRelayOutput() { mSender->close(); }
+
+bool UdpRelayOutput::addDestination(const std::string &address, const std::string &port)
+{
+    return mSender->addDestination(address, port);
+}
+
+void UdpRelayOutput::send(const c37118::FrameSpan &frame)
+{
+    if (mSender->destinationCount() == 0U)
+    {
+        return;
+    }
+    mSender->queue(frame);
+    if (mSender->queued() >= max_queued_frames)
+    {
+        flush();
+    }
+}
+
+void UdpRelayOutput::flush()
+{
+    const auto datagrams = mSender->queued() * mSender->destinationCount();
+    if (datagrams == 0U)
+    {
+        return;
+    }
+    const auto sent = mSender->send(mSendCalls);
+    mDatagramsSent += sent;
+    mSendErrors += datagrams - sent;
+}
+
+/* an output calling a function with each frame*/
+class FunctionOutput: public RelayOutput
+{
+  public:
+    explicit FunctionOutput(std::function<void(const c37118::FrameSpan &frame)> output): mOutput(std::move(output))
+    {
+    }
+    void send(const c37118::FrameSpan &frame) override { mOutput(frame); }
+
+  private:
+    std::function<void(const c37118::FrameSpan &frame)> mOutput;
+};
+
+FrameRelay::FrameRelay(): mIdcodeMap(65536U, no_rewrite) { mBuffer.reserve(c37118::max_frame_size); }
+
+void FrameRelay::mapIdcode(std::uint16_t from, std::uint16_t to) { mIdcodeMap[from] = to; }
+
+void FrameRelay::addOutput(std::function<void(const c37118::FrameSpan &frame)> output)
+{
+    mOutputs.push_back(std::make_shared<FunctionOutput>(std::move(output)));
+}
+
+std::size_t FrameRelay::relay(c37118::FrameExtractor &input, const std::uint8_t *data, std::size_t size)
+{
+    const auto failures = input.crcFailures();
+    input.push(data, size);
+    std::size_t relayed{0U};
+    c37118::FrameSpan frame;
+    while (input.next(frame))
+    {
+        forward(frame);
+        ++relayed;
+    }
+    mCrcFailures += input.crcFailures() - failures;
+    flush();
+    return relayed;
+}
+
+bool FrameRelay::relayFrame(const c37118::FrameSpan &frame)
+{
+    if (frame.size < c37118::common_frame_size + 2U || frame.data[0] != c37118::sync_lead ||
+        c37118::readUInt16(frame.data + 2) != frame.size ||
+        c37118::crcCCITT(frame.data, frame.size - 2U) != c37118::readUInt16(frame.data + frame.size - 2U))
+    {
+        ++mCrcFailures;
+        return false;
+    }
+    forward(frame);
+    flush();
+    return true;
+}
+
+void FrameRelay::forward(const c37118::FrameSpan &frame)
+{
+    ++mRelayed;
+    const auto idcode = mIdcodeMap[c37118::readUInt16(frame.data + 4)];
+    if (idcode == no_rewrite)
+    {
+        for (const auto &output : mOutputs)
+        {
+            output->send(frame);
+        }
+        return;
+    }
+    // the buffer is reserved for the largest frame so the copy does not allocate
+    mBuffer.assign(frame.data, frame.data + frame.size);
+    c37118::writeUInt16(mBuffer.data() + 4, static_cast<std::uint16_t>(idcode));
+    c37118::writeUInt16(mBuffer.data() + frame.size - 2U, c37118::crcCCITT(mBuffer.data(), frame.size - 2U));
+    ++mRewritten;
+    const c37118::FrameSpan rewritten{mBuffer.data(), frame.size};
+    for (const auto &output : mOutputs)
+    {
+        output->send(rewritten);
+    }
+}
+
+void FrameRelay::flush()
+{
+    for (const auto &output : mOutputs)
+    {
+        output->flush();
+    }
+}
+
+}  // namespace pmu
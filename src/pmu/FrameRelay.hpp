@@ -0,0 +1,107 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+#include "asio/io_context.hpp"
+#include "FrameExtractor.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pmu
+{
+/** a destination for the frames forwarded by a FrameRelay*/
+class RelayOutput
+{
+  public:
+    virtual ~RelayOutput() = default;
+    /** forward a frame,  the bytes are only valid during the call*/
+    virtual void send(const c37118::FrameSpan &frame) = 0;
+    /** send any frames queued by send,  called by the relay after each chunk of input*/
+    virtual void flush() {}
+};
+
+/** forwards relayed frames as UDP datagrams to unicast and multicast destinations
+@details frames are copied into a queue by send and every queued frame is sent to every destination with a single
+sendmmsg call by flush where it is available.  The socket is non blocking,  datagrams which do not fit in the socket
+buffer are counted as errors rather than delaying the relay.*/
+class UdpRelayOutput: public RelayOutput
+{
+  public:
+    explicit UdpRelayOutput(asio::io_context &io_context);
+    ~UdpRelayOutput() override;
+
+    /** add a destination
+    @return true if the address was resolved and the socket is open*/
+    bool addDestination(const std::string &address, const std::string &port);
+    void send(const c37118::FrameSpan &frame) override;
+    void flush() override;
+
+    std::uint64_t datagramsSent() const { return mDatagramsSent; }
+    std::uint64_t sendCalls() const { return mSendCalls; }
+    std::uint64_t sendErrors() const { return mSendErrors; }
+
+  private:
+    class Sender;
+    std::unique_ptr<Sender> mSender;
+    std::uint64_t mDatagramsSent{0U};
+    std::uint64_t mSendCalls{0U};
+    std::uint64_t mSendErrors{0U};
+};
+
+/** a cut-through relay forwarding C37.118 frames to one or more outputs without decoding them
+@details input bytes are split into frames by a FrameExtractor which checks the CRC of every frame,  frames which fail
+the check are dropped.  The IDCODE of the frames of a stream may be rewritten,  in which case the frame is copied into
+a reused buffer and its CRC computed again,  all other frames are forwarded from the input bytes without copying.
+Frames of every type are forwarded and the data frames are never parsed,  so the cost of a frame does not depend on
+its configuration and a stream can be relayed before its configuration has been seen.
+
+A relay is not thread safe,  use one relay per thread with its own outputs to relay on several cores.
+*/
+class FrameRelay
+{
+  public:
+    FrameRelay();
+
+    /** rewrite the IDCODE of the frames of a stream before they are forwarded*/
+    void mapIdcode(std::uint16_t from, std::uint16_t to);
+    /** add an output,  every relayed frame is sent to each output in the order they were added*/
+    void addOutput(std::shared_ptr<RelayOutput> output) { mOutputs.push_back(std::move(output)); }
+    /** add a function called with every relayed frame*/
+    void addOutput(std::function<void(const c37118::FrameSpan &frame)> output);
+
+    /** relay a chunk of a byte stream
+    @param input the extractor of the connection the chunk was read from,  keeping frames split across chunks
+    @details the bytes of a frame split across chunks are copied by the extractor so the chunk may be reused for the
+    next read as soon as the call returns.  For a datagram call input.flush() afterwards to discard an incomplete
+    frame
+    @return the number of frames relayed*/
+    std::size_t relay(c37118::FrameExtractor &input, const std::uint8_t *data, std::size_t size);
+    /** relay a complete frame from an input which does not check the CRC
+    @return true if the CRC was valid and the frame was relayed*/
+    bool relayFrame(const c37118::FrameSpan &frame);
+
+    std::uint64_t framesRelayed() const { return mRelayed; }
+    /** the number of frames dropped with an invalid CRC*/
+    std::uint64_t crcFailures() const { return mCrcFailures; }
+    /** the number of frames relayed with a rewritten IDCODE*/
+    std::uint64_t framesRewritten() const { return mRewritten; }
+
+  private:
+    /* forward a frame which has passed the CRC check to every output without flushing them*/
+    void forward(const c37118::FrameSpan &frame);
+    void flush();
+
+    std::vector<std::uint32_t> mIdcodeMap;  //!< the replacement IDCODE of each IDCODE or no_rewrite
+    std::vector<std::shared_ptr<RelayOutput>> mOutputs;
+    std::vector<std::uint8_t> mBuffer;  //!< the copy of a frame with a rewritten IDCODE
+    std::uint64_t mRelayed{0U};
+    std::uint64_t mCrcFailures{0U};
+    std::uint64_t mRewritten{0U};
+};
+}  // namespace pmu
@@ -0,0 +1,95 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "FrameTemplate.hpp"
+
+#include "FrameLayout.hpp"
+#include "c37118Crc.h"
+#include "c37118Fields.h"
+
+namespace c37118
+{
+/* the SOC and FRACSEC fields occupy bytes 6 through 13 of every frame*/
+static constexpr std::size_t time_offset{6U};
+static constexpr std::size_t time_size{8U};
+
+std::uint16_t DataFrameTemplate::encode(const Config &config, const PmuDataFrame &frame)
+{
+    std::shared_ptr<const FrameLayout> tempLayout;
+    const auto &layout = getFrameLayout(config, tempLayout);
+    mLayout = tempLayout ? tempLayout : config.layout;
+    mIdCode = config.idcode;
+    mTimeBase = config.timeBase;
+
+    mFrame.resize(layout.frameSize);
+    const auto size = generateDataFrame(mFrame.data(), mFrame.size(), config, frame);
+    if (size == 0U)
+    {
+        mFrame.clear();
+        return 0U;
+    }
+
+    // the CRC register after the time fields is shifted through the remaining bytes,  with an initial value of 0
+    // this is a linear function of the register so only the effect of each bit needs to be computed
+    const std::size_t following = size - 2U - (time_offset + time_size);
+    const std::vector<std::uint8_t> zeros(following, 0U);
+    std::array<std::uint16_t, 16> bitShift{};
+    for (std::size_t bit = 0; bit < 16U; ++bit)
+    {
+        bitShift[bit] = crcCCITT(zeros.data(), following, static_cast<std::uint16_t>(1U << bit));
+    }
+    for (std::size_t value = 0; value < 256U; ++value)
+    {
+        std::uint16_t high{0U};
+        std::uint16_t low{0U};
+        for (std::size_t bit = 0; bit < 8U; ++bit)
+        {
+            if ((value & (1U << bit)) != 0U)
+            {
+                high ^= bitShift[bit + 8U];
+                low ^= bitShift[bit];
+            }
+        }
+        mShiftHigh[value] = high;
+        mShiftLow[value] = low;
+    }
+    return size;
+}
+
+void DataFrameTemplate::setTime(std::uint32_t soc, std::uint32_t fracSec)
+{
+    if (mFrame.empty())
+    {
+        return;
+    }
+    std::uint8_t *timeData = mFrame.data() + time_offset;
+    std::uint8_t update[time_size];
+    writeUInt32(update, soc);
+    writeUInt32(update + 4, fracSec);
+    std::uint8_t delta[time_size];
+    for (std::size_t ii = 0; ii < time_size; ++ii)
+    {
+        delta[ii] = timeData[ii] ^ update[ii];
+        timeData[ii] = update[ii];
+    }
+    // with no final xor the CRC of the new frame is the old CRC xor the CRC of the difference
+    const std::uint16_t change = crcCCITT(delta, time_size, 0U);
+    std::uint8_t *crcData = mFrame.data() + mFrame.size() - 2U;
+    writeUInt16(crcData,
+                static_cast<std::uint16_t>(readUInt16(crcData) ^ mShiftHigh[change >> 8U] ^
+                                           mShiftLow[change & 0xFFU]));
+}
+
+bool DataFrameTemplate::matches(const Config &config) const
+{
+    if (mFrame.empty() || config.idcode != mIdCode || config.timeBase != mTimeBase)
+    {
+        return false;
+    }
+    // a configuration may have been changed after its layout was compiled so the layout pointer is not enough
+    return mLayout->matches(config);
+}
+}  // namespace c37118
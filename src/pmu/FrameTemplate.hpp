@@ -0,0 +1,51 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+#include "c37118.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+/** @file
+pre-encoded data frames for sources whose data does not change between frames
+*/
+namespace c37118
+{
+/** a data frame encoded once whose time fields can be updated without encoding the frame again
+@details the CRC is updated incrementally when the time changes,  the CRC has no final xor so the change in the
+CRC depends only on the change in the 8 time bytes and the number of bytes following them
+*/
+class DataFrameTemplate
+{
+  public:
+    /** encode the payload of a frame
+    @return the size of the frame or 0 if the frame could not be generated*/
+    std::uint16_t encode(const Config &config, const PmuDataFrame &frame);
+    /** set the SOC and the FRACSEC field (including the time quality in the upper 8 bits) as produced by
+     * generateTimeCodes*/
+    void setTime(std::uint32_t soc, std::uint32_t fracSec);
+    /** check if the template was encoded with the layout and identification of a configuration*/
+    bool matches(const Config &config) const;
+
+    /** discard the encoded frame so the next use encodes it again*/
+    void clear() { mFrame.clear(); }
+    bool empty() const { return mFrame.empty(); }
+    const std::uint8_t *data() const { return mFrame.data(); }
+    std::uint16_t size() const { return static_cast<std::uint16_t>(mFrame.size()); }
+
+  private:
+    std::vector<std::uint8_t> mFrame;
+    /** the effect on the CRC of each possible value of the high and low bytes of a CRC computed over the time
+     * fields and propagated through the rest of the frame*/
+    std::array<std::uint16_t, 256> mShiftHigh{};
+    std::array<std::uint16_t, 256> mShiftLow{};
+    std::shared_ptr<const FrameLayout> mLayout;
+    std::uint16_t mIdCode{0U};
+    std::uint32_t mTimeBase{0U};
+};
+}  // namespace c37118
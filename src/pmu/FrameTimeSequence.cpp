@@ -0,0 +1,63 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "FrameTimeSequence.hpp"
+
+namespace c37118
+{
+static constexpr std::uint64_t nanoseconds_per_second{1'000'000'000U};
+
+FrameTimeSequence::FrameTimeSequence(std::int16_t dataRate, std::uint32_t timeBase)
+{
+    if (dataRate <= 0)
+    {
+        // a single frame every few seconds
+        mSecondsPerFrame = (dataRate < 0) ? static_cast<std::uint32_t>(-static_cast<std::int32_t>(dataRate)) : 1U;
+        mTicks.assign(1U, 0U);
+        mOffsets.assign(1U, 0);
+        return;
+    }
+    const auto rate = static_cast<std::uint64_t>(dataRate);
+    mTicks.resize(rate);
+    mOffsets.resize(rate);
+    for (std::uint64_t ii = 0; ii < rate; ++ii)
+    {
+        // the nearest count to the exact frame time ii/rate
+        mTicks[ii] = static_cast<std::uint32_t>((2U * ii * timeBase + rate) / (2U * rate));
+        mOffsets[ii] = static_cast<std::int64_t>((2U * ii * nanoseconds_per_second + rate) / (2U * rate));
+    }
+}
+
+void FrameTimeSequence::start(std::chrono::nanoseconds tp)
+{
+    const auto count = tp.count();
+    auto seconds = static_cast<std::uint64_t>(count / static_cast<std::int64_t>(nanoseconds_per_second));
+    const auto frac = static_cast<std::uint64_t>(count % static_cast<std::int64_t>(nanoseconds_per_second));
+    if (mSecondsPerFrame > 1U)
+    {
+        // frames are aligned to multiples of the period
+        if (frac > 0U)
+        {
+            ++seconds;
+        }
+        seconds = ((seconds + mSecondsPerFrame - 1U) / mSecondsPerFrame) * mSecondsPerFrame;
+        mSoc = static_cast<std::uint32_t>(seconds);
+        mIndex = 0U;
+        return;
+    }
+    mSoc = static_cast<std::uint32_t>(seconds);
+    mIndex = 0U;
+    while (mIndex < mOffsets.size() && static_cast<std::uint64_t>(mOffsets[mIndex]) < frac)
+    {
+        ++mIndex;
+    }
+    if (mIndex == mOffsets.size())
+    {
+        mIndex = 0U;
+        ++mSoc;
+    }
+}
+}  // namespace c37118
@@ -0,0 +1,60 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+#include "c37118.h"
+
+#include <chrono>
+#include <vector>
+
+/** @file
+precomputed frame times for a data rate
+*/
+namespace c37118
+{
+/** the sequence of frame times for a data rate and time base
+@details the fraction of second count and the offset within the second of every frame are computed once so stepping
+through the frames of a generator requires no arithmetic beyond an increment
+*/
+class FrameTimeSequence
+{
+  public:
+    /** construct a sequence
+    @param dataRate the frames per second if positive or the seconds per frame if negative as in the configuration
+    frame
+    @param timeBase the FRACSEC resolution*/
+    FrameTimeSequence(std::int16_t dataRate, std::uint32_t timeBase);
+    explicit FrameTimeSequence(const Config &config): FrameTimeSequence(config.dataRate, config.timeBase) {}
+
+    /** move to the first frame at or after a time*/
+    void start(std::chrono::nanoseconds tp);
+    /** move to the next frame*/
+    void advance()
+    {
+        if (++mIndex == mTicks.size())
+        {
+            mIndex = 0U;
+            mSoc += mSecondsPerFrame;
+        }
+    }
+    /** the SOC and FRACSEC count of the current frame*/
+    TimeCode current() const { return {mSoc, mTicks[mIndex]}; }
+    /** the time of the current frame since the epoch*/
+    std::chrono::nanoseconds currentTime() const
+    {
+        return std::chrono::seconds(mSoc) + std::chrono::nanoseconds(mOffsets[mIndex]);
+    }
+    /** the FRACSEC count of each frame within a second*/
+    const std::vector<std::uint32_t> &ticks() const { return mTicks; }
+
+  private:
+    std::vector<std::uint32_t> mTicks;  //!< FRACSEC count of each frame in a second
+    std::vector<std::int64_t> mOffsets;  //!< nanoseconds from the start of the second to each frame
+    std::size_t mIndex{0U};  //!< the current frame within the second
+    std::uint32_t mSoc{0U};  //!< the second of the current frame
+    std::uint32_t mSecondsPerFrame{1U};  //!< the increment of the SOC after the last frame of a second
+};
+}  // namespace c37118
@@ -19,10 +19,15 @@ Pmu::Pmu(const std::string &configStr):mContext(std::make_shared<asio::io_contex
 		mSource = generateSource(configStr);
 	}
 
-	Pmu::Pmu(const std::string& configStr, std::shared_ptr<asio::io_context> context):mTimer(*context) {
+	Pmu::Pmu(const std::string& configStr, std::shared_ptr<asio::io_context> context):mContext(std::move(context)),mTimer(*mContext) {
         mSource = generateSource(configStr);
 	}
 
+Pmu::Pmu(std::shared_ptr<Source> source, std::shared_ptr<asio::io_context> context):
+    mSource(std::move(source)), mContext(std::move(context)), mTimer(*mContext)
+{
+}
+
 	Pmu::~Pmu() {}
 
     void Pmu::start() { 
@@ -34,7 +39,7 @@ Pmu::Pmu(const std::string &configStr):mContext(std::make_shared<asio::io_contex
 
 void Pmu::startThread() {}
 
-std::chrono::nanoseconds getClockTime() { 
+std::chrono::nanoseconds Pmu::getClockTime() { 
 	return std::chrono::system_clock::now().time_since_epoch();
 }
 
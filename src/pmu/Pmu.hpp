@@ -26,18 +26,20 @@ class Pmu
 
     std::vector<std::function<void(const c37118::PmuDataFrame &pdf)>> callbacks;
 
+    decltype(std::chrono::steady_clock::now()) start_time;  //!< the steady clock time when the PMU was started
+    std::chrono::nanoseconds clock_time{0};  //!< the PMU clock time corresponding to start_time
+
   private:
     std::shared_ptr<asio::io_context> mContext;
     std::thread executionThread;
     asio::steady_timer mTimer;
-    decltype(std::chrono::steady_clock::now()) start_time;
-    std::chrono::nanoseconds clock_time;
     std::shared_ptr<AsioContextManager> contextPtr;  //!< context manager to for handling real time operations
     decltype(contextPtr->startContextLoop()) loopHandle;  //!< loop controller for async real time operations
   public:
     Pmu();
     explicit Pmu(const std::string &configStr);
     Pmu(const std::string &configStr, std::shared_ptr<asio::io_context> context);
+    Pmu(std::shared_ptr<Source> source, std::shared_ptr<asio::io_context> context);
 
     virtual ~Pmu();
 
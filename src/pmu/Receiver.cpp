@@ -5,6 +5,9 @@ the top-level NOTICE for additional details. All rights reserved. SPDX-License-I
 */
 
 #include "Receiver.hpp"
+
+#include "FrameExtractor.hpp"
+
 namespace pmu
 {
 
@@ -18,26 +21,37 @@ namespace pmu
 
 	bool Receiver::getConfig() {
         
-        auto size=c37118::generateCommand(buffer.data(), 65536, c37118::PmuCommand::send_config2, idCode);
+        auto size=c37118::generateCommand(buffer.data(), buffer.size(), c37118::PmuCommand::send_config2, idCode);
         connection->send(buffer.data(), size);
-        auto sz=connection->receive(buffer.data(), 65536);
-        c37118::ParseResult pr;
-        for (pr=c37118::parseConfig2(buffer.data(), sz, config);pr==c37118::ParseResult::length_mismatch;)
+        c37118::FrameExtractor extractor;
+        c37118::FrameSpan frame;
+        while (true)
         {
-            auto sz2 = connection->receive(buffer.data()+sz, 65536);
-            sz += sz2;
+            auto sz = connection->receive(buffer.data(), buffer.size());
+            if (sz == 0)
+            {
+                return false;
+            }
+            extractor.push(buffer.data(), sz);
+            while (extractor.next(frame))
+            {
+                if (c37118::getPacketType(frame.data, frame.size) == c37118::PmuPacketType::config2)
+                {
+                    return (c37118::parseConfig2(frame.data, frame.size, config) ==
+                            c37118::ParseResult::parse_complete);
+                }
+            }
         }
-        return (pr == c37118::ParseResult::parse_complete);
 	}
 
     void Receiver::startData() {
-        auto size = c37118::generateCommand(buffer.data(), 65536, c37118::PmuCommand::data_on, idCode);
+        auto size = c37118::generateCommand(buffer.data(), buffer.size(), c37118::PmuCommand::data_on, idCode);
         connection->send(buffer.data(), size);
     }
 
     void Receiver::stopData()
     {
-        auto size = c37118::generateCommand(buffer.data(), 65536, c37118::PmuCommand::data_off, idCode);
+        auto size = c37118::generateCommand(buffer.data(), buffer.size(), c37118::PmuCommand::data_off, idCode);
         connection->send(buffer.data(), size);
     }
 
@@ -0,0 +1,484 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "ReceiverGroup.hpp"
+
+#include <asio/connect.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/post.hpp>
+#include <asio/steady_timer.hpp>
+#include <asio/strand.hpp>
+#include <asio/write.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+
+using tcp = asio::ip::tcp;  // from <asio/ip/tcp.hpp>
+
+// LCOV_EXCL_START
+// Report a failure
+static void fail(asio::error_code ec, char const *what) { std::cerr << what << ": " << ec.message() << "\n"; }
+
+// LCOV_EXCL_STOP
+
+namespace pmu
+{
+/* the size of a command frame without extended data*/
+static constexpr std::size_t command_size{18U};
+/* the receive buffer of each device,  large enough for the largest frame*/
+static constexpr std::size_t receive_buffer_size{65536U};
+/* the time allowed to write the data off command when stopping before the connection is closed anyway*/
+static constexpr std::chrono::milliseconds stop_timeout{1000};
+/* how often a stop waiting for the sessions to close checks if the io_context has stopped*/
+static constexpr std::chrono::milliseconds stop_poll_interval{50};
+
+using FrameCall = std::function<void(std::size_t device, const c37118::FrameSpan &frame, const c37118::Config &config)>;
+using StateCall = std::function<void(std::size_t device, DeviceState state)>;
+
+/* errors which only mean the device has gone or the session was closed*/
+static bool isDisconnect(const asio::error_code &ec)
+{
+    return ec == asio::error::eof || ec == asio::error::operation_aborted || ec == asio::error::connection_reset ||
+      ec == asio::error::broken_pipe;
+}
+
+/* a command frame for a device,  encoded once when the session is created*/
+static std::vector<std::uint8_t> encodeCommand(c37118::PmuCommand cmd, std::uint16_t idcode)
+{
+    std::vector<std::uint8_t> command(command_size);
+    command.resize(c37118::generateCommand(command.data(), command.size(), cmd, idcode));
+    return command;
+}
+
+static bool isStarting(DeviceState state)
+{
+    return state == DeviceState::connecting || state == DeviceState::configuring;
+}
+
+static bool isFinished(DeviceState state) { return state == DeviceState::failed || state == DeviceState::closed; }
+
+/* the states and configurations of the devices shared between the sessions and the ReceiverGroup*/
+class DeviceGroupState
+{
+  public:
+    DeviceGroupState(std::size_t deviceCount, FrameCall frames, StateCall states):
+        frameCall(std::move(frames)), stateCall(std::move(states)), mStates(deviceCount, DeviceState::idle),
+        mConfigs(deviceCount), mOpen(deviceCount)
+    {
+    }
+
+    void setState(std::size_t device, DeviceState state)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            const bool wasStarting = isStarting(mStates[device]);
+            mStates[device] = state;
+            if (wasStarting != isStarting(state))
+            {
+                mStarting += isStarting(state) ? 1 : -1;
+            }
+            if (state == DeviceState::streaming)
+            {
+                ++mStreaming;
+            }
+        }
+        mChanged.notify_all();
+        if (stateCall)
+        {
+            stateCall(device, state);
+        }
+        if (isFinished(state))
+        {
+            // counted after the state call so no callback of the session is running once it is no longer open
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                --mOpen;
+            }
+            mChanged.notify_all();
+        }
+    }
+    void setConfig(std::size_t device, const c37118::Config &config)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mConfigs[device] = config;
+    }
+    /* move a streaming device to closed,  the streaming count is only reduced here*/
+    void setClosed(std::size_t device)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mStates[device] == DeviceState::streaming)
+            {
+                --mStreaming;
+            }
+        }
+        setState(device, DeviceState::closed);
+    }
+
+    DeviceState getState(std::size_t device) const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mStates[device];
+    }
+    c37118::Config getConfig(std::size_t device) const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mConfigs[device];
+    }
+    std::size_t streamingCount() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mStreaming;
+    }
+    bool waitForStartup(std::chrono::milliseconds timeout) const
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        return mChanged.wait_for(lock, timeout, [this]() { return mStarting == 0; });
+    }
+    /* wait until every session has failed or closed*/
+    bool waitForClosed(std::chrono::milliseconds timeout) const
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        return mChanged.wait_for(lock, timeout, [this]() { return mOpen == 0U; });
+    }
+
+    const FrameCall frameCall;
+    const StateCall stateCall;
+
+  private:
+    mutable std::mutex mMutex;
+    mutable std::condition_variable mChanged;
+    std::vector<DeviceState> mStates;
+    std::vector<c37118::Config> mConfigs;
+    std::ptrdiff_t mStarting{0};  //!< the number of devices connecting or configuring
+    std::size_t mStreaming{0U};
+    std::size_t mOpen{0U};  //!< the number of devices which have not failed or closed
+};
+
+/* the connection to one device of a group,  the resolver,  socket and deadline timer run on a strand and all the
+ * state is only touched there*/
+class DeviceSession: public std::enable_shared_from_this<DeviceSession>
+{
+  public:
+    DeviceSession(asio::io_context &context,
+                  std::size_t index,
+                  DeviceAddress device,
+                  std::shared_ptr<DeviceGroupState> group):
+        mStrand(asio::make_strand(context)),
+        mResolver(mStrand), mSocket(mStrand), mDeadline(mStrand), mDevice(std::move(device)),
+        mConfigCommand(encodeCommand(c37118::PmuCommand::send_config2, mDevice.idcode)),
+        mDataOnCommand(encodeCommand(c37118::PmuCommand::data_on, mDevice.idcode)),
+        mDataOffCommand(encodeCommand(c37118::PmuCommand::data_off, mDevice.idcode)), mGroup(std::move(group)),
+        mBuffer(receive_buffer_size), mIndex(index)
+    {
+    }
+
+    void start(std::chrono::milliseconds connectTimeout, std::chrono::milliseconds configTimeout)
+    {
+        mConfigTimeout = configTimeout;
+        setState(DeviceState::connecting);
+        asio::post(mStrand, [self = shared_from_this(), connectTimeout]() {
+            self->armDeadline(connectTimeout);
+            self->mResolver.async_resolve(
+              self->mDevice.address,
+              self->mDevice.port,
+              [self](const asio::error_code &ec, const tcp::resolver::results_type &endpoints) {
+                  self->onResolve(ec, endpoints);
+              });
+        });
+    }
+
+    /* turn data off and close the connection,  may be called from any thread*/
+    void stop()
+    {
+        asio::post(mStrand, [self = shared_from_this()]() {
+            if (self->mState != DeviceState::streaming || self->mStopping)
+            {
+                self->finish();
+                return;
+            }
+            // the connection is closed once data off is written,  or by the deadline if the write does not complete
+            self->mStopping = true;
+            self->armDeadline(stop_timeout);
+            self->sendCommand(self->mDataOffCommand);
+        });
+    }
+
+  private:
+    void armDeadline(std::chrono::milliseconds timeout)
+    {
+        mDeadline.expires_after(timeout);
+        mDeadline.async_wait([self = shared_from_this()](const asio::error_code &ec) {
+            if (ec)
+            {
+                return;
+            }
+            if (isStarting(self->mState))
+            {
+                fail(asio::error::timed_out, "pmu receiver group device");
+                self->finish();
+            }
+            else if (self->mStopping)
+            {
+                self->finish();
+            }
+        });
+    }
+
+    void onResolve(const asio::error_code &ec, const tcp::resolver::results_type &endpoints)
+    {
+        if (mState != DeviceState::connecting)
+        {
+            return;
+        }
+        if (ec)
+        {
+            fail(ec, "pmu receiver group resolve");
+            finish();
+            return;
+        }
+        asio::async_connect(mSocket,
+                            endpoints,
+                            [self = shared_from_this()](const asio::error_code &connectError,
+                                                        const tcp::endpoint & /*endpoint*/) {
+                                self->onConnect(connectError);
+                            });
+    }
+
+    void onConnect(const asio::error_code &ec)
+    {
+        if (mState != DeviceState::connecting)
+        {
+            return;
+        }
+        if (ec)
+        {
+            fail(ec, "pmu receiver group connect");
+            finish();
+            return;
+        }
+        asio::error_code optionError;
+        mSocket.set_option(tcp::no_delay(true), optionError);
+        setState(DeviceState::configuring);
+        armDeadline(mConfigTimeout);
+        sendCommand(mConfigCommand);
+        doRead();
+    }
+
+    void doRead()
+    {
+        mSocket.async_read_some(asio::buffer(mBuffer.data(), mBuffer.size()),
+                                [self = shared_from_this()](const asio::error_code &ec, std::size_t bytes) {
+                                    self->onRead(ec, bytes);
+                                });
+    }
+
+    void onRead(const asio::error_code &ec, std::size_t bytes)
+    {
+        if (mState == DeviceState::failed || mState == DeviceState::closed)
+        {
+            return;
+        }
+        if (ec)
+        {
+            if (!isDisconnect(ec))
+            {
+                fail(ec, "pmu receiver group read");
+            }
+            finish();
+            return;
+        }
+        mExtractor.push(mBuffer.data(), bytes);
+        c37118::FrameSpan frame;
+        while (mExtractor.next(frame))
+        {
+            handleFrame(frame);
+        }
+        doRead();
+    }
+
+    void handleFrame(const c37118::FrameSpan &frame)
+    {
+        const auto type = c37118::getPacketType(frame.data, frame.size);
+        if (mState == DeviceState::streaming)
+        {
+            if (type == c37118::PmuPacketType::data && mGroup->frameCall)
+            {
+                mGroup->frameCall(mIndex, frame, mConfig);
+            }
+            return;
+        }
+        if (type != c37118::PmuPacketType::config2 ||
+            c37118::parseConfig2(frame.data, frame.size, mConfig) != c37118::ParseResult::parse_complete)
+        {
+            return;
+        }
+        mDeadline.cancel();
+        mGroup->setConfig(mIndex, mConfig);
+        sendCommand(mDataOnCommand);
+        setState(DeviceState::streaming);
+    }
+
+    /* queue a command,  only one write may be in progress on the socket so the next queued command is written
+     * from the completion of the previous one*/
+    void sendCommand(const std::vector<std::uint8_t> &command)
+    {
+        mWrites.push_back(&command);
+        if (mWrites.size() == 1U)
+        {
+            doWrite();
+        }
+    }
+
+    void doWrite()
+    {
+        asio::async_write(mSocket,
+                          asio::buffer(*mWrites.front()),
+                          [self = shared_from_this()](const asio::error_code &ec, std::size_t /*bytes*/) {
+                              self->onWrite(ec);
+                          });
+    }
+
+    void onWrite(const asio::error_code &ec)
+    {
+        mWrites.pop_front();
+        if (ec)
+        {
+            mWrites.clear();
+            if (!isDisconnect(ec) && !mStopping)
+            {
+                fail(ec, "pmu receiver group write");
+            }
+        }
+        else if (!mWrites.empty())
+        {
+            doWrite();
+            return;
+        }
+        // data off is the last command written when stopping
+        if (mStopping)
+        {
+            finish();
+        }
+    }
+
+    void setState(DeviceState state)
+    {
+        mState = state;
+        mGroup->setState(mIndex, state);
+    }
+
+    /* close the connection,  a device which had not started streaming has failed to start*/
+    void finish()
+    {
+        if (isFinished(mState))
+        {
+            return;
+        }
+        const bool wasStreaming = (mState == DeviceState::streaming);
+        mDeadline.cancel();
+        mResolver.cancel();
+        asio::error_code ec;
+        mSocket.close(ec);
+        if (wasStreaming)
+        {
+            mState = DeviceState::closed;
+            mGroup->setClosed(mIndex);
+        }
+        else
+        {
+            setState(DeviceState::failed);
+        }
+    }
+
+    asio::strand<asio::io_context::executor_type> mStrand;
+    tcp::resolver mResolver;
+    tcp::socket mSocket;
+    asio::steady_timer mDeadline;  //!< the connect timeout and then the configuration timeout
+    const DeviceAddress mDevice;
+    const std::vector<std::uint8_t> mConfigCommand;
+    const std::vector<std::uint8_t> mDataOnCommand;
+    const std::vector<std::uint8_t> mDataOffCommand;
+    std::shared_ptr<DeviceGroupState> mGroup;
+    std::vector<std::uint8_t> mBuffer;
+    std::deque<const std::vector<std::uint8_t> *> mWrites;  //!< queued commands,  the first is being written
+    c37118::FrameExtractor mExtractor;
+    c37118::Config mConfig;
+    std::chrono::milliseconds mConfigTimeout{4000};
+    const std::size_t mIndex;
+    DeviceState mState{DeviceState::idle};
+    bool mStopping{false};  //!< data off is being written before the connection is closed
+};
+
+ReceiverGroup::~ReceiverGroup() { stop(); }
+
+std::size_t ReceiverGroup::addDevice(const std::string &address, const std::string &port, std::uint16_t idcode)
+{
+    DeviceAddress device;
+    device.address = address;
+    device.port = port;
+    device.idcode = idcode;
+    devices.push_back(std::move(device));
+    return devices.size() - 1U;
+}
+
+void ReceiverGroup::start(asio::io_context &io_context)
+{
+    stop();
+    mContext = &io_context;
+    mGroup = std::make_shared<DeviceGroupState>(devices.size(), mFrameCall, mStateCall);
+    mSessions.reserve(devices.size());
+    for (std::size_t ii = 0; ii < devices.size(); ++ii)
+    {
+        mSessions.push_back(std::make_shared<DeviceSession>(io_context, ii, devices[ii], mGroup));
+    }
+    // every device is started before any of them is waited on
+    for (auto &session : mSessions)
+    {
+        session->start(connectTimeout, configTimeout);
+    }
+}
+
+bool ReceiverGroup::waitForStartup(std::chrono::milliseconds timeout) const
+{
+    return mGroup ? mGroup->waitForStartup(timeout) : devices.empty();
+}
+
+void ReceiverGroup::stop()
+{
+    for (auto &session : mSessions)
+    {
+        session->stop();
+    }
+    mSessions.clear();
+    if (!mGroup || mContext == nullptr || mContext->get_executor().running_in_this_thread())
+    {
+        return;
+    }
+    // the sessions close on the threads running the io_context within stop_timeout,  so the limit is only reached
+    // when nothing is running it and no callback can run either
+    const auto deadline = std::chrono::steady_clock::now() + 2 * stop_timeout;
+    while (!mGroup->waitForClosed(stop_poll_interval) && !mContext->stopped() &&
+           std::chrono::steady_clock::now() < deadline)
+    {
+    }
+}
+
+DeviceState ReceiverGroup::getState(std::size_t device) const
+{
+    return (mGroup && device < devices.size()) ? mGroup->getState(device) : DeviceState::idle;
+}
+
+c37118::Config ReceiverGroup::getConfig(std::size_t device) const
+{
+    return (mGroup && device < devices.size()) ? mGroup->getConfig(device) : c37118::Config{};
+}
+
+std::size_t ReceiverGroup::streamingCount() const { return mGroup ? mGroup->streamingCount() : 0U; }
+
+}  // namespace pmu
@@ -0,0 +1,110 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+#include "asio/io_context.hpp"
+#include "FrameExtractor.hpp"
+#include "c37118.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pmu
+{
+class DeviceGroupState;
+class DeviceSession;
+
+/** the progress of a device of a ReceiverGroup*/
+enum class DeviceState : std::uint8_t
+{
+    idle = 0,  //!< the group has not been started
+    connecting = 1,  //!< resolving the address and connecting
+    configuring = 2,  //!< waiting for the config2 frame
+    streaming = 3,  //!< data has been turned on
+    failed = 4,  //!< the device could not be connected or configured in time
+    closed = 5  //!< the connection was closed after streaming
+};
+
+/** the address of a PMU or PDC served over TCP*/
+class DeviceAddress
+{
+  public:
+    std::string address;
+    std::string port{"4712"};
+    std::uint16_t idcode{0U};
+};
+
+/** a set of PMUs or PDCs brought up in parallel on a shared io_context
+@details each device is resolved,  connected,  asked for its config2 frame and then turned on asynchronously,  all
+devices at once,  so starting the group takes as long as the slowest device rather than the sum of all of them.  A
+device which does not connect within the connect timeout or does not send its configuration within the
+configuration timeout is closed and marked failed without affecting the others.  The frame callback is called for
+every data frame of a streaming device on the thread running the io_context.
+*/
+class ReceiverGroup
+{
+  protected:
+    std::vector<DeviceAddress> devices;
+    std::chrono::milliseconds connectTimeout{4000};  //!< the time allowed to resolve and connect
+    std::chrono::milliseconds configTimeout{4000};  //!< the time allowed for the config2 frame after connecting
+
+  private:
+    asio::io_context *mContext{nullptr};  //!< the io_context the sessions were started on
+    std::shared_ptr<DeviceGroupState> mGroup;
+    std::vector<std::shared_ptr<DeviceSession>> mSessions;
+    std::function<void(std::size_t device, const c37118::FrameSpan &frame, const c37118::Config &config)> mFrameCall;
+    std::function<void(std::size_t device, DeviceState state)> mStateCall;
+
+  public:
+    ReceiverGroup() = default;
+    ReceiverGroup(const ReceiverGroup &) = delete;
+    ReceiverGroup &operator=(const ReceiverGroup &) = delete;
+    ~ReceiverGroup();
+
+    /** add a device to the group
+    @return the index of the device,  used in the callbacks and the state queries*/
+    std::size_t addDevice(const std::string &address, const std::string &port, std::uint16_t idcode);
+    std::size_t deviceCount() const { return devices.size(); }
+    /** set the time each device is allowed to connect and then to send its configuration*/
+    void setTimeouts(std::chrono::milliseconds connect, std::chrono::milliseconds config)
+    {
+        connectTimeout = connect;
+        configTimeout = config;
+    }
+    /** set the function called for every data frame*/
+    void setFrameCall(
+      std::function<void(std::size_t device, const c37118::FrameSpan &frame, const c37118::Config &config)> frameCall)
+    {
+        mFrameCall = std::move(frameCall);
+    }
+    /** set the function called when a device changes state*/
+    void setStateCall(std::function<void(std::size_t device, DeviceState state)> stateCall)
+    {
+        mStateCall = std::move(stateCall);
+    }
+
+    /** start bringing up all the devices,  returns without waiting for them*/
+    void start(asio::io_context &io_context);
+    /** wait until every device is streaming or has failed
+    @return true if no device is still connecting or configuring*/
+    bool waitForStartup(std::chrono::milliseconds timeout) const;
+    /** turn data off and close all the connections
+    @details waits until every connection is closed so no callback runs after stop returns,  unless called from a
+    thread running the io_context,  in which case the connections are closed after it returns.  A group must not be
+    destroyed from one of its own callbacks*/
+    void stop();
+
+    /** get the state of a device*/
+    DeviceState getState(std::size_t device) const;
+    /** get the configuration received from a device,  empty until the device is streaming*/
+    c37118::Config getConfig(std::size_t device) const;
+    /** get the number of devices in the streaming state*/
+    std::size_t streamingCount() const;
+};
+}  // namespace pmu
@@ -20,6 +20,13 @@ void Source::fillDataFrame(c37118::PmuDataFrame &frame, std::chrono::nanoseconds
     loadDataFrame(mConfig, frame, frame_time);
 }
 
+std::uint16_t Source::generateFrame(std::uint8_t *data, std::size_t dataSize, std::chrono::nanoseconds frame_time)
+{
+    c37118::PmuDataFrame frame;
+    loadDataFrame(mConfig, frame, frame_time);
+    return c37118::generateDataFrame(data, dataSize, mConfig, frame);
+}
+
 std::unique_ptr<Source> generateSource(const std::string &configFile)
 {
     auto jv = c37118::fileops::loadJsonStr(configFile);
@@ -20,9 +20,14 @@ namespace pmu
         virtual ~Source() = default;
         /** load the system configuration*/
         void setConfig(const c37118::Config &config) { mConfig = config; }
+        const c37118::Config &getConfig() const { return mConfig; }
         virtual void loadConfig(const std::string &configStr);
 
         void fillDataFrame(c37118::PmuDataFrame &frame, std::chrono::nanoseconds frame_time);
+        /** generate the encoded data frame for a particular time
+        @return the size of the frame or 0 if the frame does not fit in dataSize*/
+        virtual std::uint16_t
+          generateFrame(std::uint8_t *data, std::size_t dataSize, std::chrono::nanoseconds frame_time);
 
       protected:
         virtual void loadDataFrame(const c37118::Config &dataConfig,
@@ -8,6 +8,8 @@ the top-level NOTICE for additional details. All rights reserved. SPDX-License-I
 #include "JsonProcessingFunctions.hpp"
 #include "configure.hpp"
 
+#include <cstring>
+
 namespace pmu
 {
 
@@ -30,7 +32,7 @@ namespace pmu
             }
             
         }
-        
+        mTemplate.clear();
     }
 
     void StableSource::loadDataFrame(const c37118::Config &dataConfig,
@@ -39,8 +41,25 @@ namespace pmu
     {
         frame = mStableData;
         auto tc = c37118::generateTimeCodes(current_time, dataConfig);
-        frame.soc = tc.first;
-        frame.fracSec = tc.second;
+        c37118::setFrameTime(frame, tc.first, tc.second & 0x00FFFFFFU, dataConfig.timeBase);
+        frame.timeQuality = static_cast<std::uint8_t>(tc.second >> 24U);
+    }
+
+    std::uint16_t
+      StableSource::generateFrame(std::uint8_t *data, std::size_t dataSize, std::chrono::nanoseconds frame_time)
+    {
+        if (!mTemplate.matches(mConfig) && mTemplate.encode(mConfig, mStableData) == 0U)
+        {
+            return 0U;
+        }
+        auto tc = c37118::generateTimeCodes(frame_time, mConfig);
+        mTemplate.setTime(tc.first, tc.second);
+        if (dataSize < mTemplate.size())
+        {
+            return 0U;
+        }
+        memcpy(data, mTemplate.data(), mTemplate.size());
+        return mTemplate.size();
     }
 
 }  // namespace pmu
\ No newline at end of file
@@ -4,6 +4,7 @@ Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance
 the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
 */
 #pragma once
+#include "FrameTemplate.hpp"
 #include "Source.hpp"
 
 namespace pmu
@@ -12,11 +13,20 @@ namespace pmu
 	{
       protected:
         c37118::PmuDataFrame mStableData;
+        /** the encoded stable data,  only the time fields are updated for each frame*/
+        c37118::DataFrameTemplate mTemplate;
 
       public:
-        void setData(const c37118::PmuDataFrame &data) { mStableData = data; }
+        void setData(const c37118::PmuDataFrame &data)
+        {
+            mStableData = data;
+            mTemplate.clear();
+        }
          virtual void loadConfig(const std::string &configStr) override;
 
+        virtual std::uint16_t
+          generateFrame(std::uint8_t *data, std::size_t dataSize, std::chrono::nanoseconds frame_time) override;
+
         virtual void loadDataFrame(const c37118::Config &dataConfig,
                                    c37118::PmuDataFrame &frame,
                                     std::chrono::nanoseconds current_time) override;
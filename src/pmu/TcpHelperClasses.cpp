@@ -36,8 +36,7 @@ namespace tcp {
                 receivingHalt.activate();
             }
             if (!triggerhalt) {
-                socket_.async_receive(asio::buffer(data.data() + residBufferSize,
-                                                   data.size() - residBufferSize),
+                socket_.async_receive(asio::buffer(data.data() + dataEnd, data.size() - dataEnd),
                                       [ptr = shared_from_this()](const std::error_code& err,
                                                                  size_t bytes) {
                                           ptr->handle_read(err, bytes);
@@ -86,6 +85,25 @@ namespace tcp {
         }
     }
 
+    void TcpConnection::processData(size_t bytes_transferred)
+    {
+        dataEnd += bytes_transferred;
+        auto used = dataCall(shared_from_this(), data.data() + dataStart, dataEnd - dataStart);
+        dataStart += (std::min)(used, dataEnd - dataStart);
+        if (dataStart == dataEnd) {
+            // everything was consumed so the next read starts at the front,  the old bytes are
+            // simply overwritten
+            dataStart = 0;
+            dataEnd = 0;
+        } else if (dataStart > 0 && (data.size() - dataEnd) < data.size() / 4) {
+            // the unconsumed bytes stay in place until the space after them runs low,  only then
+            // are they moved to the front
+            std::copy(data.begin() + dataStart, data.begin() + dataEnd, data.begin());
+            dataEnd -= dataStart;
+            dataStart = 0;
+        }
+    }
+
     void TcpConnection::handle_read(const std::error_code& error, size_t bytes_transferred)
     {
         if (triggerhalt.load(std::memory_order_acquire)) {
@@ -94,19 +112,7 @@ namespace tcp {
             return;
         }
         if (!error) {
-            auto used =
-                dataCall(shared_from_this(), data.data(), bytes_transferred + residBufferSize);
-            if (used < (bytes_transferred + residBufferSize)) {
-                if (used > 0) {
-                    std::copy(data.data() + used,
-                              data.data() + bytes_transferred + residBufferSize,
-                              data.data());
-                }
-                residBufferSize = bytes_transferred + residBufferSize - used;
-            } else {
-                residBufferSize = 0;
-                data.assign(data.size(), 0);
-            }
+            processData(bytes_transferred);
             state = connection_state_t::waiting;
             startReceive();
         } else if (error == asio::error::operation_aborted) {
@@ -116,18 +122,7 @@ namespace tcp {
         } else {
             // there was an error
             if (bytes_transferred > 0) {
-                auto used =
-                    dataCall(shared_from_this(), data.data(), bytes_transferred + residBufferSize);
-                if (used < (bytes_transferred + residBufferSize)) {
-                    if (used > 0) {
-                        std::copy(data.data() + used,
-                                  data.data() + bytes_transferred + residBufferSize,
-                                  data.data());
-                    }
-                    residBufferSize = bytes_transferred + residBufferSize - used;
-                } else {
-                    residBufferSize = 0;
-                }
+                processData(bytes_transferred);
             }
             if (errorCall) {
                 if (errorCall(shared_from_this(), error)) {
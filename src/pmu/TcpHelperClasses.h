@@ -146,6 +146,8 @@ namespace tcp {
                       size_t bufferSize);
         /** function for handling the asynchronous return from a read request*/
         void handle_read(const std::error_code& error, size_t bytes_transferred);
+        /** pass the unconsumed bytes of the buffer to the data callback after a read*/
+        void processData(size_t bytes_transferred);
         void handle_read(
             size_t message_size,
             const std::error_code& error,
@@ -157,7 +159,10 @@ namespace tcp {
         }
         static std::atomic<int> idcounter;
 
-        std::atomic<size_t> residBufferSize{0};
+        /** the bytes of data not yet consumed by the data callback are [dataStart, dataEnd),  reads
+        append at dataEnd;  only used by the receive loop*/
+        size_t dataStart{0};
+        size_t dataEnd{0};
         asio::ip::tcp::socket socket_;
         asio::io_context& context_;
         std::vector<char> data;
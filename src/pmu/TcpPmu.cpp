@@ -6,180 +6,588 @@ the top-level NOTICE for additional details. All rights reserved. SPDX-License-I
 
 #include "TcpPmu.hpp"
 
-#include "TcpHelperClasses.h"
+#include "FrameExtractor.hpp"
+#include "FrameLayout.hpp"
+#include "FrameTimeSequence.hpp"
 
-#include <asio/io_context.hpp>
 #include <asio/dispatch.hpp>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/post.hpp>
+#include <asio/steady_timer.hpp>
 #include <asio/strand.hpp>
+#include <asio/write.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
 #include <iostream>
+#include <mutex>
+#include <vector>
 
 using tcp = asio::ip::tcp;  // from <asio/ip/tcp.hpp>
 
-
 // LCOV_EXCL_START
 // Report a failure
 static void fail(asio::error_code ec, char const *what) { std::cerr << what << ": " << ec.message() << "\n"; }
 
 // LCOV_EXCL_STOP
-// 
 
-static constexpr std::size_t bufferSize = 63336 * 2;
+namespace pmu
+{
+/* an encoded frame shared by all the sessions sending it*/
+using SharedFrame = std::shared_ptr<const std::vector<std::uint8_t>>;
+
+/* commands are 18 bytes unless they carry extended data*/
+static constexpr std::size_t receive_buffer_size{4096U};
 
-// 
-class PmuSession : public std::enable_shared_from_this<PmuSession>
+template <class Generator>
+static SharedFrame encodeFrame(Generator generator)
 {
-    tcp::socket mSocket;
-    std::vector<std::uint8_t> mBuffer;
-    asio::steady_timer mTimer{mSocket.get_executor()};
+    auto frame = std::make_shared<std::vector<std::uint8_t>>(c37118::max_frame_size);
+    const auto size = generator(frame->data(), frame->size());
+    if (size == 0U)
+    {
+        return nullptr;
+    }
+    frame->resize(size);
+    return frame;
+}
 
+/* the frames sent in response to commands,  encoded once when the server is created*/
+class CommandFrames
+{
   public:
-    // Take ownership of the socket
-    explicit PmuSession(tcp::socket &&socket) : mSocket(std::move(socket)) 
-    { 
-        mBuffer.resize(bufferSize);
+    std::uint16_t idcode{0U};
+    SharedFrame header;
+    SharedFrame config1;
+    SharedFrame config2;
+};
+
+/* the send queue settings of the sessions*/
+class SendQueuePolicy
+{
+  public:
+    std::size_t queueLimit{default_send_queue_limit};
+    SlowClientPolicy policy{SlowClientPolicy::drop_oldest};
+    int sendBufferSize{0};
+};
+
+/* the slow client counters of all the sessions of a server*/
+class SendQueueCounters
+{
+  public:
+    std::atomic<std::uint64_t> droppedFrames{0U};
+    std::atomic<std::size_t> queueHighWater{0U};
+    std::atomic<std::uint64_t> slowDisconnects{0U};
+
+    void recordDepth(std::size_t depth)
+    {
+        auto current = queueHighWater.load();
+        while (depth > current && !queueHighWater.compare_exchange_weak(current, depth))
+        {
+        }
+    }
+};
+
+/* errors which only mean the client has gone or the session was closed*/
+static bool isDisconnect(const asio::error_code &ec)
+{
+    return ec == asio::error::eof || ec == asio::error::operation_aborted || ec == asio::error::connection_reset ||
+      ec == asio::error::broken_pipe;
+}
+
+static bool isDataFrame(const SharedFrame &frame)
+{
+    return c37118::getPacketType(frame->data(), frame->size()) == c37118::PmuPacketType::data;
+}
+
+/* a connection from a PDC,  all operations on the session run on the strand of its socket*/
+class PmuSession: public std::enable_shared_from_this<PmuSession>
+{
+  public:
+    PmuSession(tcp::socket &&socket,
+               std::shared_ptr<const CommandFrames> frames,
+               const SendQueuePolicy &policy,
+               std::shared_ptr<SendQueueCounters> counters):
+        mSocket(std::move(socket)),
+        mFrames(std::move(frames)), mPolicy(policy), mCounters(std::move(counters)), mBuffer(receive_buffer_size)
+    {
     }
 
-    // Get on the correct executor
     void run()
     {
-       
+        asio::dispatch(mSocket.get_executor(), [self = shared_from_this()]() { self->doRead(); });
+    }
+
+    /* queue a data frame for sending,  may be called from any thread*/
+    void deliver(const SharedFrame &frame)
+    {
+        asio::post(mSocket.get_executor(),
+                   [self = shared_from_this(), frame]() { self->queueFrame(frame, true); });
+    }
+
+    void close()
+    {
+        asio::post(mSocket.get_executor(), [self = shared_from_this()]() {
+            asio::error_code ec;
+            self->mSocket.close(ec);
+        });
     }
 
-    // Start the asynchronous operation
-    void on_run()
+    /* true if the client has turned data on*/
+    bool streaming() const { return mStreaming.load(); }
+
+  private:
+    void doRead()
     {
-        
+        mSocket.async_read_some(asio::buffer(mBuffer.data(), mBuffer.size()),
+                                [self = shared_from_this()](const asio::error_code &ec, std::size_t bytes) {
+                                    self->onRead(ec, bytes);
+                                });
     }
 
-    void on_accept(asio::error_code ec)
+    void onRead(const asio::error_code &ec, std::size_t bytes)
     {
         if (ec)
         {
-            return fail(ec, "helics websocket accept");
+            // the client closed the connection or the server is stopping
+            mStreaming = false;
+            if (!isDisconnect(ec))
+            {
+                fail(ec, "pmu session read");
+            }
+            return;
+        }
+        mExtractor.push(mBuffer.data(), bytes);
+        c37118::FrameSpan frame;
+        while (mExtractor.next(frame))
+        {
+            handleCommand(frame);
         }
+        doRead();
+    }
 
-        // Read a message
-        do_read();
+    void handleCommand(const c37118::FrameSpan &frame)
+    {
+        if (c37118::getPacketType(frame.data, frame.size) != c37118::PmuPacketType::command ||
+            c37118::getIdCode(frame.data, frame.size) != mFrames->idcode)
+        {
+            return;
+        }
+        switch (c37118::parseCommand(frame.data, frame.size))
+        {
+        case c37118::PmuCommand::data_off:
+            mStreaming = false;
+            break;
+        case c37118::PmuCommand::data_on:
+            mStreaming = true;
+            break;
+        case c37118::PmuCommand::send_header:
+            queueFrame(mFrames->header, false);
+            break;
+        case c37118::PmuCommand::send_config1:
+            queueFrame(mFrames->config1, false);
+            break;
+        case c37118::PmuCommand::send_config2:
+            queueFrame(mFrames->config2, false);
+            break;
+        default:
+            break;
+        }
     }
 
-    void do_read()
+    void queueFrame(const SharedFrame &frame, bool dataFrame)
     {
-        // Read a message into our buffer
-        mSocket.async_receive(asio::buffer(mBuffer.data(),mBuffer.size()), [this](asio::error_code ec, std::size_t bytes_transferred) {
-            on_read(ec, bytes_transferred);
-        });
+        if (!frame || (dataFrame && !mStreaming.load()) || !mSocket.is_open())
+        {
+            return;
+        }
+        if (dataFrame && mQueue.size() >= mPolicy.queueLimit && !makeRoom())
+        {
+            return;
+        }
+        mQueue.push_back(frame);
+        mCounters->recordDepth(mQueue.size());
+        if (mQueue.size() == 1U)
+        {
+            doWrite();
+        }
     }
 
-    void on_read(asio::error_code ec, std::size_t /* bytes_transferred*/)
+    /* apply the slow client policy to a full queue
+    @return true if the new frame should be queued*/
+    bool makeRoom()
     {
+        switch (mPolicy.policy)
+        {
+        case SlowClientPolicy::drop_oldest:
+        {
+            // the front frame is being written so the oldest frame which can be dropped follows it
+            auto oldest = std::find_if(mQueue.begin() + 1, mQueue.end(), isDataFrame);
+            ++mCounters->droppedFrames;
+            if (oldest == mQueue.end())
+            {
+                return false;
+            }
+            mQueue.erase(oldest);
+            return true;
+        }
+        case SlowClientPolicy::drop_newest:
+            ++mCounters->droppedFrames;
+            return false;
+        case SlowClientPolicy::disconnect:
+        default:
+        {
+            ++mCounters->slowDisconnects;
+            mStreaming = false;
+            // the pending write completes with an error and clears the queue
+            asio::error_code ec;
+            mSocket.close(ec);
+            return false;
+        }
+        }
+    }
 
-        mSocket.async_send(asio::buffer(mBuffer.data(),mBuffer.size()), [this](asio::error_code ec, std::size_t bytes_transferred) {
-            on_write(ec, bytes_transferred);
-        });
+    void doWrite()
+    {
+        const auto &frame = *mQueue.front();
+        asio::async_write(mSocket,
+                          asio::buffer(frame.data(), frame.size()),
+                          [self = shared_from_this()](const asio::error_code &ec, std::size_t bytes) {
+                              self->onWrite(ec, bytes);
+                          });
     }
 
-    void on_write(asio::error_code ec, std::size_t bytes_transferred)
+    void onWrite(const asio::error_code &ec, std::size_t /*bytes*/)
     {
-        
         if (ec)
         {
-            return fail(ec, "helics socket write");
+            mStreaming = false;
+            mQueue.clear();
+            if (!isDisconnect(ec))
+            {
+                fail(ec, "pmu session write");
+            }
+            asio::error_code closeError;
+            mSocket.close(closeError);
+            return;
+        }
+        mQueue.pop_front();
+        if (!mQueue.empty())
+        {
+            doWrite();
         }
-
-       
-        // Do another read
-        do_read();
     }
+
+    tcp::socket mSocket;
+    std::shared_ptr<const CommandFrames> mFrames;
+    const SendQueuePolicy mPolicy;
+    std::shared_ptr<SendQueueCounters> mCounters;
+    std::vector<std::uint8_t> mBuffer;  //!< the receive buffer for commands
+    c37118::FrameExtractor mExtractor;
+    std::deque<SharedFrame> mQueue;  //!< the frames to send,  the front frame is being written
+    std::atomic<bool> mStreaming{false};
 };
 
-// 
-// Accepts incoming connections and launches the sessions
-class Listener : public std::enable_shared_from_this<Listener>
+/* accepts connections and generates the data frames,  the acceptor and frame timer run on a single strand*/
+class PmuServer: public std::enable_shared_from_this<PmuServer>
 {
-    asio::io_context &ioc;
-    tcp::acceptor acceptor;
-    bool websocket{false};
-
   public:
-    Listener(asio::io_context &context, const tcp::endpoint &endpoint, bool webs = false)
-        : ioc(context), acceptor(asio::make_strand(ioc)), websocket{webs}
+    PmuServer(asio::io_context &context,
+              std::shared_ptr<Source> source,
+              const std::string &header,
+              const SendQueuePolicy &policy);
+
+    bool listen(const std::string &interface, const std::string &port);
+    /* start accepting connections and generating frames
+    @param startTime the steady clock time corresponding to the PMU clock time clockTime*/
+    void start(std::chrono::steady_clock::time_point startTime, std::chrono::nanoseconds clockTime);
+    void stop();
+
+    std::uint16_t getPort() const { return mPort; }
+    std::size_t sessionCount() const;
+    std::uint64_t framesEncoded() const { return mFramesEncoded.load(); }
+    const SendQueueCounters &counters() const { return *mCounters; }
+
+  private:
+    void doAccept();
+    void onAccept(const asio::error_code &ec, tcp::socket socket);
+    void scheduleFrame();
+    void onFrameTime(const asio::error_code &ec);
+    /* encode the current frame once and queue it on every streaming session*/
+    void sendFrame();
+
+    asio::io_context &mContext;
+    asio::strand<asio::io_context::executor_type> mStrand;
+    tcp::acceptor mAcceptor;
+    asio::steady_timer mTimer;
+    std::shared_ptr<Source> mSource;
+    std::shared_ptr<const CommandFrames> mFrames;
+    const SendQueuePolicy mPolicy;
+    std::shared_ptr<SendQueueCounters> mCounters;
+    c37118::FrameTimeSequence mSequence;
+    std::size_t mFrameSize{0U};
+    std::uint16_t mPort{0U};
+    std::chrono::steady_clock::time_point mStartTime;
+    std::chrono::nanoseconds mClockTime{0};
+
+    mutable std::mutex mSessionLock;  //!< protects mSessions
+    std::vector<std::weak_ptr<PmuSession>> mSessions;
+    std::vector<std::shared_ptr<PmuSession>> mStreaming;  //!< the sessions receiving the current frame
+    std::atomic<bool> mRunning{false};
+    std::atomic<std::uint64_t> mFramesEncoded{0U};
+};
+
+PmuServer::PmuServer(asio::io_context &context,
+                     std::shared_ptr<Source> source,
+                     const std::string &header,
+                     const SendQueuePolicy &policy):
+    mContext(context),
+    mStrand(asio::make_strand(context)), mAcceptor(mStrand), mTimer(mStrand), mSource(std::move(source)),
+    mPolicy(policy), mCounters(std::make_shared<SendQueueCounters>()), mSequence(mSource->getConfig())
+{
+    const auto &config = mSource->getConfig();
+    auto frames = std::make_shared<CommandFrames>();
+    frames->idcode = config.idcode;
+    frames->header = encodeFrame([&header, &config](std::uint8_t *data, std::size_t size) {
+        return c37118::generateHeader(data, size, header, config);
+    });
+    frames->config1 = encodeFrame(
+      [&config](std::uint8_t *data, std::size_t size) { return c37118::generateConfig1(data, size, config); });
+    frames->config2 = encodeFrame(
+      [&config](std::uint8_t *data, std::size_t size) { return c37118::generateConfig2(data, size, config); });
+    mFrames = std::move(frames);
+
+    std::shared_ptr<const c37118::FrameLayout> layout;
+    mFrameSize = c37118::getFrameLayout(config, layout).frameSize;
+}
+
+bool PmuServer::listen(const std::string &interface, const std::string &port)
+{
+    asio::error_code ec;
+    tcp::resolver resolver(mContext);
+    auto endpoints = resolver.resolve(interface, port, tcp::resolver::passive, ec);
+    if (ec || endpoints.empty())
     {
-        asio::error_code ec;
+        fail(ec, "pmu server resolve");
+        return false;
+    }
+    const tcp::endpoint endpoint = *endpoints.begin();
 
-        // Open the acceptor
-        acceptor.open(endpoint.protocol(), ec);
-        if (ec)
-        {
-            fail(ec, "helics acceptor open");
-            return;
-        }
+    mAcceptor.open(endpoint.protocol(), ec);
+    if (ec)
+    {
+        fail(ec, "pmu server acceptor open");
+        return false;
+    }
+    mAcceptor.set_option(asio::socket_base::reuse_address(true), ec);
+    if (ec)
+    {
+        fail(ec, "pmu server acceptor set_option");
+        return false;
+    }
+    mAcceptor.bind(endpoint, ec);
+    if (ec)
+    {
+        fail(ec, "pmu server acceptor bind");
+        return false;
+    }
+    mAcceptor.listen(asio::socket_base::max_listen_connections, ec);
+    if (ec)
+    {
+        fail(ec, "pmu server acceptor listen");
+        return false;
+    }
+    mPort = mAcceptor.local_endpoint(ec).port();
+    return true;
+}
 
-        // Allow address reuse
-        acceptor.set_option(asio::socket_base::reuse_address(true), ec);
-        if (ec)
+void PmuServer::start(std::chrono::steady_clock::time_point startTime, std::chrono::nanoseconds clockTime)
+{
+    mStartTime = startTime;
+    mClockTime = clockTime;
+    mRunning = true;
+    asio::dispatch(mStrand, [self = shared_from_this()]() {
+        self->mSequence.start(self->mClockTime);
+        self->doAccept();
+        self->scheduleFrame();
+    });
+}
+
+void PmuServer::stop()
+{
+    mRunning = false;
+    asio::post(mStrand, [self = shared_from_this()]() {
+        asio::error_code ec;
+        self->mAcceptor.close(ec);
+        self->mTimer.cancel();
+    });
+    std::lock_guard<std::mutex> lock(mSessionLock);
+    for (const auto &weak : mSessions)
+    {
+        if (auto session = weak.lock())
         {
-            fail(ec, "helics acceptor set_option");
-            return;
+            session->close();
         }
+    }
+    mSessions.clear();
+}
 
-        // Bind to the server address
-        acceptor.bind(endpoint, ec);
-        if (ec)
+std::size_t PmuServer::sessionCount() const
+{
+    std::lock_guard<std::mutex> lock(mSessionLock);
+    return static_cast<std::size_t>(std::count_if(
+      mSessions.begin(), mSessions.end(), [](const std::weak_ptr<PmuSession> &weak) { return !weak.expired(); }));
+}
+
+void PmuServer::doAccept()
+{
+    mAcceptor.async_accept(asio::make_strand(mContext),
+                           [self = shared_from_this()](const asio::error_code &ec, tcp::socket peer) {
+                               self->onAccept(ec, std::move(peer));
+                           });
+}
+
+void PmuServer::onAccept(const asio::error_code &ec, tcp::socket socket)
+{
+    if (!mRunning.load())
+    {
+        return;
+    }
+    if (ec)
+    {
+        fail(ec, "pmu server accept connections");
+    }
+    else
+    {
+        // data frames are small and time sensitive
+        asio::error_code optionError;
+        socket.set_option(tcp::no_delay(true), optionError);
+        if (mPolicy.sendBufferSize > 0)
         {
-            fail(ec, "helics acceptor bind");
-            return;
+            socket.set_option(asio::socket_base::send_buffer_size(mPolicy.sendBufferSize), optionError);
         }
-
-        // Start listening for connections
-        acceptor.listen(asio::socket_base::max_listen_connections, ec);
-        if (ec)
+        auto session = std::make_shared<PmuSession>(std::move(socket), mFrames, mPolicy, mCounters);
         {
-            fail(ec, "helics acceptor listen");
-            return;
+            std::lock_guard<std::mutex> lock(mSessionLock);
+            mSessions.erase(std::remove_if(mSessions.begin(),
+                                           mSessions.end(),
+                                           [](const std::weak_ptr<PmuSession> &weak) { return weak.expired(); }),
+                            mSessions.end());
+            mSessions.push_back(session);
         }
+        session->run();
     }
+    // Accept another connection
+    doAccept();
+}
 
-    // Start accepting incoming connections
-    void run() { do_accept(); }
+void PmuServer::scheduleFrame()
+{
+    mTimer.expires_at(mStartTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                     mSequence.currentTime() - mClockTime));
+    mTimer.async_wait([self = shared_from_this()](const asio::error_code &ec) { self->onFrameTime(ec); });
+}
 
-  private:
-    void do_accept()
+void PmuServer::onFrameTime(const asio::error_code &ec)
+{
+    if (ec || !mRunning.load())
     {
-        acceptor.async_accept(asio::make_strand(ioc),
-                               [this](const asio::error_code &error, tcp::socket peer) {
-                                   on_accept(error, std::move(peer));
-                               });
+        return;
     }
+    sendFrame();
+    mSequence.advance();
+    const auto now = std::chrono::steady_clock::now();
+    if (now - mTimer.expiry() > std::chrono::seconds(1))
+    {
+        // skip the missed frames instead of sending a burst if the server fell far behind
+        mSequence.start(mClockTime + std::chrono::duration_cast<std::chrono::nanoseconds>(now - mStartTime));
+    }
+    scheduleFrame();
+}
 
-    void on_accept(asio::error_code ec, tcp::socket socket)
+void PmuServer::sendFrame()
+{
     {
-        if (ec)
+        std::lock_guard<std::mutex> lock(mSessionLock);
+        for (const auto &weak : mSessions)
         {
-            return fail(ec, "helics accept connections");
+            auto session = weak.lock();
+            if (session && session->streaming())
+            {
+                mStreaming.push_back(std::move(session));
+            }
         }
-        else
+    }
+    if (mStreaming.empty())
+    {
+        return;
+    }
+    // the time of the FRACSEC count itself so the encoded frame carries exactly the count of the sequence
+    const auto code = mSequence.current();
+    const auto frameTime = c37118::toNanoseconds(code.soc, code.ticks, mSource->getConfig().timeBase);
+    auto frame = std::make_shared<std::vector<std::uint8_t>>(mFrameSize);
+    const auto size = mSource->generateFrame(frame->data(), frame->size(), frameTime);
+    if (size > 0U)
+    {
+        frame->resize(size);
+        ++mFramesEncoded;
+        const SharedFrame shared{std::move(frame)};
+        for (const auto &session : mStreaming)
         {
-            // Create the session and run it
-            std::make_shared<PmuSession>(std::move(socket))->run();
-            
+            session->deliver(shared);
         }
+    }
+    mStreaming.clear();
+}
 
-        // Accept another connection
-        do_accept();
+TcpPmu::~TcpPmu() { stopServer(); }
+
+bool TcpPmu::startServer(asio::io_context &io_context)
+{
+    stopServer();
+    if (!mSource)
+    {
+        return false;
     }
-};
+    SendQueuePolicy policy;
+    policy.queueLimit = sendQueueLimit;
+    policy.policy = slowClientPolicy;
+    policy.sendBufferSize = sendBufferSize;
+    auto server = std::make_shared<PmuServer>(io_context, mSource, header, policy);
+    if (!server->listen(interface, port))
+    {
+        return false;
+    }
+    start();
+    server->start(start_time, clock_time);
+    mServer = std::move(server);
+    return true;
+}
 
-namespace pmu
+void TcpPmu::stopServer()
 {
+    if (mServer)
+    {
+        mServer->stop();
+        mServer.reset();
+    }
+}
+
+std::uint16_t TcpPmu::getPort() const { return mServer ? mServer->getPort() : 0U; }
+
+std::size_t TcpPmu::sessionCount() const { return mServer ? mServer->sessionCount() : 0U; }
 
-	void TcpPmu::startServer(asio::io_context &io_context)
+std::uint64_t TcpPmu::framesEncoded() const { return mServer ? mServer->framesEncoded() : 0U; }
+
+std::uint64_t TcpPmu::droppedFrames() const { return mServer ? mServer->counters().droppedFrames.load() : 0U; }
+
+std::size_t TcpPmu::queueHighWater() const { return mServer ? mServer->counters().queueHighWater.load() : 0U; }
+
+std::uint64_t TcpPmu::slowClientDisconnects() const
 {
-		connection = helics::tcp::TcpConnection::create(io_context, interface, port, 65536);
-		connection->waitUntilConnected(std::chrono::milliseconds(4000));
-		buffer.resize(65536);
-        return;
-	}
+    return mServer ? mServer->counters().slowDisconnects.load() : 0U;
+}
 
-    
-    }
\ No newline at end of file
+}  // namespace pmu
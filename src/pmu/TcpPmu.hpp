@@ -4,26 +4,87 @@ Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance
 the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
 */
 #pragma once
-#include "TcpHelperClasses.h"
+#include <cstdint>
 #include <memory>
+#include <string>
 #include "Pmu.hpp"
 
 namespace pmu
 {
+class PmuServer;
 
+/** the action taken when a data frame is generated for a client whose send queue is full*/
+enum class SlowClientPolicy : std::uint8_t
+{
+    drop_oldest = 0,  //!< discard the oldest data frame waiting to be sent
+    drop_newest = 1,  //!< discard the new data frame
+    disconnect = 2  //!< close the connection to the client
+};
+
+/** the default number of frames which may be queued on a client session*/
+static constexpr std::size_t default_send_queue_limit{64U};
 
-	class TcpPmu: public Pmu
+/** a PMU serving C37.118 frames to any number of PDC clients over TCP
+@details each client session handles the data on/off and header/configuration commands addressed to the PMU
+idcode.  Data frames are generated at the configured data rate and encoded once into a reference counted buffer
+which is queued on every session that has turned data on,  so the cost of encoding does not depend on the number of
+clients
+*/
+class TcpPmu: public Pmu
 {
-      protected:
-        std::string interface;
-        std::string port{"4712"};
+  protected:
+    std::string interface;
+    std::string port{"4712"};
+    std::string header;  //!< the text of the header frame
+    std::size_t sendQueueLimit{default_send_queue_limit};  //!< the maximum frames queued on a session
+    SlowClientPolicy slowClientPolicy{SlowClientPolicy::drop_oldest};
+    int sendBufferSize{0};  //!< the socket send buffer size of the sessions or 0 for the system default
+
+  private:
+    std::shared_ptr<PmuServer> mServer;
+
+  public:
+    using Pmu::Pmu;
+    ~TcpPmu() override;
 
-      private:
-        helics::tcp::TcpConnection::pointer connection;
+    /** set the address and port to listen on,  an empty interface listens on all interfaces and port "0" selects an
+     * unused port*/
+    void setInterface(const std::string &newInterface, const std::string &newPort)
+    {
+        interface = newInterface;
+        port = newPort;
+    }
+    void setHeader(const std::string &headerText) { header = headerText; }
+    /** set the number of frames which may be queued on each client session and the action taken when a session
+    queue is full
+    @details the limit includes the frame being written so it is at least 2,  the settings apply to servers started
+    after the call*/
+    void setSendQueue(std::size_t queueLimit, SlowClientPolicy policy)
+    {
+        sendQueueLimit = (queueLimit < 2U) ? 2U : queueLimit;
+        slowClientPolicy = policy;
+    }
+    /** set the socket send buffer size of the client sessions,  a smaller buffer makes slow clients visible in the
+     * session queues sooner*/
+    void setSendBufferSize(int bufferSize) { sendBufferSize = bufferSize; }
 
-        std::vector<std::uint8_t> buffer;
+    /** start accepting connections and streaming data frames to the sessions that request them
+    @return true if the server is listening*/
+    bool startServer(asio::io_context &io_context);
+    /** close the listener and all the sessions*/
+    void stopServer();
 
-      public:
-       void startServer(asio::io_context &io_context);
-	};
-}
+    /** get the port the server is listening on or 0 if the server is not running*/
+    std::uint16_t getPort() const;
+    /** get the number of open client sessions*/
+    std::size_t sessionCount() const;
+    /** get the number of data frames encoded since the server was started*/
+    std::uint64_t framesEncoded() const;
+    /** get the number of data frames discarded from full session queues since the server was started*/
+    std::uint64_t droppedFrames() const;
+    /** get the largest number of frames queued on any session since the server was started*/
+    std::size_t queueHighWater() const;
+    /** get the number of sessions closed by the disconnect policy since the server was started*/
+    std::uint64_t slowClientDisconnects() const;
+};
+}  // namespace pmu
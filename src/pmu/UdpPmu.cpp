@@ -0,0 +1,416 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "UdpPmu.hpp"
+
+#include "DatagramBatch.hpp"
+#include "FrameExtractor.hpp"
+#include "FrameLayout.hpp"
+#include "FrameTimeSequence.hpp"
+
+#include <asio/dispatch.hpp>
+#include <asio/io_context.hpp>
+#include <asio/ip/multicast.hpp>
+#include <asio/ip/udp.hpp>
+#include <asio/post.hpp>
+#include <asio/steady_timer.hpp>
+#include <asio/strand.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+using udp = asio::ip::udp;  // from <asio/ip/udp.hpp>
+
+// LCOV_EXCL_START
+// Report a failure
+static void fail(asio::error_code ec, char const *what) { std::cerr << what << ": " << ec.message() << "\n"; }
+
+// LCOV_EXCL_STOP
+
+namespace pmu
+{
+/* the most frames sent in one tick when the server has fallen behind*/
+static constexpr std::size_t max_frames_per_tick{8U};
+/* the most destinations,  data on commands from new senders are ignored beyond this when command destinations are
+ * enabled*/
+static constexpr std::size_t max_destinations{1024U};
+
+/* sends the frames of a PMU to the destinations and answers commands,  the socket and frame timer run on a single
+ * strand*/
+class UdpServer: public std::enable_shared_from_this<UdpServer>
+{
+  public:
+    UdpServer(asio::io_context &context, std::shared_ptr<Source> source, const std::string &header);
+
+    bool open(const std::string &interface, const std::string &port, int multicastTtl);
+    bool addDestination(const std::string &address, const std::string &port);
+    /* allow data on commands from new senders to add them as destinations*/
+    void setCommandDestinations(bool enable) { mCommandDestinations = enable; }
+    /* start sending frames
+    @param startTime the steady clock time corresponding to the PMU clock time clockTime*/
+    void start(std::chrono::steady_clock::time_point startTime, std::chrono::nanoseconds clockTime);
+    void stop();
+
+    std::uint16_t getPort() const { return mPort; }
+    std::uint64_t framesEncoded() const { return mFramesEncoded.load(); }
+    std::uint64_t datagramsSent() const { return mDatagramsSent.load(); }
+    std::uint64_t sendCalls() const { return mSendCalls.load(); }
+    std::uint64_t sendErrors() const { return mSendErrors.load(); }
+
+  private:
+    class Destination
+    {
+      public:
+        udp::endpoint endpoint;
+        bool active{true};
+    };
+
+    void doReceive();
+    void onReceive(const asio::error_code &ec, std::size_t bytes);
+    void handleCommand(const c37118::FrameSpan &frame);
+    void scheduleFrame();
+    void onFrameTime(const asio::error_code &ec);
+    /* encode the frame at the current position of the sequence once and add it to the batch for each active
+     * destination*/
+    void addFrame(std::vector<std::uint8_t> &buffer);
+    void sendBatch();
+    std::chrono::steady_clock::time_point steadyTime(std::chrono::nanoseconds frameTime) const
+    {
+        return mStartTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(frameTime - mClockTime);
+    }
+
+    asio::io_context &mContext;
+    asio::strand<asio::io_context::executor_type> mStrand;
+    udp::socket mSocket;
+    asio::steady_timer mTimer;
+    std::shared_ptr<Source> mSource;
+    c37118::FrameTimeSequence mSequence;
+    std::vector<std::uint8_t> mHeader;
+    std::vector<std::uint8_t> mConfig1;
+    std::vector<std::uint8_t> mConfig2;
+    std::vector<Destination> mDestinations;
+    std::vector<std::vector<std::uint8_t>> mFrames;  //!< the reused buffers of the frames of a tick
+    DatagramBatch mBatch;
+    std::vector<std::uint8_t> mReceiveBuffer;
+    udp::endpoint mSender;
+    c37118::FrameExtractor mExtractor;
+    std::size_t mFrameSize{0U};
+    std::uint16_t mPort{0U};
+    bool mCommandDestinations{false};
+    std::chrono::steady_clock::time_point mStartTime;
+    std::chrono::nanoseconds mClockTime{0};
+
+    std::atomic<bool> mRunning{false};
+    std::atomic<std::uint64_t> mFramesEncoded{0U};
+    std::atomic<std::uint64_t> mDatagramsSent{0U};
+    std::atomic<std::uint64_t> mSendCalls{0U};
+    std::atomic<std::uint64_t> mSendErrors{0U};
+};
+
+template <class Generator>
+static std::vector<std::uint8_t> encodeFrame(Generator generator)
+{
+    std::vector<std::uint8_t> frame(c37118::max_frame_size);
+    frame.resize(generator(frame.data(), frame.size()));
+    return frame;
+}
+
+UdpServer::UdpServer(asio::io_context &context, std::shared_ptr<Source> source, const std::string &header):
+    mContext(context), mStrand(asio::make_strand(context)), mSocket(mStrand), mTimer(mStrand),
+    mSource(std::move(source)), mSequence(mSource->getConfig()), mReceiveBuffer(c37118::max_frame_size)
+{
+    const auto &config = mSource->getConfig();
+    mHeader = encodeFrame([&header, &config](std::uint8_t *data, std::size_t size) {
+        return c37118::generateHeader(data, size, header, config);
+    });
+    mConfig1 = encodeFrame(
+      [&config](std::uint8_t *data, std::size_t size) { return c37118::generateConfig1(data, size, config); });
+    mConfig2 = encodeFrame(
+      [&config](std::uint8_t *data, std::size_t size) { return c37118::generateConfig2(data, size, config); });
+
+    std::shared_ptr<const c37118::FrameLayout> layout;
+    mFrameSize = c37118::getFrameLayout(config, layout).frameSize;
+    mFrames.resize(max_frames_per_tick);
+    for (auto &frame : mFrames)
+    {
+        frame.reserve(mFrameSize);
+    }
+}
+
+bool UdpServer::open(const std::string &interface, const std::string &port, int multicastTtl)
+{
+    asio::error_code ec;
+    udp::resolver resolver(mContext);
+    auto endpoints = resolver.resolve(interface, port, udp::resolver::passive, ec);
+    if (ec || endpoints.empty())
+    {
+        fail(ec, "pmu udp resolve");
+        return false;
+    }
+    const udp::endpoint endpoint = *endpoints.begin();
+
+    mSocket.open(endpoint.protocol(), ec);
+    if (ec)
+    {
+        fail(ec, "pmu udp socket open");
+        return false;
+    }
+    mSocket.set_option(asio::socket_base::reuse_address(true), ec);
+    mSocket.bind(endpoint, ec);
+    if (ec)
+    {
+        fail(ec, "pmu udp socket bind");
+        return false;
+    }
+    // sends never block the strand,  datagrams which do not fit in the socket buffer are counted as errors
+    mSocket.non_blocking(true, ec);
+    mSocket.set_option(asio::ip::multicast::hops(multicastTtl), ec);
+    mSocket.set_option(asio::ip::multicast::enable_loopback(true), ec);
+    if (endpoint.address().is_v4() && !endpoint.address().is_unspecified())
+    {
+        mSocket.set_option(asio::ip::multicast::outbound_interface(endpoint.address().to_v4()), ec);
+        if (ec)
+        {
+            fail(ec, "pmu udp multicast interface");
+        }
+    }
+    mPort = mSocket.local_endpoint(ec).port();
+    return true;
+}
+
+bool UdpServer::addDestination(const std::string &address, const std::string &port)
+{
+    asio::error_code ec;
+    udp::resolver resolver(mContext);
+    auto endpoints = resolver.resolve(mSocket.local_endpoint(ec).protocol(), address, port, ec);
+    if (ec || endpoints.empty())
+    {
+        fail(ec, "pmu udp destination");
+        return false;
+    }
+    mDestinations.push_back({*endpoints.begin(), true});
+    return true;
+}
+
+void UdpServer::start(std::chrono::steady_clock::time_point startTime, std::chrono::nanoseconds clockTime)
+{
+    mStartTime = startTime;
+    mClockTime = clockTime;
+    mRunning = true;
+    asio::dispatch(mStrand, [self = shared_from_this()]() {
+        self->mSequence.start(self->mClockTime);
+        self->doReceive();
+        self->scheduleFrame();
+    });
+}
+
+void UdpServer::stop()
+{
+    mRunning = false;
+    asio::post(mStrand, [self = shared_from_this()]() {
+        asio::error_code ec;
+        self->mSocket.close(ec);
+        self->mTimer.cancel();
+    });
+}
+
+void UdpServer::doReceive()
+{
+    mSocket.async_receive_from(asio::buffer(mReceiveBuffer.data(), mReceiveBuffer.size()),
+                               mSender,
+                               [self = shared_from_this()](const asio::error_code &ec, std::size_t bytes) {
+                                   self->onReceive(ec, bytes);
+                               });
+}
+
+void UdpServer::onReceive(const asio::error_code &ec, std::size_t bytes)
+{
+    if (!mRunning.load() || ec == asio::error::operation_aborted)
+    {
+        return;
+    }
+    if (ec)
+    {
+        fail(ec, "pmu udp receive");
+    }
+    else
+    {
+        mExtractor.push(mReceiveBuffer.data(), bytes);
+        c37118::FrameSpan frame;
+        while (mExtractor.next(frame))
+        {
+            handleCommand(frame);
+        }
+        // commands do not span datagrams
+        mExtractor.flush();
+    }
+    doReceive();
+}
+
+void UdpServer::handleCommand(const c37118::FrameSpan &frame)
+{
+    if (c37118::getPacketType(frame.data, frame.size) != c37118::PmuPacketType::command ||
+        c37118::getIdCode(frame.data, frame.size) != mSource->getConfig().idcode)
+    {
+        return;
+    }
+    auto destination = std::find_if(mDestinations.begin(), mDestinations.end(), [this](const Destination &dest) {
+        return dest.endpoint == mSender;
+    });
+    switch (c37118::parseCommand(frame.data, frame.size))
+    {
+    case c37118::PmuCommand::data_off:
+        if (destination != mDestinations.end())
+        {
+            destination->active = false;
+        }
+        break;
+    case c37118::PmuCommand::data_on:
+        if (destination != mDestinations.end())
+        {
+            destination->active = true;
+        }
+        else if (mCommandDestinations && mDestinations.size() < max_destinations)
+        {
+            mDestinations.push_back({mSender, true});
+        }
+        break;
+    case c37118::PmuCommand::send_header:
+        mBatch.add(mHeader, mSender);
+        break;
+    case c37118::PmuCommand::send_config1:
+        mBatch.add(mConfig1, mSender);
+        break;
+    case c37118::PmuCommand::send_config2:
+        mBatch.add(mConfig2, mSender);
+        break;
+    default:
+        break;
+    }
+    sendBatch();
+}
+
+void UdpServer::scheduleFrame()
+{
+    mTimer.expires_at(steadyTime(mSequence.currentTime()));
+    mTimer.async_wait([self = shared_from_this()](const asio::error_code &ec) { self->onFrameTime(ec); });
+}
+
+void UdpServer::onFrameTime(const asio::error_code &ec)
+{
+    if (ec || !mRunning.load())
+    {
+        return;
+    }
+    // every frame which is due goes into the batch so a late tick costs one send call
+    const auto now = std::chrono::steady_clock::now();
+    std::size_t count{0U};
+    do
+    {
+        addFrame(mFrames[count]);
+        mSequence.advance();
+        ++count;
+    } while (count < max_frames_per_tick && steadyTime(mSequence.currentTime()) <= now);
+    sendBatch();
+    if (now - steadyTime(mSequence.currentTime()) > std::chrono::seconds(1))
+    {
+        // skip the missed frames instead of sending a burst if the server fell far behind
+        mSequence.start(mClockTime + std::chrono::duration_cast<std::chrono::nanoseconds>(now - mStartTime));
+    }
+    scheduleFrame();
+}
+
+void UdpServer::addFrame(std::vector<std::uint8_t> &buffer)
+{
+    if (std::none_of(mDestinations.begin(), mDestinations.end(), [](const Destination &dest) {
+            return dest.active;
+        }))
+    {
+        return;
+    }
+    // the time of the FRACSEC count itself so the encoded frame carries exactly the count of the sequence
+    const auto code = mSequence.current();
+    const auto frameTime = c37118::toNanoseconds(code.soc, code.ticks, mSource->getConfig().timeBase);
+    buffer.resize(mFrameSize);
+    buffer.resize(mSource->generateFrame(buffer.data(), buffer.size(), frameTime));
+    if (buffer.empty())
+    {
+        return;
+    }
+    ++mFramesEncoded;
+    for (const auto &dest : mDestinations)
+    {
+        if (dest.active)
+        {
+            mBatch.add(buffer, dest.endpoint);
+        }
+    }
+}
+
+void UdpServer::sendBatch()
+{
+    if (mBatch.empty())
+    {
+        return;
+    }
+    const auto total = mBatch.size();
+    std::uint64_t calls{0U};
+    const auto sent = mBatch.send(mSocket, calls);
+    mSendCalls += calls;
+    mDatagramsSent += sent;
+    mSendErrors += total - sent;
+}
+
+UdpPmu::~UdpPmu() { stopServer(); }
+
+bool UdpPmu::startServer(asio::io_context &io_context)
+{
+    stopServer();
+    if (!mSource)
+    {
+        return false;
+    }
+    auto server = std::make_shared<UdpServer>(io_context, mSource, header);
+    if (!server->open(interface, port, multicastTtl))
+    {
+        return false;
+    }
+    for (const auto &destination : destinations)
+    {
+        if (!server->addDestination(destination.first, destination.second))
+        {
+            return false;
+        }
+    }
+    server->setCommandDestinations(commandDestinations);
+    start();
+    server->start(start_time, clock_time);
+    mServer = std::move(server);
+    return true;
+}
+
+void UdpPmu::stopServer()
+{
+    if (mServer)
+    {
+        mServer->stop();
+        mServer.reset();
+    }
+}
+
+std::uint16_t UdpPmu::getPort() const { return mServer ? mServer->getPort() : 0U; }
+
+std::uint64_t UdpPmu::framesEncoded() const { return mServer ? mServer->framesEncoded() : 0U; }
+
+std::uint64_t UdpPmu::datagramsSent() const { return mServer ? mServer->datagramsSent() : 0U; }
+
+std::uint64_t UdpPmu::sendCalls() const { return mServer ? mServer->sendCalls() : 0U; }
+
+std::uint64_t UdpPmu::sendErrors() const { return mServer ? mServer->sendErrors() : 0U; }
+
+}  // namespace pmu
@@ -0,0 +1,79 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Pmu.hpp"
+
+namespace pmu
+{
+class UdpServer;
+
+/** a PMU sending C37.118 data frames as UDP datagrams to unicast and multicast destinations
+@details data frames are generated at the configured data rate and encoded once for all destinations.  All the
+datagrams due in a tick,  for every destination and for any frames that fell behind,  are sent with a single sendmmsg
+call where it is available.  Commands received on the socket are answered to the sender,  data off and data on
+commands from a destination stop and resume sending to it.  Commands are not authenticated so a data on command from
+an address which is not a destination is ignored unless command destinations are enabled.
+*/
+class UdpPmu: public Pmu
+{
+  protected:
+    std::string interface;  //!< the local address,  also the outgoing interface for multicast if set
+    std::string port{"4713"};
+    std::string header;  //!< the text of the header frame
+    int multicastTtl{1};  //!< the hop limit of multicast datagrams
+    bool commandDestinations{false};  //!< a data on command from any address adds it as a destination
+    std::vector<std::pair<std::string, std::string>> destinations;  //!< the address and port of each destination
+
+  private:
+    std::shared_ptr<UdpServer> mServer;
+
+  public:
+    using Pmu::Pmu;
+    ~UdpPmu() override;
+
+    /** set the local address and port,  an empty interface binds to all interfaces and port "0" selects an unused
+     * port*/
+    void setInterface(const std::string &newInterface, const std::string &newPort)
+    {
+        interface = newInterface;
+        port = newPort;
+    }
+    void setHeader(const std::string &headerText) { header = headerText; }
+    void setMulticastTtl(int ttl) { multicastTtl = ttl; }
+    /** allow a data on command from an address which is not a destination to add it as a destination
+    @details the sender address of a datagram is not verified,  so this lets anyone direct the data stream at an
+    arbitrary address and should only be enabled on trusted networks*/
+    void setCommandDestinations(bool enable) { commandDestinations = enable; }
+    /** add a unicast or multicast destination for the data frames,  destinations apply to servers started after
+     * the call*/
+    void addDestination(const std::string &address, const std::string &destinationPort)
+    {
+        destinations.emplace_back(address, destinationPort);
+    }
+
+    /** open the socket and start sending data frames to the destinations
+    @return true if the socket is open and all the destinations were resolved*/
+    bool startServer(asio::io_context &io_context);
+    /** close the socket and stop sending*/
+    void stopServer();
+
+    /** get the local port of the socket or 0 if the server is not running*/
+    std::uint16_t getPort() const;
+    /** get the number of data frames encoded since the server was started*/
+    std::uint64_t framesEncoded() const;
+    /** get the number of datagrams sent since the server was started*/
+    std::uint64_t datagramsSent() const;
+    /** get the number of send system calls since the server was started*/
+    std::uint64_t sendCalls() const;
+    /** get the number of datagrams which could not be sent since the server was started*/
+    std::uint64_t sendErrors() const;
+};
+}  // namespace pmu
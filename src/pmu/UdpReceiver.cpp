@@ -0,0 +1,693 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "UdpReceiver.hpp"
+
+#include <asio/dispatch.hpp>
+#include <asio/executor_work_guard.hpp>
+#include <asio/ip/udp.hpp>
+#include <asio/post.hpp>
+#include <asio/strand.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+#ifdef __linux__
+#    include <cerrno>
+#    include <ctime>
+#    include <linux/filter.h>
+#    include <sys/socket.h>
+#endif
+
+using udp = asio::ip::udp;  // from <asio/ip/udp.hpp>
+
+// LCOV_EXCL_START
+// Report a failure
+static void fail(asio::error_code ec, char const *what) { std::cerr << what << ": " << ec.message() << "\n"; }
+
+// LCOV_EXCL_STOP
+
+namespace pmu
+{
+/* the most datagrams received in one system call*/
+static constexpr std::size_t receive_batch_size{32U};
+/* the most batches received before returning to the io_context so other handlers get a turn*/
+static constexpr std::size_t max_batches_per_wait{16U};
+/* the largest datagram,  which is also the largest frame*/
+static constexpr std::size_t max_datagram_size{c37118::max_frame_size};
+/* marks an idcode without a stream in the routing table*/
+static constexpr std::uint32_t no_stream{std::numeric_limits<std::uint32_t>::max()};
+
+/* the function a listener calls for each frame,  with the configuration of the stream which may be retained after
+ * the call*/
+using ListenerCall =
+  std::function<void(const ReceivedFrame &frame, const std::shared_ptr<const c37118::Config> &config)>;
+
+/* receives the datagrams of a UdpReceiver and routes the frames to the stream configurations,  the socket runs on a
+ * strand and all the state except the counters is only touched there*/
+class UdpListener: public std::enable_shared_from_this<UdpListener>
+{
+  public:
+    UdpListener(asio::io_context &context, ListenerCall frameCall, bool learn, std::size_t shard = 0U);
+
+    /* open the socket
+    @param reusePort join the SO_REUSEPORT group of sockets bound to the same port*/
+    bool open(const std::string &interface, const std::string &port, int receiveBufferSize, bool reusePort = false);
+    /* make the kernel deliver each datagram to the socket of the SO_REUSEPORT group with index IDCODE % shardCount
+    @return false if the platform does not support steering,  datagrams are then distributed by address*/
+    bool steerByIdcode(std::size_t shardCount);
+    void addStream(const c37118::Config &config);
+    void start();
+    void stop();
+
+    std::uint16_t getPort() const { return mPort; }
+    std::uint64_t datagramsReceived() const { return mDatagrams.load(); }
+    std::uint64_t framesReceived() const { return mFrames.load(); }
+    std::uint64_t receiveCalls() const { return mReceiveCalls.load(); }
+    std::uint64_t unknownFrames() const { return mUnknownFrames.load(); }
+
+  private:
+    void doWait();
+    void onReadable(const asio::error_code &ec);
+    /* receive one batch of datagrams
+    @return the number of datagrams received,  0 when the socket has been drained*/
+    std::size_t receiveBatch();
+    void handleDatagram(const std::uint8_t *data, std::size_t size, std::chrono::nanoseconds receiveTime);
+    void handleFrame(const c37118::FrameSpan &frame, std::chrono::nanoseconds receiveTime);
+
+    asio::io_context &mContext;
+    asio::strand<asio::io_context::executor_type> mStrand;
+    udp::socket mSocket;
+    ListenerCall mFrameCall;
+    std::vector<std::shared_ptr<const c37118::Config>> mStreams;
+    std::vector<std::uint32_t> mStreamIndex;  //!< the index in mStreams of each idcode or no_stream
+    std::shared_ptr<const c37118::Config> mNoStream;  //!< passed with the frames of unknown idcodes
+    c37118::FrameExtractor mExtractor;
+    c37118::Config mLearned;  //!< the target of config2 parsing,  reused to keep its allocations
+    std::vector<std::uint8_t> mBuffer;  //!< the receive buffers of a batch,  max_datagram_size each
+#ifdef __linux__
+    static constexpr std::size_t control_size{CMSG_SPACE(sizeof(timespec))};
+    std::vector<mmsghdr> mMessages;
+    std::vector<iovec> mVectors;
+    std::vector<cmsghdr> mControl;  //!< the control buffers of a batch,  aligned for the cmsg headers
+    std::size_t mControlStride{0U};  //!< the number of cmsghdr elements in each control buffer
+#endif
+    std::size_t mShard{0U};
+    std::uint16_t mPort{0U};
+    bool mLearn{true};
+
+    std::atomic<bool> mRunning{false};
+    std::atomic<std::uint64_t> mDatagrams{0U};
+    std::atomic<std::uint64_t> mFrames{0U};
+    std::atomic<std::uint64_t> mReceiveCalls{0U};
+    std::atomic<std::uint64_t> mUnknownFrames{0U};
+};
+
+UdpListener::UdpListener(asio::io_context &context, ListenerCall frameCall, bool learn, std::size_t shard):
+    mContext(context),
+    mStrand(asio::make_strand(context)), mSocket(mStrand), mFrameCall(std::move(frameCall)),
+    mStreamIndex(std::numeric_limits<std::uint16_t>::max() + 1U, no_stream),
+    mBuffer(receive_batch_size * max_datagram_size), mShard(shard), mLearn(learn)
+{
+#ifdef __linux__
+    mMessages.resize(receive_batch_size);
+    mVectors.resize(receive_batch_size);
+    mControlStride = (control_size + sizeof(cmsghdr) - 1U) / sizeof(cmsghdr);
+    mControl.resize(receive_batch_size * mControlStride);
+    for (std::size_t ii = 0; ii < receive_batch_size; ++ii)
+    {
+        mVectors[ii].iov_base = mBuffer.data() + ii * max_datagram_size;
+        mVectors[ii].iov_len = max_datagram_size;
+    }
+#endif
+}
+
+bool UdpListener::open(const std::string &interface, const std::string &port, int receiveBufferSize, bool reusePort)
+{
+    asio::error_code ec;
+    udp::resolver resolver(mContext);
+    auto endpoints = resolver.resolve(interface, port, udp::resolver::passive, ec);
+    if (ec || endpoints.empty())
+    {
+        fail(ec, "pmu udp receiver resolve");
+        return false;
+    }
+    const udp::endpoint endpoint = *endpoints.begin();
+
+    mSocket.open(endpoint.protocol(), ec);
+    if (ec)
+    {
+        fail(ec, "pmu udp receiver socket open");
+        return false;
+    }
+    mSocket.set_option(asio::socket_base::reuse_address(true), ec);
+    if (receiveBufferSize > 0)
+    {
+        mSocket.set_option(asio::socket_base::receive_buffer_size(receiveBufferSize), ec);
+    }
+#ifdef SO_REUSEPORT
+    if (reusePort)
+    {
+        const int enable{1};
+        if (::setsockopt(mSocket.native_handle(), SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) != 0)
+        {
+            fail(asio::error_code(errno, asio::error::get_system_category()), "pmu udp receiver reuse port");
+            return false;
+        }
+    }
+#else
+    if (reusePort)
+    {
+        return false;
+    }
+#endif
+    mSocket.bind(endpoint, ec);
+    if (ec)
+    {
+        fail(ec, "pmu udp receiver socket bind");
+        return false;
+    }
+    // the socket is drained until it would block and then waited on
+    mSocket.non_blocking(true, ec);
+#ifdef __linux__
+    const int enable{1};
+    if (::setsockopt(mSocket.native_handle(), SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) != 0)
+    {
+        fail(asio::error_code(errno, asio::error::get_system_category()), "pmu udp receiver timestamps");
+    }
+#endif
+    mPort = mSocket.local_endpoint(ec).port();
+    return true;
+}
+
+bool UdpListener::steerByIdcode(std::size_t shardCount)
+{
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+    // the program sees the datagram payload,  A = IDCODE of the first frame;  return A % shardCount
+    sock_filter code[] = {
+      {BPF_LD | BPF_H | BPF_ABS, 0, 0, 4U},
+      {BPF_ALU | BPF_MOD | BPF_K, 0, 0, static_cast<std::uint32_t>(shardCount)},
+      {BPF_RET | BPF_A, 0, 0, 0U},
+    };
+    sock_fprog program{static_cast<unsigned short>(std::size(code)), code};
+    if (::setsockopt(mSocket.native_handle(), SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program)) == 0)
+    {
+        return true;
+    }
+    fail(asio::error_code(errno, asio::error::get_system_category()), "pmu udp receiver idcode steering");
+#endif
+    return false;
+}
+
+void UdpListener::addStream(const c37118::Config &config)
+{
+    auto &index = mStreamIndex[config.idcode];
+    // a replaced configuration stays alive while frames queued with it are waiting to be merged
+    auto stream = std::make_shared<const c37118::Config>(config);
+    if (index == no_stream)
+    {
+        index = static_cast<std::uint32_t>(mStreams.size());
+        mStreams.push_back(std::move(stream));
+    }
+    else
+    {
+        mStreams[index] = std::move(stream);
+    }
+}
+
+void UdpListener::start()
+{
+    mRunning = true;
+    asio::dispatch(mStrand, [self = shared_from_this()]() { self->doWait(); });
+}
+
+void UdpListener::stop()
+{
+    mRunning = false;
+    asio::post(mStrand, [self = shared_from_this()]() {
+        asio::error_code ec;
+        self->mSocket.close(ec);
+    });
+}
+
+void UdpListener::doWait()
+{
+    mSocket.async_wait(udp::socket::wait_read,
+                       [self = shared_from_this()](const asio::error_code &ec) { self->onReadable(ec); });
+}
+
+void UdpListener::onReadable(const asio::error_code &ec)
+{
+    if (!mRunning.load() || ec == asio::error::operation_aborted)
+    {
+        return;
+    }
+    if (ec)
+    {
+        fail(ec, "pmu udp receiver wait");
+    }
+    else
+    {
+        for (std::size_t batch = 0; batch < max_batches_per_wait; ++batch)
+        {
+            if (receiveBatch() < receive_batch_size)
+            {
+                break;
+            }
+        }
+    }
+    doWait();
+}
+
+#ifdef __linux__
+std::size_t UdpListener::receiveBatch()
+{
+    for (std::size_t ii = 0; ii < receive_batch_size; ++ii)
+    {
+        // recvmmsg overwrites the lengths so the headers are reset for every call
+        auto &header = mMessages[ii].msg_hdr;
+        header.msg_name = nullptr;
+        header.msg_namelen = 0;
+        header.msg_iov = &mVectors[ii];
+        header.msg_iovlen = 1;
+        header.msg_control = mControl.data() + ii * mControlStride;
+        header.msg_controllen = mControlStride * sizeof(cmsghdr);
+        header.msg_flags = 0;
+        mMessages[ii].msg_len = 0;
+    }
+    int result{-1};
+    do
+    {
+        ++mReceiveCalls;
+        result = ::recvmmsg(
+          mSocket.native_handle(), mMessages.data(), static_cast<unsigned int>(receive_batch_size), MSG_DONTWAIT, nullptr);
+    } while (result < 0 && errno == EINTR);
+    if (result <= 0)
+    {
+        if (result < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            fail(asio::error_code(errno, asio::error::get_system_category()), "pmu udp receive");
+        }
+        return 0U;
+    }
+    const auto count = static_cast<std::size_t>(result);
+    for (std::size_t ii = 0; ii < count; ++ii)
+    {
+        auto &header = mMessages[ii].msg_hdr;
+        std::chrono::nanoseconds receiveTime{0};
+        for (cmsghdr *cmsg = CMSG_FIRSTHDR(&header); cmsg != nullptr; cmsg = CMSG_NXTHDR(&header, cmsg))
+        {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS)
+            {
+                timespec stamp{};
+                std::memcpy(&stamp, CMSG_DATA(cmsg), sizeof(stamp));
+                receiveTime = std::chrono::seconds(stamp.tv_sec) + std::chrono::nanoseconds(stamp.tv_nsec);
+            }
+        }
+        if (receiveTime.count() == 0)
+        {
+            receiveTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::system_clock::now().time_since_epoch());
+        }
+        handleDatagram(static_cast<const std::uint8_t *>(mVectors[ii].iov_base), mMessages[ii].msg_len, receiveTime);
+    }
+    return count;
+}
+#else
+std::size_t UdpListener::receiveBatch()
+{
+    std::size_t count{0U};
+    while (count < receive_batch_size)
+    {
+        asio::error_code ec;
+        udp::endpoint sender;
+        ++mReceiveCalls;
+        const auto bytes = mSocket.receive_from(asio::buffer(mBuffer.data(), max_datagram_size), sender, 0, ec);
+        if (ec)
+        {
+            if (ec != asio::error::would_block)
+            {
+                fail(ec, "pmu udp receive");
+            }
+            break;
+        }
+        handleDatagram(mBuffer.data(),
+                       bytes,
+                       std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::system_clock::now().time_since_epoch()));
+        ++count;
+    }
+    return count;
+}
+#endif
+
+void UdpListener::handleDatagram(const std::uint8_t *data, std::size_t size, std::chrono::nanoseconds receiveTime)
+{
+    ++mDatagrams;
+    mExtractor.push(data, size);
+    c37118::FrameSpan frame;
+    while (mExtractor.next(frame))
+    {
+        handleFrame(frame, receiveTime);
+    }
+    // frames do not span datagrams
+    mExtractor.flush();
+}
+
+void UdpListener::handleFrame(const c37118::FrameSpan &frame, std::chrono::nanoseconds receiveTime)
+{
+    ++mFrames;
+    ReceivedFrame received;
+    received.frame = frame;
+    received.type = c37118::getPacketType(frame.data, frame.size);
+    received.idcode = c37118::getIdCode(frame.data, frame.size);
+    received.receiveTime = receiveTime;
+    received.shard = mShard;
+    if (mLearn && received.type == c37118::PmuPacketType::config2 &&
+        c37118::parseConfig2(frame.data, frame.size, mLearned) == c37118::ParseResult::parse_complete)
+    {
+        addStream(mLearned);
+    }
+    const auto index = mStreamIndex[received.idcode];
+    if (index == no_stream)
+    {
+        ++mUnknownFrames;
+    }
+    else
+    {
+        received.config = mStreams[index].get();
+    }
+    if (mFrameCall)
+    {
+        mFrameCall(received, (index == no_stream) ? mNoStream : mStreams[index]);
+    }
+}
+
+/* the frames a shard has received and the merge stage has not delivered,  the bytes of all the frames are stored
+ * together so a queue which has been drained before does not allocate*/
+class QueuedFrames
+{
+  public:
+    class Frame
+    {
+      public:
+        std::size_t offset{0U};  //!< the offset of the frame in bytes
+        std::size_t size{0U};
+        c37118::PmuPacketType type{c37118::PmuPacketType::unknown};
+        std::uint16_t idcode{0U};
+        std::shared_ptr<const c37118::Config> config;
+        std::chrono::nanoseconds receiveTime{0};
+        std::size_t shard{0U};
+    };
+    std::vector<std::uint8_t> bytes;
+    std::vector<Frame> frames;
+
+    void clear()
+    {
+        bytes.clear();
+        frames.clear();
+    }
+};
+
+/* delivers the frames of the shards to the frame callback on a strand of the caller's io_context
+@details each shard appends to its own queue and the queue is drained in order,  since all the frames of an idcode
+are received by one shard the frames of each stream are delivered in the order they were received*/
+class MergeStage: public std::enable_shared_from_this<MergeStage>
+{
+  public:
+    MergeStage(asio::io_context &context, std::size_t shardCount, std::function<void(const ReceivedFrame &)> frameCall):
+        mStrand(asio::make_strand(context)), mFrameCall(std::move(frameCall))
+    {
+        for (std::size_t ii = 0; ii < shardCount; ++ii)
+        {
+            mQueues.push_back(std::make_unique<Queue>());
+        }
+    }
+    /* add a frame to the queue of a shard,  called on the thread of the shard*/
+    void push(const ReceivedFrame &frame, const std::shared_ptr<const c37118::Config> &config);
+    /* discard the queued frames and any received later*/
+    void stop() { mRunning = false; }
+
+  private:
+    class Queue
+    {
+      public:
+        std::mutex mutex;
+        QueuedFrames pending;  //!< filled by the shard under the mutex
+        QueuedFrames draining;  //!< the frames being delivered,  only used on the strand
+        bool scheduled{false};  //!< a drain has been posted and has not yet taken the pending frames
+    };
+    void drain(std::size_t shard);
+
+    asio::strand<asio::io_context::executor_type> mStrand;
+    std::function<void(const ReceivedFrame &)> mFrameCall;
+    std::vector<std::unique_ptr<Queue>> mQueues;
+    std::atomic<bool> mRunning{true};
+};
+
+void MergeStage::push(const ReceivedFrame &frame, const std::shared_ptr<const c37118::Config> &config)
+{
+    if (!mRunning.load())
+    {
+        return;
+    }
+    auto &queue = *mQueues[frame.shard];
+    bool schedule{false};
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        auto &pending = queue.pending;
+        pending.frames.push_back(
+          {pending.bytes.size(), frame.frame.size, frame.type, frame.idcode, config, frame.receiveTime, frame.shard});
+        pending.bytes.insert(pending.bytes.end(), frame.frame.data, frame.frame.data + frame.frame.size);
+        schedule = !queue.scheduled;
+        queue.scheduled = true;
+    }
+    // one drain is posted for all the frames pushed before it runs
+    if (schedule)
+    {
+        asio::post(mStrand, [self = shared_from_this(), shard = frame.shard]() { self->drain(shard); });
+    }
+}
+
+void MergeStage::drain(std::size_t shard)
+{
+    auto &queue = *mQueues[shard];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        std::swap(queue.pending, queue.draining);
+        queue.scheduled = false;
+    }
+    auto &draining = queue.draining;
+    if (mRunning.load() && mFrameCall)
+    {
+        for (const auto &queued : draining.frames)
+        {
+            ReceivedFrame received;
+            received.frame = {draining.bytes.data() + queued.offset, queued.size};
+            received.type = queued.type;
+            received.idcode = queued.idcode;
+            received.config = queued.config.get();
+            received.receiveTime = queued.receiveTime;
+            received.shard = queued.shard;
+            mFrameCall(received);
+        }
+    }
+    draining.clear();
+}
+
+/* the sockets of a sharded UdpReceiver,  each with its own listener and thread*/
+class ReceiverShards
+{
+  public:
+    ReceiverShards(asio::io_context &context,
+                   std::size_t shardCount,
+                   std::function<void(const ReceivedFrame &)> frameCall,
+                   bool learn);
+    ~ReceiverShards() { stop(); }
+
+    bool open(const std::string &interface,
+              const std::string &port,
+              int receiveBufferSize,
+              const std::vector<c37118::Config> &streams);
+    void start();
+    void stop();
+
+    std::uint16_t getPort() const { return mShards.front()->listener->getPort(); }
+    /* sum a counter of the listeners*/
+    template <class Counter>
+    std::uint64_t total(Counter counter) const
+    {
+        std::uint64_t sum{0U};
+        for (const auto &shard : mShards)
+        {
+            sum += ((*shard->listener).*counter)();
+        }
+        return sum;
+    }
+
+  private:
+    class Shard
+    {
+      public:
+        asio::io_context context;
+        asio::executor_work_guard<asio::io_context::executor_type> work{asio::make_work_guard(context)};
+        std::shared_ptr<UdpListener> listener;
+        std::thread thread;
+    };
+    std::shared_ptr<MergeStage> mMerge;
+    std::vector<std::unique_ptr<Shard>> mShards;
+};
+
+ReceiverShards::ReceiverShards(asio::io_context &context,
+                               std::size_t shardCount,
+                               std::function<void(const ReceivedFrame &)> frameCall,
+                               bool learn):
+    mMerge(std::make_shared<MergeStage>(context, shardCount, std::move(frameCall)))
+{
+    for (std::size_t ii = 0; ii < shardCount; ++ii)
+    {
+        auto shard = std::make_unique<Shard>();
+        shard->listener = std::make_shared<UdpListener>(
+          shard->context,
+          [merge = mMerge](const ReceivedFrame &frame, const std::shared_ptr<const c37118::Config> &config) {
+              merge->push(frame, config);
+          },
+          learn,
+          ii);
+        mShards.push_back(std::move(shard));
+    }
+}
+
+bool ReceiverShards::open(const std::string &interface,
+                          const std::string &port,
+                          int receiveBufferSize,
+                          const std::vector<c37118::Config> &streams)
+{
+    for (auto &shard : mShards)
+    {
+        // the first socket selects the port if it is "0" and the others join it,  the kernel numbers the sockets of
+        // the group in the order they are bound
+        const auto shardPort = (shard == mShards.front()) ? port : std::to_string(getPort());
+        if (!shard->listener->open(interface, shardPort, receiveBufferSize, true))
+        {
+            return false;
+        }
+        for (const auto &stream : streams)
+        {
+            shard->listener->addStream(stream);
+        }
+    }
+    mShards.front()->listener->steerByIdcode(mShards.size());
+    return true;
+}
+
+void ReceiverShards::start()
+{
+    for (auto &shard : mShards)
+    {
+        shard->listener->start();
+        shard->thread = std::thread([context = &shard->context]() { context->run(); });
+    }
+}
+
+void ReceiverShards::stop()
+{
+    mMerge->stop();
+    for (auto &shard : mShards)
+    {
+        // closing the socket completes the pending wait,  then the context runs out of work
+        shard->listener->stop();
+        shard->work.reset();
+    }
+    for (auto &shard : mShards)
+    {
+        if (shard->thread.joinable())
+        {
+            shard->thread.join();
+        }
+    }
+}
+
+UdpReceiver::~UdpReceiver() { stopReceiving(); }
+
+bool UdpReceiver::startReceiving(asio::io_context &io_context)
+{
+    stopReceiving();
+    if (shardCount > 1)
+    {
+        auto shards =
+          std::make_shared<ReceiverShards>(io_context, static_cast<std::size_t>(shardCount), mFrameCall, learnConfig);
+        if (!shards->open(interface, port, receiveBufferSize, streams))
+        {
+            return false;
+        }
+        shards->start();
+        mShards = std::move(shards);
+        return true;
+    }
+    auto listener = std::make_shared<UdpListener>(
+      io_context,
+      [frameCall = mFrameCall](const ReceivedFrame &frame, const std::shared_ptr<const c37118::Config> & /*config*/) {
+          if (frameCall)
+          {
+              frameCall(frame);
+          }
+      },
+      learnConfig);
+    if (!listener->open(interface, port, receiveBufferSize))
+    {
+        return false;
+    }
+    for (const auto &stream : streams)
+    {
+        listener->addStream(stream);
+    }
+    listener->start();
+    mListener = std::move(listener);
+    return true;
+}
+
+void UdpReceiver::stopReceiving()
+{
+    if (mListener)
+    {
+        mListener->stop();
+        mListener.reset();
+    }
+    mShards.reset();
+}
+
+std::uint16_t UdpReceiver::getPort() const
+{
+    return mListener ? mListener->getPort() : (mShards ? mShards->getPort() : 0U);
+}
+
+std::uint64_t UdpReceiver::datagramsReceived() const
+{
+    return mListener ? mListener->datagramsReceived() : (mShards ? mShards->total(&UdpListener::datagramsReceived) : 0U);
+}
+
+std::uint64_t UdpReceiver::framesReceived() const
+{
+    return mListener ? mListener->framesReceived() : (mShards ? mShards->total(&UdpListener::framesReceived) : 0U);
+}
+
+std::uint64_t UdpReceiver::receiveCalls() const
+{
+    return mListener ? mListener->receiveCalls() : (mShards ? mShards->total(&UdpListener::receiveCalls) : 0U);
+}
+
+std::uint64_t UdpReceiver::unknownFrames() const
+{
+    return mListener ? mListener->unknownFrames() : (mShards ? mShards->total(&UdpListener::unknownFrames) : 0U);
+}
+
+}  // namespace pmu
@@ -0,0 +1,106 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+#include "asio/io_context.hpp"
+#include "FrameExtractor.hpp"
+#include "c37118.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pmu
+{
+class UdpListener;
+class ReceiverShards;
+
+/** a C37.118 frame received by a UdpReceiver*/
+class ReceivedFrame
+{
+  public:
+    c37118::FrameSpan frame;  //!< the bytes of the frame,  only valid during the callback
+    c37118::PmuPacketType type{c37118::PmuPacketType::unknown};
+    std::uint16_t idcode{0U};
+    /** the configuration of the stream sending the frame or nullptr if the idcode is not known,  only valid during
+     * the callback*/
+    const c37118::Config *config{nullptr};
+    /** the time the datagram was received since the epoch,  from the kernel timestamp where it is available*/
+    std::chrono::nanoseconds receiveTime{0};
+    std::size_t shard{0U};  //!< the index of the socket which received the frame
+};
+
+/** a PDC input receiving C37.118 frames from any number of PMUs sending to one UDP port
+@details the socket is drained in batches with recvmmsg where it is available and every datagram is split into frames
+by a FrameExtractor.  Each frame is routed to the configuration of its stream through a table indexed by the idcode,
+so the cost per frame does not depend on the number of streams.  Streams are configured with addStream or learned
+from the config2 frames they send.  The frame callback is called on the thread running the io_context.
+
+With more than one shard the receiver opens a SO_REUSEPORT socket for each shard,  each with its own thread and
+decoding state.  On Linux the kernel is given a program selecting the socket from the IDCODE of the first frame of
+each datagram,  so all the frames of a stream are handled by the same shard;  elsewhere the kernel selects the socket
+from the sender address.  The shards hand their frames to a merge stage which calls the frame callback on the
+io_context passed to startReceiving,  preserving the order of the frames of each stream.
+*/
+class UdpReceiver
+{
+  protected:
+    std::string interface;  //!< the local address to receive on,  empty for all interfaces
+    std::string port{"4713"};
+    std::vector<c37118::Config> streams;  //!< the configured streams
+    bool learnConfig{true};  //!< update the stream configurations from received config2 frames
+    int receiveBufferSize{0};  //!< the socket receive buffer size or 0 for the system default
+    int shardCount{1};  //!< the number of sockets and threads receiving in parallel
+
+  private:
+    std::shared_ptr<UdpListener> mListener;
+    std::shared_ptr<ReceiverShards> mShards;
+    std::function<void(const ReceivedFrame &frame)> mFrameCall;
+
+  public:
+    UdpReceiver() = default;
+    UdpReceiver(const UdpReceiver &) = delete;
+    UdpReceiver &operator=(const UdpReceiver &) = delete;
+    ~UdpReceiver();
+
+    /** set the local address and port,  port "0" selects an unused port*/
+    void setInterface(const std::string &newInterface, const std::string &newPort)
+    {
+        interface = newInterface;
+        port = newPort;
+    }
+    /** add the configuration of a stream,  streams apply to receivers started after the call*/
+    void addStream(const c37118::Config &config) { streams.push_back(config); }
+    /** enable or disable updating the stream configurations from the config2 frames received*/
+    void setConfigLearning(bool learn) { learnConfig = learn; }
+    /** set the socket receive buffer size,  a larger buffer absorbs bursts of datagrams from many streams*/
+    void setReceiveBufferSize(int bufferSize) { receiveBufferSize = bufferSize; }
+    /** set the number of sockets receiving on the port in parallel,  each with its own thread
+    @details the setting applies to receivers started after the call*/
+    void setShardCount(int count) { shardCount = (count < 1) ? 1 : count; }
+    /** set the function called for every frame received*/
+    void setFrameCall(std::function<void(const ReceivedFrame &frame)> frameCall) { mFrameCall = std::move(frameCall); }
+
+    /** open the sockets and start receiving
+    @return true if the sockets are open*/
+    bool startReceiving(asio::io_context &io_context);
+    /** close the sockets and stop the shard threads,  frames which have not been delivered are discarded*/
+    void stopReceiving();
+
+    /** get the local port of the socket or 0 if the receiver is not running*/
+    std::uint16_t getPort() const;
+    /** get the number of datagrams received since the receiver was started*/
+    std::uint64_t datagramsReceived() const;
+    /** get the number of frames extracted from the datagrams since the receiver was started*/
+    std::uint64_t framesReceived() const;
+    /** get the number of receive system calls since the receiver was started*/
+    std::uint64_t receiveCalls() const;
+    /** get the number of frames from idcodes without a configuration since the receiver was started*/
+    std::uint64_t unknownFrames() const;
+};
+}  // namespace pmu
@@ -5,31 +5,24 @@ the top-level NOTICE for additional details. All rights reserved. SPDX-License-I
 */
 
 #include "c37118.h"
+
+#include "FrameBatch.hpp"
+#include "FrameLayout.hpp"
+#include "c37118Crc.h"
+#include "c37118Fields.h"
+#include "c37118Kernels.h"
 #include <asio/detail/socket_ops.hpp>
 
 namespace c37118
 {
 static std::uint16_t calculateCRC(const std::uint8_t *data, std::uint16_t dataLength)
 {
-    /** CRC-CCITT Calculation
-     f(x) = x^16 + x^12 + x^5 + 1
-
-    Derived from IEEE Std C37.118-2005 sample code
-    */
-    std::uint16_t crc = 0xFFFF;  // 0xFFFF is specific for SynchroPhasor Data CRC
-    // -2 to leave space for the CRC itself
-    for (std::uint16_t ii = 0; ii < dataLength - 2; ii++)
+    if (dataLength < 2U)
     {
-        std::uint16_t calc1 = (crc >> 8) ^ data[ii];
-        crc <<= 8;
-        std::uint16_t calc2 = calc1 ^ (calc1 >> 4);
-        crc ^= calc2;
-        calc2 <<= 5;
-        crc ^= calc2;
-        calc2 <<= 7;
-        crc ^= calc2;
+        return crc_initial_value;
     }
-    return crc;
+    // -2 to leave space for the CRC itself
+    return crcCCITT(data, dataLength - 2U);
 }
 static void addTime(std::uint8_t *data, std::uint32_t soc, std::uint32_t fracsec)
 {
@@ -39,12 +32,36 @@ static void addTime(std::uint8_t *data, std::uint32_t soc, std::uint32_t fracsec
     memcpy(data + 10, &fracsec, sizeof(std::uint32_t));
 }
 
-static void addTime(std::uint8_t *data, std::uint32_t soc, double fracsec, std::uint8_t timeQuality, const Config &config)
+static void addTime(std::uint8_t *data, const PmuDataFrame &frame, const Config &config)
 {
+    std::uint32_t soc = frame.soc;
+    std::uint32_t frsec{0U};
+    const std::uint32_t tickBase = (frame.tickTimeBase != 0U) ? frame.tickTimeBase : config.timeBase;
+    // code that sets fracSec without the count clears exactTime
+    if (frame.exactTime && tickBase != 0U)
+    {
+        if (tickBase == config.timeBase)
+        {
+            frsec = frame.fracSecTicks & 0x00FFFFFFU;
+        }
+        else
+        {
+            // a count from a stream with another time base is rounded to the nearest tick of this one
+            auto ticks = (static_cast<std::uint64_t>(frame.fracSecTicks) * config.timeBase + tickBase / 2U) / tickBase;
+            if (ticks >= config.timeBase)
+            {
+                ticks -= config.timeBase;
+                ++soc;
+            }
+            frsec = static_cast<std::uint32_t>(ticks) & 0x00FFFFFFU;
+        }
+    }
+    else
+    {
+        frsec = static_cast<std::uint32_t>(frame.fracSec * static_cast<double>(config.timeBase)) & 0x00FFFFFFU;
+    }
     soc = htonl(soc);
-
-    auto frsec = (static_cast<std::uint32_t>(fracsec * static_cast<double>(config.timeBase)) & 0x00FFFFFFU);
-    frsec += (timeQuality << 24);
+    frsec += (static_cast<std::uint32_t>(frame.timeQuality) << 24);
     frsec = htonl(frsec);
     memcpy(data + 6, &soc, sizeof(std::uint32_t));
     memcpy(data + 10, &frsec, sizeof(std::uint32_t));
@@ -134,6 +151,52 @@ std::uint16_t getPacketSize(const std::uint8_t* data, size_t dataSize)
     return byteCount;
 }
 
+ChannelNameTable::ChannelNameTable(std::initializer_list<std::string_view> names, const allocator_type &alloc):
+    mTable(alloc)
+{
+    mTable.reserve(names.size() * channel_name_size);
+    for (const auto &name : names)
+    {
+        push_back(name);
+    }
+}
+
+std::string_view ChannelNameTable::operator[](std::size_t index) const
+{
+    const char *field = mTable.data() + index * channel_name_size;
+    std::size_t length{channel_name_size};
+    while (length > 0 && field[length - 1] == '\0')
+    {
+        --length;
+    }
+    return {field, length};
+}
+
+void ChannelNameTable::push_back(std::string_view name)
+{
+    mTable.resize(mTable.size() + channel_name_size, '\0');
+    assign(size() - 1, name);
+}
+
+void ChannelNameTable::assign(std::size_t index, std::string_view name)
+{
+    char *field = &mTable[index * channel_name_size];
+    const auto length = std::min(name.size(), static_cast<std::size_t>(channel_name_size));
+    memcpy(field, name.data(), length);
+    memset(field + length, 0, channel_name_size - length);
+}
+
+void ChannelNameTable::assignFields(const std::uint8_t *data, std::size_t count)
+{
+    mTable.assign(reinterpret_cast<const char *>(data), count * channel_name_size);
+}
+
+PmuConfig::PmuConfig(const allocator_type &alloc):
+    phasorNames(alloc), analogNames(alloc), digitChannelNames(alloc), phasorType(alloc), phasorConversion(alloc),
+    analogType(alloc), analogConversion(alloc), digitalNominal(alloc), digitalActive(alloc), stationName(alloc)
+{
+}
+
 static std::size_t parsePmuConfig(const std::uint8_t *data, PmuConfig &config)
 {
     std::size_t bytes_used{0};
@@ -161,29 +224,12 @@ static std::size_t parsePmuConfig(const std::uint8_t *data, PmuConfig &config)
     config.digitalWordCount = (static_cast<std::uint16_t>(data[bytes_used]) << 8) + data[bytes_used + 1];
     bytes_used += 2;
     /* get the channel names*/
-    config.phasorNames.resize(config.phasorCount);
-    for (int ii = 0; ii < config.phasorCount; ++ii)
-    {
-        config.phasorNames[ii].assign(reinterpret_cast<const char *>(data + bytes_used),
-                                      reinterpret_cast<const char *>(data) + bytes_used + 16);
-        bytes_used += 16;
-    }
-
-    config.analogNames.resize(config.analogCount);
-    for (int ii = 0; ii < config.analogCount; ++ii)
-    {
-        config.analogNames[ii].assign(reinterpret_cast<const char *>(data + bytes_used),
-                                      reinterpret_cast<const char *>(data) + bytes_used + 16);
-        bytes_used += 16;
-    }
-    config.digitChannelNames.resize(config.digitalWordCount * 16);
-
-    for (int ii = 0; ii < config.digitalWordCount * 16; ++ii)
-    {
-        config.digitChannelNames[ii].assign(reinterpret_cast<const char *>(data + bytes_used),
-                                            reinterpret_cast<const char *>(data) + bytes_used + 16);
-        bytes_used += 16;
-    }
+    config.phasorNames.assignFields(data + bytes_used, config.phasorCount);
+    bytes_used += channel_name_size * config.phasorCount;
+    config.analogNames.assignFields(data + bytes_used, config.analogCount);
+    bytes_used += channel_name_size * config.analogCount;
+    config.digitChannelNames.assignFields(data + bytes_used, config.digitalWordCount * 16U);
+    bytes_used += channel_name_size * config.digitalWordCount * 16U;
     /* get the channel conversion information */
     config.phasorType.resize(config.phasorCount);
     config.phasorConversion.resize(config.phasorCount);
@@ -254,6 +300,7 @@ ParseResult parseConfig1(const std::uint8_t *data, size_t dataSize, Config &conf
         bytes_used += parsePmuConfig(data + bytes_used, config.pmus[ii]);
     }
     config.dataRate = static_cast<int16_t>((static_cast<std::uint16_t>(data[bytes_used]) << 8) + data[bytes_used+1]);
+    updateFrameLayout(config);
     return ParseResult::parse_complete;
 }
 
@@ -342,150 +389,222 @@ std::string getExtendedData(const std::uint8_t* data, size_t dataSize) {
     return ed;
 }
 
-static std::size_t getExpectedDataPacketLength(const Config &config)
+/* the interleaved real and imaginary parts of an array of complex values,  std::complex is guaranteed to be laid out
+ * as an array of its real and imaginary parts*/
+static double *complexParts(std::complex<double> *values)
+{
+    return static_cast<double *>(static_cast<void *>(values));
+}
+
+static const double *complexParts(const std::complex<double> *values)
+{
+    return static_cast<const double *>(static_cast<const void *>(values));
+}
+
+static void decodeFloatValues(const std::uint8_t *data, std::size_t count, double *values)
 {
-    std::size_t dataSize{common_frame_size+2U};
-    for (const auto &pmu : config.pmus)
+    if (count >= kernel_minimum_channels)
     {
-        dataSize += 2U;
-        dataSize +=
-          2 * ((pmu.phasorFormat == integer_format) ? sizeof(std::uint16_t) : sizeof(float)) * pmu.phasorCount;
+        decodeFloats(data, count, values);
+        return;
+    }
+    for (std::size_t ii = 0; ii < count; ++ii, data += 4)
+    {
+        values[ii] = readFloat(data);
+    }
+}
 
-        dataSize += 2 * ((pmu.freqFormat == integer_format) ? sizeof(std::uint16_t) : sizeof(float));
+static void decodeFloatValues(const std::uint8_t *data, std::size_t count, float *values)
+{
+    for (std::size_t ii = 0; ii < count; ++ii, data += 4)
+    {
+        values[ii] = readFloat(data);
+    }
+}
 
-        dataSize +=
-          ((pmu.analogFormat == integer_format) ? sizeof(std::uint16_t) : sizeof(float)) * pmu.analogCount;
+/* the number of bytes of a single phasor*/
+template <PhasorEncoding Encoding>
+static constexpr std::size_t phasor_size{
+  (Encoding == PhasorEncoding::integer_rectangular || Encoding == PhasorEncoding::integer_polar) ? 4U : 8U};
 
-        dataSize += pmu.digitalWordCount * sizeof(std::uint16_t);
+template <PhasorEncoding Encoding>
+static std::complex<double> readPhasor(const std::uint8_t *phasorData, double scale)
+{
+    if constexpr (Encoding == PhasorEncoding::integer_rectangular)
+    {
+        return {static_cast<double>(readInt16(phasorData)) * scale,
+                static_cast<double>(readInt16(phasorData + 2)) * scale};
+    }
+    else if constexpr (Encoding == PhasorEncoding::integer_polar)
+    {
+        return std::polar<double>(static_cast<double>(readUInt16(phasorData)) * scale,
+                                  static_cast<double>(readInt16(phasorData + 2)) * integer_angle_scale);
+    }
+    else if constexpr (Encoding == PhasorEncoding::float_rectangular)
+    {
+        return {readFloat(phasorData), readFloat(phasorData + 4)};
+    }
+    else
+    {
+        return std::polar<double>(readFloat(phasorData), readFloat(phasorData + 4));
     }
-    return dataSize;
 }
 
-static std::size_t parsePmuData(const std::uint8_t *data, const PmuConfig &config, PmuData &pmuData)
+template <PhasorEncoding Encoding, class Value>
+static void decodePhasors(const std::uint8_t *phasorData, const PmuBlockLayout &block, std::complex<Value> *phasors)
 {
-    std::size_t bytes_used{0U};
-    memcpy(&pmuData.stat, data, 2U);
-    pmuData.stat = ntohs(pmuData.stat);
-    pmuData.phasors.resize(config.phasorCount);
-    bytes_used += 2;
-    for (int ii = 0; ii < config.phasorCount; ++ii)
+    const double *scale = block.phasorScale.data();
+    // the vector kernels produce doubles,  float storage uses the scalar loop
+    if constexpr (std::is_same_v<Value, double>)
     {
-        if (config.phasorFormat == integer_format)
+        if (block.phasorCount >= kernel_minimum_channels)
         {
-            if (config.phasorCoordinates == rectangular_phasor)
+            if constexpr (Encoding == PhasorEncoding::integer_rectangular)
             {
-                std::int16_t val1;
-                std::int16_t val2;
-                std::memcpy(&val1, data + bytes_used, sizeof(std::int16_t));
-                std::memcpy(&val2, data + bytes_used + sizeof(std::int16_t), sizeof(std::int16_t));
-                val1 = static_cast<std::int16_t>(ntohs(static_cast<std::uint16_t>(val1)));
-                val2 = static_cast<std::int16_t>(ntohs(static_cast<std::uint16_t>(val2)));
-                pmuData.phasors[ii] =
-                  std::complex<double>(static_cast<double>(val1) * 1e-5 *
-                                                         static_cast<double>(config.phasorConversion[ii]),
-                                      static_cast<double>(val2) * 1e-5 *
-                                                         static_cast<double>(config.phasorConversion[ii]));
+                decodeInt16Pairs(phasorData, block.phasorCount, scale, complexParts(phasors));
+                return;
             }
-            else
+            else if constexpr (Encoding == PhasorEncoding::float_rectangular)
             {
-                std::uint16_t val1;
-                std::int16_t val2;
-                std::memcpy(&val1, data + bytes_used, sizeof(std::uint16_t));
-                std::memcpy(&val2, data + bytes_used + sizeof(std::uint16_t), sizeof(std::int16_t));
-                val1 = ntohs(val1);
-                val2 = static_cast<std::int16_t>(ntohs(static_cast<std::uint16_t>(val2)));
-                pmuData.phasors[ii] =
-                  std::polar<double>(static_cast<double>(val1) * 1e-5 *
-                                                       static_cast<double>(config.phasorConversion[ii]),
-                                    static_cast<double>(val2) / 1e4);
+                decodeFloats(phasorData, 2U * block.phasorCount, complexParts(phasors));
+                return;
             }
-            bytes_used += sizeof(std::uint16_t) + sizeof(std::int16_t);
         }
-        else
+    }
+    for (std::size_t ii = 0; ii < block.phasorCount; ++ii, phasorData += phasor_size<Encoding>)
+    {
+        phasors[ii] = static_cast<std::complex<Value>>(readPhasor<Encoding>(phasorData, scale[ii]));
+    }
+}
+
+template <std::uint8_t FreqFormat>
+static void readFrequency(const std::uint8_t *freqData, double &freq, double &rocof)
+{
+    if constexpr (FreqFormat == floating_point_format)
+    {
+        freq = readFloat(freqData);
+        rocof = readFloat(freqData + 4);
+    }
+    else
+    {
+        freq = static_cast<double>(readInt16(freqData)) * integer_frequency_scale;
+        rocof = static_cast<double>(readInt16(freqData + 2)) * integer_frequency_scale;
+    }
+}
+
+/* decoder for a single combination of phasor, frequency, and analog formats,  selected once per PMU block by
+ * assignPmuCodec so the field formats are not tested while decoding*/
+template <PhasorEncoding Encoding, std::uint8_t FreqFormat, std::uint8_t AnalogFormat, class Value>
+static void parsePmuData(const std::uint8_t *data, const PmuBlockLayout &block, BasicPmuData<Value> &pmuData)
+{
+    pmuData.stat = readUInt16(data + block.offset);
+
+    pmuData.phasors.resize(block.phasorCount);
+    decodePhasors<Encoding>(data + block.phasorOffset, block, pmuData.phasors.data());
+
+    double freq{0.0};
+    double rocof{0.0};
+    readFrequency<FreqFormat>(data + block.freqOffset, freq, rocof);
+    pmuData.freq = static_cast<Value>(freq);
+    pmuData.rocof = static_cast<Value>(rocof);
+
+    pmuData.analog.resize(block.analogCount);
+    auto *analog = pmuData.analog.data();
+    const std::uint8_t *analogData = data + block.analogOffset;
+    if constexpr (AnalogFormat == floating_point_format)
+    {
+        decodeFloatValues(analogData, block.analogCount, analog);
+    }
+    else
+    {
+        for (std::size_t ii = 0; ii < block.analogCount; ++ii, analogData += 2)
         {
-            std::uint32_t val1;
-            std::uint32_t val2;
-            std::memcpy(&val1, data + bytes_used, sizeof(float));
-            std::memcpy(&val2, data + bytes_used + sizeof(float), sizeof(float));
-            float val1f = ntohf(val1);
-            float val2f = ntohf(val2);
-            if (config.phasorCoordinates == rectangular_phasor)
-            {
-                pmuData.phasors[ii] = std::complex<double>(val1f, val2f);
-            }
-            else
-            {
-                pmuData.phasors[ii] = std::polar<double>(val1f, val2f);
-            }
-            bytes_used += 2 * sizeof(float);
+            analog[ii] = static_cast<Value>(readInt16(analogData));
         }
     }
 
-    if (config.freqFormat == floating_point_format)
+    pmuData.digital.resize(block.digitalWordCount);
+    auto *digital = pmuData.digital.data();
+    const std::uint8_t *digitalData = data + block.digitalOffset;
+    for (std::size_t ii = 0; ii < block.digitalWordCount; ++ii, digitalData += 2)
     {
-        std::uint32_t freqData;
-        std::memcpy(&freqData, data + bytes_used, sizeof(float));
-        pmuData.freq = static_cast<double>(ntohf(freqData));
-        bytes_used += sizeof(float);
-        std::memcpy(&freqData, data + bytes_used, sizeof(float));
-        pmuData.rocof = static_cast<double>(ntohf(freqData));
-        bytes_used += sizeof(float);
+        digital[ii] = readUInt16(digitalData);
     }
-    else
+}
+
+/* decoder writing a single PMU of a frame straight into row of the columns of a batch,  channel ii is stored
+ * frameCount values after channel ii-1*/
+template <PhasorEncoding Encoding, std::uint8_t FreqFormat, std::uint8_t AnalogFormat>
+static void
+  parsePmuColumns(const std::uint8_t *data, const PmuBlockLayout &block, PmuColumns &columns, std::size_t row)
+{
+    const std::size_t stride = columns.frameCount;
+    columns.stat[row] = readUInt16(data + block.offset);
+
+    const double *scale = block.phasorScale.data();
+    double *real = columns.phasorReal.data() + row;
+    double *imag = columns.phasorImag.data() + row;
+    const std::uint8_t *phasorData = data + block.phasorOffset;
+    for (std::size_t ii = 0; ii < block.phasorCount; ++ii, phasorData += phasor_size<Encoding>)
     {
-        std::int16_t freq{0};
-        std::memcpy(&freq, data + bytes_used, sizeof(freq));
-        freq = static_cast<std::int16_t>(ntohs(static_cast<std::uint16_t>(freq)));
-        bytes_used += sizeof(std::int16_t);
-        pmuData.freq = static_cast<double>(freq) / 1000.0;
-        /* rocof */
-        std::memcpy(&freq, data + bytes_used, sizeof(freq));
-        freq = static_cast<std::int16_t>(ntohs(static_cast<std::uint16_t>(freq)));
-        bytes_used += sizeof(std::int16_t);
-        pmuData.rocof = static_cast<double>(freq) / 1000.0;
+        const auto phasor = readPhasor<Encoding>(phasorData, scale[ii]);
+        real[ii * stride] = phasor.real();
+        imag[ii * stride] = phasor.imag();
     }
 
-    pmuData.analog.resize(config.analogCount);
-    for (int ii = 0; ii < config.analogCount; ++ii)
+    readFrequency<FreqFormat>(data + block.freqOffset, columns.freq[row], columns.rocof[row]);
+
+    double *analog = columns.analog.data() + row;
+    const std::uint8_t *analogData = data + block.analogOffset;
+    for (std::size_t ii = 0; ii < block.analogCount; ++ii)
     {
-        if (config.analogFormat == floating_point_format)
+        if constexpr (AnalogFormat == floating_point_format)
         {
-            std::uint32_t analog;
-            std::memcpy(&analog, data + bytes_used, sizeof(float));
-            pmuData.analog[ii] = ntohf(analog);
-            bytes_used += sizeof(float);
+            analog[ii * stride] = readFloat(analogData);
+            analogData += 4;
         }
         else
         {
-            std::int16_t analog{0};
-            std::memcpy(&analog, data + bytes_used, sizeof(analog));
-            analog = static_cast<std::int16_t>(ntohs(static_cast<std::uint16_t>(analog)));
-            bytes_used += sizeof(std::int16_t);
-            pmuData.analog[ii] = static_cast<float>(analog);
+            analog[ii * stride] = static_cast<double>(readInt16(analogData));
+            analogData += 2;
         }
     }
-    pmuData.digital.resize(config.digitalWordCount);
-    for (int ii = 0; ii < config.digitalWordCount; ++ii)
+
+    std::uint16_t *digital = columns.digital.data() + row;
+    const std::uint8_t *digitalData = data + block.digitalOffset;
+    for (std::size_t ii = 0; ii < block.digitalWordCount; ++ii, digitalData += 2)
     {
-        std::memcpy(&pmuData.digital[ii], data + bytes_used, sizeof(std::uint16_t));
-        pmuData.digital[ii] = ntohs(pmuData.digital[ii]);
-        bytes_used += sizeof(std::uint16_t);
+        digital[ii * stride] = readUInt16(digitalData);
     }
-    return bytes_used;
 }
 
 PmuDataFrame parseDataFrame(const std::uint8_t *data, size_t dataSize, const Config &config)
 {
     PmuDataFrame pdf;
+    parseDataFrame(data, dataSize, config, pdf);
+    return pdf;
+}
+
+static PmuDecoder blockDecoder(const PmuBlockLayout &block, const PmuData & /*unused*/) { return block.decoder; }
+
+static CompactPmuDecoder blockDecoder(const PmuBlockLayout &block, const CompactPmuData & /*unused*/)
+{
+    return block.compactDecoder;
+}
+
+template <class Value>
+static ParseResult
+  parseDataFrameInto(const std::uint8_t *data, size_t dataSize, const Config &config, BasicPmuDataFrame<Value> &pdf)
+{
     CommonFrame frame;
     if ((pdf.parseResult = parseCommon(data, dataSize, frame)) != ParseResult::parse_complete)
     {
-        return pdf;
+        return pdf.parseResult;
     }
     if (frame.type != PmuPacketType::data)
     {
         pdf.parseResult = ParseResult::incorrect_type;
-        return pdf;
+        return pdf.parseResult;
     }
     pdf.idcode = frame.sourceID;
     if (pdf.idcode != config.idcode)
@@ -493,22 +612,30 @@ PmuDataFrame parseDataFrame(const std::uint8_t *data, size_t dataSize, const Con
         pdf.parseResult = ParseResult::id_mismatch;
     }
     pdf.timeQuality = static_cast<std::uint8_t>(frame.fracSec >> 24);
-    pdf.fracSec =
-      static_cast<double>(frame.fracSec & 0x00FFFFFFU) / static_cast<double>(config.timeBase);
-    pdf.soc = frame.soc;
-    pdf.pmus.resize(config.pmus.size());
-    std::size_t bytes_used{common_frame_size};
-    auto expectedSize = getExpectedDataPacketLength(config);
-    if (expectedSize > dataSize)
+    setFrameTime(pdf, frame.soc, frame.fracSec & 0x00FFFFFFU, config.timeBase);
+    const auto &layout = getFrameLayout(config);
+    // resizing to the same size keeps the existing storage so a reused frame does not allocate
+    pdf.pmus.resize(layout.pmus.size());
+    if (layout.frameSize != frame.byteCount)
     {
         pdf.parseResult = ParseResult::config_mismatch;
-        return pdf;
+        return pdf.parseResult;
     }
-    for (std::size_t ii = 0; ii < config.pmus.size(); ++ii)
+    for (std::size_t ii = 0; ii < layout.pmus.size(); ++ii)
     {
-        bytes_used += parsePmuData(data + bytes_used, config.pmus[ii], pdf.pmus[ii]);
+        blockDecoder(layout.pmus[ii], pdf.pmus[ii])(data, layout.pmus[ii], pdf.pmus[ii]);
     }
-    return pdf;
+    return pdf.parseResult;
+}
+
+ParseResult parseDataFrame(const std::uint8_t *data, size_t dataSize, const Config &config, PmuDataFrame &pdf)
+{
+    return parseDataFrameInto(data, dataSize, config, pdf);
+}
+
+ParseResult parseDataFrame(const std::uint8_t *data, size_t dataSize, const Config &config, CompactPmuDataFrame &pdf)
+{
+    return parseDataFrameInto(data, dataSize, config, pdf);
 }
 
 static void generateCommonFrame(std::uint8_t *data, std::uint16_t dataSize, uint16_t idCode, PmuPacketType type)
@@ -556,6 +683,15 @@ static std::uint16_t getConfigSize(const Config &config, bool activeOnly)
 }
 
 static constexpr std::uint16_t low_byte_mask{0xFF};
+
+/* write the name fields of a number of channels,  missing names are left empty*/
+static std::uint16_t addChannelNames(std::uint8_t *data, const ChannelNameTable &names, std::size_t count)
+{
+    const auto available = std::min(names.size(), count);
+    memcpy(data, names.fields(), available * channel_name_size);
+    memset(data + available * channel_name_size, 0, (count - available) * channel_name_size);
+    return static_cast<std::uint16_t>(count * channel_name_size);
+}
 static std::uint16_t
 generatePMUConfig(std::uint8_t *data, size_t dataSize, const PmuConfig &config,
                                            bool activeOnly)
@@ -601,38 +737,9 @@ generatePMUConfig(std::uint8_t *data, size_t dataSize, const PmuConfig &config,
     data[bytes_used + 1] = static_cast<std::uint8_t>((config.digitalWordCount) & low_byte_mask);
     bytes_used += 2;
 
-    for (const auto& pn : config.phasorNames)
-    {
-        nameSize = std::min(pn.size(), static_cast<std::size_t>(channel_name_size));
-        memcpy(data+bytes_used, pn.data(), nameSize);
-        if (nameSize < channel_name_size)
-        {
-            memset(data + bytes_used + nameSize, 0, channel_name_size - nameSize);
-        }
-        bytes_used += channel_name_size;
-    }
-
-    for (const auto &an : config.analogNames)
-    {
-        nameSize = std::min(an.size(), static_cast<std::size_t>(channel_name_size));
-        memcpy(data + bytes_used, an.data(), nameSize);
-        if (nameSize < channel_name_size)
-        {
-            memset(data + bytes_used + nameSize, 0, channel_name_size - nameSize);
-        }
-        bytes_used += channel_name_size;
-    }
-
-    for (const auto &an : config.digitChannelNames)
-    {
-        nameSize = std::min(an.size(), static_cast<std::size_t>(channel_name_size));
-        memcpy(data + bytes_used, an.data(), nameSize);
-        if (nameSize < channel_name_size)
-        {
-            memset(data + bytes_used + nameSize, 0, channel_name_size - nameSize);
-        }
-        bytes_used += channel_name_size;
-    }
+    bytes_used += addChannelNames(data + bytes_used, config.phasorNames, config.phasorCount);
+    bytes_used += addChannelNames(data + bytes_used, config.analogNames, config.analogCount);
+    bytes_used += addChannelNames(data + bytes_used, config.digitChannelNames, config.digitalWordCount * 16U);
 
     for (int ii = 0; ii < config.phasorCount; ++ii)
     {
@@ -735,136 +842,186 @@ std::uint16_t generateConfig2(std::uint8_t *data, size_t dataSize, const Config
 
 std::uint16_t generateConfig3(std::uint8_t *data, size_t dataSize, const Config &config) { return 0; }
 
-static std::uint16_t generatePmuDataFrame(std::uint8_t *data,
-                                const PmuConfig &config,
-                                const PmuData &pmuData)
+template <PhasorEncoding Encoding>
+static void encodePhasors(std::uint8_t *phasorData, const PmuBlockLayout &block, const std::complex<double> *phasors)
 {
-    std::uint16_t bytes_used{0U};
-    auto stat = htons(pmuData.stat);
-    memcpy(data, &stat, sizeof(std::uint16_t));
-    bytes_used += 2;
-    for (size_t ii=0;ii<config.phasorCount;++ii)
+    const double *inverseScale = block.phasorInverseScale.data();
+    if constexpr (Encoding == PhasorEncoding::integer_rectangular)
     {
-        if (config.phasorFormat == integer_format)
+        if (block.phasorCount >= kernel_minimum_channels)
         {
-            if (config.phasorCoordinates == rectangular_phasor)
-            {
-                std::int16_t real = static_cast<int16_t>(static_cast<double>(pmuData.phasors[ii].real()) * 1e5 /
-                             static_cast<double>(config.phasorConversion[ii]));
-                std::int16_t imag = static_cast<int16_t>(static_cast<double>(pmuData.phasors[ii].imag()) * 1e5 /
-                             static_cast<double>(config.phasorConversion[ii]));
-
-                real = static_cast<std::int16_t>(ntohs(static_cast<std::uint16_t>(real)));
-                imag = static_cast<std::int16_t>(ntohs(static_cast<std::uint16_t>(imag)));
-                std::memcpy(data + bytes_used, &real,sizeof(std::int16_t));
-                
-            }
-            else
-            {
-                std::uint16_t mag = static_cast<uint16_t>(static_cast<double>(std::abs(pmuData.phasors[ii])) * 1e5 /
-                                                         static_cast<double>(config.phasorConversion[ii]));
-                std::int16_t angle = static_cast<int16_t>(static_cast<double>(std::arg(pmuData.phasors[ii])) * 1e4);
-
-                mag = ntohs(mag);
-                angle = static_cast<std::int16_t>(ntohs(static_cast<std::uint16_t>(angle)));
-                std::memcpy(data + bytes_used, &mag, sizeof(std::uint16_t));
-                std::memcpy(data + bytes_used + sizeof(std::uint16_t), &angle, sizeof(std::int16_t));
-
-            }
-            bytes_used += 2*sizeof(std::int16_t);
+            encodeInt16Pairs(complexParts(phasors), block.phasorCount, inverseScale, phasorData);
+            return;
         }
-        else
+        for (std::size_t ii = 0; ii < block.phasorCount; ++ii, phasorData += 4)
         {
-            if (config.phasorCoordinates == rectangular_phasor)
-            {
-                auto real = htonf(pmuData.phasors[ii].real());
-
-                auto imag = htonf(pmuData.phasors[ii].imag());
-                std::memcpy(data+bytes_used, &real, sizeof(float));
-                std::memcpy(data + bytes_used + sizeof(float) , &imag, sizeof(float));
-            }
-            else
-            {
-                auto mag = htonf(std::abs(pmuData.phasors[ii]));
-
-                auto angle = htonf(std::arg(pmuData.phasors[ii]));
-                std::memcpy(data + bytes_used, &mag, sizeof(float));
-                std::memcpy(data + bytes_used + sizeof(float), &angle, sizeof(float));
-            }
-            bytes_used += 2 * sizeof(float);
+            writeUInt16(phasorData, toInt16(phasors[ii].real() * inverseScale[ii]));
+            writeUInt16(phasorData + 2, toInt16(phasors[ii].imag() * inverseScale[ii]));
+        }
+    }
+    else if constexpr (Encoding == PhasorEncoding::integer_polar)
+    {
+        for (std::size_t ii = 0; ii < block.phasorCount; ++ii, phasorData += 4)
+        {
+            writeUInt16(phasorData, toUInt16(std::abs(phasors[ii]) * inverseScale[ii]));
+            writeUInt16(phasorData + 2, toInt16(std::arg(phasors[ii]) / integer_angle_scale));
         }
     }
-    if (config.freqFormat==floating_point_format)
+    else if constexpr (Encoding == PhasorEncoding::float_rectangular)
     {
-        auto freq = htonf(pmuData.freq);
-        auto rocof = htonf(pmuData.rocof);
-        std::memcpy(data + bytes_used, &freq, sizeof(float));
-        std::memcpy(data + bytes_used + sizeof(float), &rocof, sizeof(float));
-        bytes_used += 2 * sizeof(float);
+        if (block.phasorCount >= kernel_minimum_channels)
+        {
+            encodeFloats(complexParts(phasors), 2U * block.phasorCount, phasorData);
+            return;
+        }
+        for (std::size_t ii = 0; ii < block.phasorCount; ++ii, phasorData += 8)
+        {
+            writeFloat(phasorData, phasors[ii].real());
+            writeFloat(phasorData + 4, phasors[ii].imag());
+        }
     }
     else
     {
-        std::int16_t freq = static_cast<int16_t>(static_cast<double>(pmuData.freq) * 1000.0);
-        std::int16_t rocof = static_cast<int16_t>(static_cast<double>(pmuData.rocof) * 1000.0);
-        
-        freq = static_cast<std::int16_t>(htons(static_cast<std::uint16_t>(freq)));
-        rocof = static_cast<std::int16_t>(htons(static_cast<std::uint16_t>(rocof)));
+        for (std::size_t ii = 0; ii < block.phasorCount; ++ii, phasorData += 8)
+        {
+            writeFloat(phasorData, std::abs(phasors[ii]));
+            writeFloat(phasorData + 4, std::arg(phasors[ii]));
+        }
+    }
+}
+
+/* encoder for a single combination of phasor, frequency, and analog formats,  the counterpart of parsePmuData*/
+template <PhasorEncoding Encoding, std::uint8_t FreqFormat, std::uint8_t AnalogFormat>
+static void generatePmuDataFrame(std::uint8_t *data, const PmuBlockLayout &block, const PmuData &pmuData)
+{
+    writeUInt16(data + block.offset, pmuData.stat);
 
-        std::memcpy(data + bytes_used, &freq, sizeof(freq));
+    encodePhasors<Encoding>(data + block.phasorOffset, block, pmuData.phasors.data());
 
-        std::memcpy(data + bytes_used+sizeof(std::int16_t), &rocof, sizeof(rocof));
-        
-        bytes_used += 2*sizeof(std::int16_t);
+    std::uint8_t *freqData = data + block.freqOffset;
+    if constexpr (FreqFormat == floating_point_format)
+    {
+        writeFloat(freqData, pmuData.freq);
+        writeFloat(freqData + 4, pmuData.rocof);
+    }
+    else
+    {
+        writeUInt16(freqData, toInt16(pmuData.freq / integer_frequency_scale));
+        writeUInt16(freqData + 2, toInt16(pmuData.rocof / integer_frequency_scale));
     }
 
-    for (int ii = 0; ii < config.analogCount; ++ii)
+    const auto *analog = pmuData.analog.data();
+    std::uint8_t *analogData = data + block.analogOffset;
+    if constexpr (AnalogFormat == floating_point_format)
     {
-        if (config.analogFormat == floating_point_format)
+        if (block.analogCount >= kernel_minimum_channels)
         {
-            auto analog = htonf(pmuData.analog[ii]);
-            std::memcpy(data + bytes_used, &analog, sizeof(float));
-            bytes_used += sizeof(float);
+            encodeFloats(analog, block.analogCount, analogData);
         }
         else
         {
-            std::int16_t analog = static_cast<std::int16_t>(pmuData.analog[ii]);
-            analog = static_cast<std::int16_t>(htons(static_cast<std::uint16_t>(analog)));
-              
-            std::memcpy(data + bytes_used,&analog,sizeof(analog));
-            
-            bytes_used += sizeof(analog);
+            for (std::size_t ii = 0; ii < block.analogCount; ++ii, analogData += 4)
+            {
+                writeFloat(analogData, analog[ii]);
+            }
+        }
+    }
+    else
+    {
+        for (std::size_t ii = 0; ii < block.analogCount; ++ii, analogData += 2)
+        {
+            writeUInt16(analogData, toInt16(analog[ii]));
         }
     }
 
-    for (int ii = 0; ii < config.digitalWordCount; ++ii)
+    const auto *digital = pmuData.digital.data();
+    std::uint8_t *digitalData = data + block.digitalOffset;
+    for (std::size_t ii = 0; ii < block.digitalWordCount; ++ii, digitalData += 2)
     {
-        
-        auto dword = htons(pmuData.digital[ii]);
-        std::memcpy(data + bytes_used,&dword, sizeof(std::uint16_t));
-        bytes_used += sizeof(std::uint16_t);
+        writeUInt16(digitalData, digital[ii]);
+    }
+}
+
+/* the specialized codecs indexed by [phasor encoding][frequency format][analog format]*/
+template <PhasorEncoding Encoding, class Value>
+static constexpr BasicPmuDecoder<Value> pmu_decoders[2][2]{
+  {parsePmuData<Encoding, integer_format, integer_format, Value>,
+   parsePmuData<Encoding, integer_format, floating_point_format, Value>},
+  {parsePmuData<Encoding, floating_point_format, integer_format, Value>,
+   parsePmuData<Encoding, floating_point_format, floating_point_format, Value>}};
+
+template <PhasorEncoding Encoding>
+static constexpr ColumnPmuDecoder pmu_column_decoders[2][2]{
+  {parsePmuColumns<Encoding, integer_format, integer_format>,
+   parsePmuColumns<Encoding, integer_format, floating_point_format>},
+  {parsePmuColumns<Encoding, floating_point_format, integer_format>,
+   parsePmuColumns<Encoding, floating_point_format, floating_point_format>}};
+
+template <PhasorEncoding Encoding>
+static constexpr PmuEncoder pmu_encoders[2][2]{
+  {generatePmuDataFrame<Encoding, integer_format, integer_format>,
+   generatePmuDataFrame<Encoding, integer_format, floating_point_format>},
+  {generatePmuDataFrame<Encoding, floating_point_format, integer_format>,
+   generatePmuDataFrame<Encoding, floating_point_format, floating_point_format>}};
+
+void assignPmuCodec(PmuBlockLayout &block)
+{
+    const auto freq = static_cast<std::size_t>(block.freqFormat & 1U);
+    const auto analog = static_cast<std::size_t>(block.analogFormat & 1U);
+    switch (block.phasorEncoding)
+    {
+    case PhasorEncoding::integer_rectangular:
+        block.decoder = pmu_decoders<PhasorEncoding::integer_rectangular, double>[freq][analog];
+        block.compactDecoder = pmu_decoders<PhasorEncoding::integer_rectangular, float>[freq][analog];
+        block.columnDecoder = pmu_column_decoders<PhasorEncoding::integer_rectangular>[freq][analog];
+        block.encoder = pmu_encoders<PhasorEncoding::integer_rectangular>[freq][analog];
+        break;
+    case PhasorEncoding::integer_polar:
+        block.decoder = pmu_decoders<PhasorEncoding::integer_polar, double>[freq][analog];
+        block.compactDecoder = pmu_decoders<PhasorEncoding::integer_polar, float>[freq][analog];
+        block.columnDecoder = pmu_column_decoders<PhasorEncoding::integer_polar>[freq][analog];
+        block.encoder = pmu_encoders<PhasorEncoding::integer_polar>[freq][analog];
+        break;
+    case PhasorEncoding::float_rectangular:
+        block.decoder = pmu_decoders<PhasorEncoding::float_rectangular, double>[freq][analog];
+        block.compactDecoder = pmu_decoders<PhasorEncoding::float_rectangular, float>[freq][analog];
+        block.columnDecoder = pmu_column_decoders<PhasorEncoding::float_rectangular>[freq][analog];
+        block.encoder = pmu_encoders<PhasorEncoding::float_rectangular>[freq][analog];
+        break;
+    case PhasorEncoding::float_polar:
+        block.decoder = pmu_decoders<PhasorEncoding::float_polar, double>[freq][analog];
+        block.compactDecoder = pmu_decoders<PhasorEncoding::float_polar, float>[freq][analog];
+        block.columnDecoder = pmu_column_decoders<PhasorEncoding::float_polar>[freq][analog];
+        block.encoder = pmu_encoders<PhasorEncoding::float_polar>[freq][analog];
+        break;
     }
-    return bytes_used;
 }
 
-    std::uint16_t
+std::uint16_t
 generateDataFrame(std::uint8_t *data, size_t dataSize, const Config &config, const PmuDataFrame &frame)
 {
-    std::uint16_t bytes_used{common_frame_size};
-    if (dataSize < getExpectedDataPacketLength(config))
+    return generateDataFrame(data, dataSize, config, getFrameLayout(config), frame);
+}
+
+std::uint16_t generateDataFrame(std::uint8_t *data,
+                                size_t dataSize,
+                                const Config &config,
+                                const FrameLayout &layout,
+                                const PmuDataFrame &frame)
+{
+    if (dataSize < layout.frameSize || frame.pmus.size() < layout.pmus.size())
     {
         return 0;
     }
     generateCommonFrame(data, static_cast<std::uint16_t>(dataSize), config, PmuPacketType::data);
-    addTime(data, frame.soc, frame.fracSec, frame.timeQuality, config);
-    for (size_t ii=0;ii<frame.pmus.size();++ii)
+    addTime(data, frame, config);
+    for (std::size_t ii = 0; ii < layout.pmus.size(); ++ii)
     {
-        bytes_used +=
-          generatePmuDataFrame(data + bytes_used, config.pmus[ii], frame.pmus[ii]);
+        layout.pmus[ii].encoder(data, layout.pmus[ii], frame.pmus[ii]);
     }
-    bytes_used += 2;
-    addSize(data, bytes_used);
-    addCRC(data, bytes_used);
-    return bytes_used;
+    addSize(data, layout.frameSize);
+    addCRC(data, layout.frameSize);
+    return layout.frameSize;
 }
 
 std::uint16_t generateHeader(std::uint8_t *data, size_t dataSize, const std::string &header, const Config &config)
@@ -911,18 +1068,44 @@ std::uint16_t generateCommand(std::uint8_t *data, size_t dataSize, PmuCommand co
     return commandSize;
 }
 
+static constexpr std::int64_t nanoseconds_per_second{1'000'000'000};
+
+TimeCode toTimeCode(std::chrono::nanoseconds tp, std::uint32_t timeBase)
+{
+    auto seconds = tp.count() / nanoseconds_per_second;
+    auto frac = tp.count() % nanoseconds_per_second;
+    if (frac < 0)
+    {
+        frac += nanoseconds_per_second;
+        --seconds;
+    }
+    TimeCode code;
+    code.soc = static_cast<std::uint32_t>(seconds);
+    // frac < 1e9 and timeBase < 2^24 so the product fits in 64 bits
+    code.ticks = static_cast<std::uint32_t>((static_cast<std::uint64_t>(frac) * timeBase) /
+                                            static_cast<std::uint64_t>(nanoseconds_per_second));
+    return code;
+}
+
+std::chrono::nanoseconds toNanoseconds(std::uint32_t soc, std::uint32_t ticks, std::uint32_t timeBase)
+{
+    std::int64_t frac{0};
+    if (timeBase != 0U)
+    {
+        const auto scaled = static_cast<std::uint64_t>(ticks) * static_cast<std::uint64_t>(nanoseconds_per_second);
+        frac = static_cast<std::int64_t>((scaled + timeBase - 1U) / timeBase);
+    }
+    return std::chrono::nanoseconds(static_cast<std::int64_t>(soc) * nanoseconds_per_second + frac);
+}
+
 std::pair<std::uint32_t, std::uint32_t> generateTimeCodes(std::chrono::nanoseconds tp,
                                                           std::uint32_t timeBase,
                                                           float tolerance)
 {
-    auto secondsUTC = std::chrono::duration_cast<std::chrono::seconds>(tp).count();
+    const auto code = toTimeCode(tp, timeBase);
     std::pair<std::uint32_t, std::uint32_t> res;
-    res.first = static_cast<std::uint32_t>(secondsUTC);
-
-    auto frac = tp - std::chrono::duration_cast<std::chrono::seconds>(tp);
-
-    double frsec = static_cast<double>(frac.count()) / 1e9;
-    res.second = (static_cast<std::uint32_t>(frsec * static_cast<double>(timeBase)) & 0x00FFFFFFU);
+    res.first = code.soc;
+    res.second = code.ticks & 0x00FFFFFFU;
 
     auto tqcode = getTimeQualityCode(tolerance);
 
@@ -8,11 +8,24 @@ the top-level NOTICE for additional details. All rights reserved. SPDX-License-I
 #include <cstdint>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <initializer_list>
+#include <type_traits>
 #include <complex>
 #include <chrono>
+#include <memory>
+#include <memory_resource>
 
 namespace c37118
 {
+class FrameLayout;
+
+/** the allocator used by the containers of the configuration and data frame types
+@details every type holding containers accepts an allocator in its constructors so a set of objects can be
+allocated from a single memory resource such as a FrameArena,  copies made without an allocator use the default
+resource*/
+using FrameAllocator = std::pmr::polymorphic_allocator<std::byte>;
+
 static constexpr std::uint8_t sync_lead{0xAA};
 static constexpr std::uint8_t data_frame_code{0b0000'0000};
 static constexpr std::uint8_t config1_code{0b0010'0000};
@@ -92,8 +105,12 @@ static constexpr std::uint8_t integer_format{0U};
 static constexpr std::uint8_t floating_point_format{1U};
 static constexpr std::uint8_t rectangular_phasor{0U};
 static constexpr std::uint8_t polar_phasor{1U};
+/** the STAT data error value (bits 15-14 = 10) marking the data of a PMU as invalid*/
+static constexpr std::uint16_t stat_data_invalid{0x8000U};
 
 static constexpr std::uint16_t common_frame_size{14U};
+/** the largest frame the 16 bit FRAMESIZE field can describe*/
+static constexpr std::uint16_t max_frame_size{65535U};
 static constexpr std::uint16_t min_packet_size{18U};
 static constexpr std::uint16_t channel_name_size{16U};
 
@@ -115,9 +132,62 @@ enum class AnalogType : std::uint8_t
     peak_disabled = 0b1000'0010
 };
 
+/** the names of a set of channels stored in a single string of fixed size slots
+@details each name occupies channel_name_size bytes as it does in a configuration frame so a table is copied
+from and to a frame as a block,  names longer than channel_name_size are truncated and shorter names are padded
+with 0 which is not part of the name returned*/
+class ChannelNameTable
+{
+  public:
+    using allocator_type = FrameAllocator;
+
+    ChannelNameTable() = default;
+    explicit ChannelNameTable(const allocator_type &alloc): mTable(alloc) {}
+    ChannelNameTable(std::initializer_list<std::string_view> names, const allocator_type &alloc = {});
+    ChannelNameTable(const ChannelNameTable &other) = default;
+    ChannelNameTable(ChannelNameTable &&other) = default;
+    ChannelNameTable(const ChannelNameTable &other, const allocator_type &alloc): mTable(other.mTable, alloc) {}
+    ChannelNameTable(ChannelNameTable &&other, const allocator_type &alloc):
+        mTable(std::move(other.mTable), alloc)
+    {
+    }
+    ChannelNameTable &operator=(const ChannelNameTable &other) = default;
+    ChannelNameTable &operator=(ChannelNameTable &&other) = default;
+    allocator_type get_allocator() const { return mTable.get_allocator(); }
+
+    std::size_t size() const { return mTable.size() / channel_name_size; }
+    bool empty() const { return mTable.empty(); }
+    std::string_view operator[](std::size_t index) const;
+    /** add a name to the end of the table*/
+    void push_back(std::string_view name);
+    /** change the number of names,  new names are empty*/
+    void resize(std::size_t count) { mTable.resize(count * channel_name_size, '\0'); }
+    void clear() { mTable.clear(); }
+    void assign(std::size_t index, std::string_view name);
+    /** load a number of names from the consecutive name fields of a configuration frame*/
+    void assignFields(const std::uint8_t *data, std::size_t count);
+    /** the names as consecutive name fields of a configuration frame*/
+    const char *fields() const { return mTable.data(); }
+
+  private:
+    std::pmr::string mTable;
+};
+
 class PmuConfig
 {
   public:
+    using allocator_type = FrameAllocator;
+
+    PmuConfig() = default;
+    explicit PmuConfig(const allocator_type &alloc);
+    PmuConfig(const PmuConfig &other) = default;
+    PmuConfig(PmuConfig &&other) = default;
+    PmuConfig(const PmuConfig &other, const allocator_type &alloc): PmuConfig(alloc) { *this = other; }
+    PmuConfig(PmuConfig &&other, const allocator_type &alloc): PmuConfig(alloc) { *this = std::move(other); }
+    PmuConfig &operator=(const PmuConfig &other) = default;
+    PmuConfig &operator=(PmuConfig &&other) = default;
+    allocator_type get_allocator() const { return phasorType.get_allocator(); }
+
     std::uint16_t sourceID;
     std::uint8_t pmuClass;
     std::uint8_t phasorFormat : 1;
@@ -127,15 +197,15 @@ class PmuConfig
     std::uint16_t phasorCount{0U};
     std::uint16_t analogCount{0U};
     std::uint16_t digitalWordCount{0U};
-    std::vector<std::string> phasorNames;
-    std::vector<std::string> analogNames;
-    std::vector<std::string> digitChannelNames;
-    std::vector<PhasorType> phasorType;
-    std::vector<std::uint32_t> phasorConversion;
-    std::vector<AnalogType> analogType;
-    std::vector<std::int32_t> analogConversion;
-    std::vector<std::uint16_t> digitalNominal;
-    std::vector<std::uint16_t> digitalActive;
+    ChannelNameTable phasorNames;
+    ChannelNameTable analogNames;
+    ChannelNameTable digitChannelNames;  //!< 16 names for each digital word
+    std::pmr::vector<PhasorType> phasorType;
+    std::pmr::vector<std::uint32_t> phasorConversion;
+    std::pmr::vector<AnalogType> analogType;
+    std::pmr::vector<std::int32_t> analogConversion;
+    std::pmr::vector<std::uint16_t> digitalNominal;
+    std::pmr::vector<std::uint16_t> digitalActive;
     float nominalFrequency{60.0};
     
     float lat;
@@ -146,18 +216,34 @@ class PmuConfig
     bool active{true};
     std::uint32_t window;
     std::uint32_t grpDelay;
-    std::string stationName;
+    std::pmr::string stationName;
 };
 
 class Config
 {
   public:
+    using allocator_type = FrameAllocator;
+
+    Config() = default;
+    explicit Config(const allocator_type &alloc): pmus(alloc) {}
+    Config(const Config &other) = default;
+    Config(Config &&other) = default;
+    Config(const Config &other, const allocator_type &alloc): Config(alloc) { *this = other; }
+    Config(Config &&other, const allocator_type &alloc): Config(alloc) { *this = std::move(other); }
+    Config &operator=(const Config &other) = default;
+    Config &operator=(Config &&other) = default;
+    allocator_type get_allocator() const { return pmus.get_allocator(); }
+
     std::uint16_t idcode{0};
     std::int16_t dataRate{default_data_rate};
     std::uint32_t soc;
     std::uint32_t fracsec;
     std::uint32_t timeBase{default_time_base};
-    std::vector<PmuConfig> pmus;
+    std::pmr::vector<PmuConfig> pmus;
+    /** precompiled data frame layout,  generated when a configuration is parsed or loaded
+    @details call updateFrameLayout after building a configuration or modifying its pmus,  a layout which no longer
+    matches is not used and the frames are decoded and encoded with a layout compiled for the calling thread instead*/
+    std::shared_ptr<const FrameLayout> layout;
 };
 
 class TimeQuality
@@ -174,31 +260,166 @@ class TimeQuality
 
 TimeQuality parseTimeQuality(std::uint8_t tq);
 
-class PmuData
+/** the decoded data of a single PMU
+@details Value is the type used for the phasors, frequency, and analog values,  double for PmuData and float for
+CompactPmuData.  The wire values are at most float32 so the compact form loses only the precision of scaled
+integer values beyond 24 bits*/
+template <class Value>
+class BasicPmuData
 {
   public:
-   
-    std::uint16_t stat;
-    double freq;
-    double rocof;
-    std::vector<std::complex<double>> phasors;
-    std::vector<double> analog;
-    std::vector<std::uint16_t> digital;
+    using allocator_type = FrameAllocator;
+    using value_type = Value;
+
+    BasicPmuData() = default;
+    explicit BasicPmuData(const allocator_type &alloc): phasors(alloc), analog(alloc), digital(alloc) {}
+    BasicPmuData(const BasicPmuData &other) = default;
+    BasicPmuData(BasicPmuData &&other) = default;
+    BasicPmuData(const BasicPmuData &other, const allocator_type &alloc): BasicPmuData(alloc) { *this = other; }
+    BasicPmuData(BasicPmuData &&other, const allocator_type &alloc): BasicPmuData(alloc)
+    {
+        *this = std::move(other);
+    }
+    /** convert data of a different precision*/
+    template <class Other, class = std::enable_if_t<!std::is_same_v<Other, Value>>>
+    explicit BasicPmuData(const BasicPmuData<Other> &other, const allocator_type &alloc = {}): BasicPmuData(alloc)
+    {
+        convertFrom(other);
+    }
+    BasicPmuData &operator=(const BasicPmuData &other) = default;
+    BasicPmuData &operator=(BasicPmuData &&other) = default;
+    allocator_type get_allocator() const { return phasors.get_allocator(); }
+
+    /** convert the values of data of a different precision reusing the existing storage*/
+    template <class Other>
+    void convertFrom(const BasicPmuData<Other> &other)
+    {
+        stat = other.stat;
+        freq = static_cast<Value>(other.freq);
+        rocof = static_cast<Value>(other.rocof);
+        phasors.resize(other.phasors.size());
+        for (std::size_t ii = 0; ii < phasors.size(); ++ii)
+        {
+            phasors[ii] = static_cast<std::complex<Value>>(other.phasors[ii]);
+        }
+        analog.resize(other.analog.size());
+        for (std::size_t ii = 0; ii < analog.size(); ++ii)
+        {
+            analog[ii] = static_cast<Value>(other.analog[ii]);
+        }
+        digital.assign(other.digital.begin(), other.digital.end());
+    }
 
+    std::uint16_t stat;
+    Value freq;
+    Value rocof;
+    std::pmr::vector<std::complex<Value>> phasors;
+    std::pmr::vector<Value> analog;
+    std::pmr::vector<std::uint16_t> digital;
 };
 
-class PmuDataFrame
+/** a decoded data frame with the measurements of each PMU stored as Value
+@details the time fields are the same for all precisions*/
+template <class Value>
+class BasicPmuDataFrame
 {
   public:
+    using allocator_type = FrameAllocator;
+    using value_type = Value;
+
+    BasicPmuDataFrame() = default;
+    explicit BasicPmuDataFrame(const allocator_type &alloc): pmus(alloc) {}
+    BasicPmuDataFrame(const BasicPmuDataFrame &other) = default;
+    BasicPmuDataFrame(BasicPmuDataFrame &&other) = default;
+    BasicPmuDataFrame(const BasicPmuDataFrame &other, const allocator_type &alloc): BasicPmuDataFrame(alloc)
+    {
+        *this = other;
+    }
+    BasicPmuDataFrame(BasicPmuDataFrame &&other, const allocator_type &alloc): BasicPmuDataFrame(alloc)
+    {
+        *this = std::move(other);
+    }
+    /** convert a frame of a different precision*/
+    template <class Other, class = std::enable_if_t<!std::is_same_v<Other, Value>>>
+    explicit BasicPmuDataFrame(const BasicPmuDataFrame<Other> &other, const allocator_type &alloc = {}):
+        BasicPmuDataFrame(alloc)
+    {
+        convertFrom(other);
+    }
+    BasicPmuDataFrame &operator=(const BasicPmuDataFrame &other) = default;
+    BasicPmuDataFrame &operator=(BasicPmuDataFrame &&other) = default;
+    allocator_type get_allocator() const { return pmus.get_allocator(); }
+
+    /** convert a frame of a different precision reusing the existing storage*/
+    template <class Other>
+    void convertFrom(const BasicPmuDataFrame<Other> &other)
+    {
+        idcode = other.idcode;
+        timeQuality = other.timeQuality;
+        parseResult = other.parseResult;
+        soc = other.soc;
+        fracSec = other.fracSec;
+        fracSecTicks = other.fracSecTicks;
+        tickTimeBase = other.tickTimeBase;
+        exactTime = other.exactTime;
+        pmus.resize(other.pmus.size());
+        for (std::size_t ii = 0; ii < pmus.size(); ++ii)
+        {
+            pmus[ii].convertFrom(other.pmus[ii]);
+        }
+    }
+
     std::uint16_t idcode;
     std::uint8_t timeQuality;
     ParseResult parseResult{ParseResult::not_parsed};
     std::uint32_t soc;
     double fracSec;
-    
-    std::vector<PmuData> pmus;
+    /** the FRACSEC count in units of 1/tickTimeBase
+    @details set by parseDataFrame and setFrameTime,  when exactTime is true generateDataFrame encodes this count
+    instead of converting fracSec,  rescaled if the configuration has a different time base.  Code which sets
+    fracSec without the count must clear exactTime so fracSec is encoded instead*/
+    std::uint32_t fracSecTicks{0U};
+    std::uint32_t tickTimeBase{0U};  //!< the time base of fracSecTicks,  0 for the time base of the configuration
+    bool exactTime{false};
+
+    std::pmr::vector<BasicPmuData<Value>> pmus;
 };
 
+using PmuData = BasicPmuData<double>;
+using PmuDataFrame = BasicPmuDataFrame<double>;
+/** float32 storage for frames kept in bulk,  half the memory of PmuData*/
+using CompactPmuData = BasicPmuData<float>;
+using CompactPmuDataFrame = BasicPmuDataFrame<float>;
+
+/** a time as a second of century and a count of 1/timeBase fractions of the second*/
+class TimeCode
+{
+  public:
+    std::uint32_t soc{0U};
+    std::uint32_t ticks{0U};
+};
+
+/** convert a time since the epoch into a second of century and fraction of second count
+@details uses only integer arithmetic,  the count is truncated toward the start of the second*/
+TimeCode toTimeCode(std::chrono::nanoseconds tp, std::uint32_t timeBase);
+
+/** convert a second of century and fraction of second count into a time since the epoch
+@details the result is the first nanosecond at which the count applies so toTimeCode of the result returns the
+same count*/
+std::chrono::nanoseconds toNanoseconds(std::uint32_t soc, std::uint32_t ticks, std::uint32_t timeBase);
+
+/** set the time of a frame from a second of century and fraction of second count
+@details sets both fracSec and fracSecTicks and marks the frame time as exact*/
+template <class Value>
+void setFrameTime(BasicPmuDataFrame<Value> &frame, std::uint32_t soc, std::uint32_t ticks, std::uint32_t timeBase)
+{
+    frame.soc = soc;
+    frame.fracSecTicks = ticks;
+    frame.tickTimeBase = timeBase;
+    frame.fracSec = static_cast<double>(ticks) / static_cast<double>(timeBase);
+    frame.exactTime = true;
+}
+
 PmuPacketType getPacketType(const std::uint8_t *data, size_t dataSize);
 
 std::uint16_t getIdCode(const std::uint8_t *data, size_t dataSize);
@@ -221,6 +442,19 @@ std::string getExtendedData(const std::uint8_t *data, size_t dataSize);
 
 PmuDataFrame parseDataFrame(const std::uint8_t *data, size_t dataSize, const Config &config);
 
+/** parse a data frame into an existing frame object
+@details the storage of frame is reused so once a frame has been parsed with the same configuration no further
+allocations are made
+@return the parse result,  also stored in frame.parseResult
+*/
+ParseResult parseDataFrame(const std::uint8_t *data, size_t dataSize, const Config &config, PmuDataFrame &frame);
+
+/** parse a data frame directly into float32 storage
+@details behaves as the PmuDataFrame overload,  values are converted from the wire format to float without an
+intermediate double frame*/
+ParseResult
+  parseDataFrame(const std::uint8_t *data, size_t dataSize, const Config &config, CompactPmuDataFrame &frame);
+
 std::uint16_t generateConfig1(std::uint8_t *data, size_t dataSize, const Config &config);
 
 std::uint16_t generateConfig2(std::uint8_t *data, size_t dataSize, const Config &config);
@@ -237,10 +471,8 @@ std::pair<std::uint32_t, std::uint32_t> generateTimeCodes(std::chrono::nanosecon
                                                           std::uint32_t timeBase = 10'000'000,
                                                           float tolerance = 0.0f );
 
-  inline std::pair<std::uint32_t, std::uint32_t>
-generateTimeCodes(std::chrono::nanoseconds tp,
-                                                          const Config &config,
-                                                          double tolerance = 0.0f)
+inline std::pair<std::uint32_t, std::uint32_t>
+generateTimeCodes(std::chrono::nanoseconds tp, const Config &config, double tolerance = 0.0f)
 {
     return generateTimeCodes(tp, config.timeBase, tolerance);
 }
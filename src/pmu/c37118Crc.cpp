@@ -0,0 +1,215 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "c37118Crc.h"
+
+#include "CpuFeatures.hpp"
+#include <array>
+
+#if defined(HELICS_PMU_X86)
+#include <immintrin.h>
+#endif
+
+namespace c37118
+{
+namespace crc
+{
+    static constexpr std::uint32_t crc_polynomial{0x11021U};
+
+    using CrcTables = std::array<std::array<std::uint16_t, 256>, 8>;
+
+    /* table[k][b] is the crc of byte b followed by k zero bytes with a starting register of 0*/
+    static constexpr CrcTables generateTables()
+    {
+        CrcTables tables{};
+        for (std::uint32_t ii = 0; ii < 256; ++ii)
+        {
+            std::uint32_t crc = ii << 8U;
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                crc <<= 1U;
+                if ((crc & 0x10000U) != 0U)
+                {
+                    crc ^= crc_polynomial;
+                }
+            }
+            tables[0][ii] = static_cast<std::uint16_t>(crc);
+        }
+        for (std::size_t kk = 1; kk < 8; ++kk)
+        {
+            for (std::size_t ii = 0; ii < 256; ++ii)
+            {
+                const std::uint16_t prev = tables[kk - 1][ii];
+                tables[kk][ii] = static_cast<std::uint16_t>((prev << 8U) ^ tables[0][prev >> 8U]);
+            }
+        }
+        return tables;
+    }
+
+    static constexpr CrcTables crcTables = generateTables();
+
+    std::uint16_t bitwise(const std::uint8_t *data, std::size_t dataLength, std::uint16_t crc)
+    {
+        for (std::size_t ii = 0; ii < dataLength; ii++)
+        {
+            std::uint16_t calc1 = (crc >> 8) ^ data[ii];
+            crc <<= 8;
+            std::uint16_t calc2 = calc1 ^ (calc1 >> 4);
+            crc ^= calc2;
+            calc2 <<= 5;
+            crc ^= calc2;
+            calc2 <<= 7;
+            crc ^= calc2;
+        }
+        return crc;
+    }
+
+    std::uint16_t slice8(const std::uint8_t *data, std::size_t dataLength, std::uint16_t crc)
+    {
+        const auto &tb = crcTables;
+        while (dataLength >= 8)
+        {
+            crc = tb[7][(crc >> 8U) ^ data[0]] ^ tb[6][(crc & 0xFFU) ^ data[1]] ^ tb[5][data[2]] ^ tb[4][data[3]] ^
+              tb[3][data[4]] ^ tb[2][data[5]] ^ tb[1][data[6]] ^ tb[0][data[7]];
+            data += 8;
+            dataLength -= 8;
+        }
+        while (dataLength > 0)
+        {
+            crc = static_cast<std::uint16_t>((crc << 8U) ^ tb[0][(crc >> 8U) ^ *data]);
+            ++data;
+            --dataLength;
+        }
+        return crc;
+    }
+
+#if defined(HELICS_PMU_X86)
+    /* x^power mod P(x), used as the folding constants*/
+    static constexpr std::uint64_t xPowMod(unsigned int power)
+    {
+        std::uint32_t val{1U};
+        for (unsigned int ii = 0; ii < power; ++ii)
+        {
+            val <<= 1U;
+            if ((val & 0x10000U) != 0U)
+            {
+                val ^= crc_polynomial;
+            }
+        }
+        return val;
+    }
+
+    /* below this size the setup cost of the folding outweighs the benefit*/
+    static constexpr std::size_t clmul_minimum_length{64U};
+
+    /* load 16 bytes as a big endian 128 bit polynomial, the first byte holding the highest order terms*/
+    HELICS_PMU_TARGET("pclmul,ssse3")
+    static inline __m128i loadBlock(const std::uint8_t *data)
+    {
+        const __m128i swapMask = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), swapMask);
+    }
+
+    /* compute acc*x^N+block mod P where the constants hold x^(N+64) mod P in the high lane and x^N mod P in the
+     * low lane*/
+    HELICS_PMU_TARGET("pclmul,ssse3")
+    static inline __m128i fold(__m128i acc, __m128i constants, __m128i block)
+    {
+        const __m128i high = _mm_clmulepi64_si128(acc, constants, 0x11);
+        const __m128i low = _mm_clmulepi64_si128(acc, constants, 0x00);
+        return _mm_xor_si128(_mm_xor_si128(high, low), block);
+    }
+
+    template<unsigned int power>
+    HELICS_PMU_TARGET("pclmul,ssse3")
+    static inline __m128i foldConstants()
+    {
+        constexpr std::uint64_t high = xPowMod(power + 64U);
+        constexpr std::uint64_t low = xPowMod(power);
+        return _mm_set_epi64x(static_cast<long long>(high), static_cast<long long>(low));
+    }
+
+    HELICS_PMU_TARGET("pclmul,ssse3")
+    std::uint16_t clmul(const std::uint8_t *data, std::size_t dataLength, std::uint16_t crc)
+    {
+        if (dataLength < clmul_minimum_length)
+        {
+            return slice8(data, dataLength, crc);
+        }
+        // a starting register value is equivalent to xoring it into the first two bytes of the message
+        const __m128i initial = _mm_set_epi64x(static_cast<long long>(static_cast<std::uint64_t>(crc) << 48U), 0);
+        const std::uint8_t *block = data;
+        std::size_t blockCount = dataLength / 16U;
+        __m128i acc;
+        if (blockCount >= 8U)
+        {
+            // fold 4 independent streams to hide the multiplication latency
+            __m128i acc0 = _mm_xor_si128(loadBlock(block), initial);
+            __m128i acc1 = loadBlock(block + 16);
+            __m128i acc2 = loadBlock(block + 32);
+            __m128i acc3 = loadBlock(block + 48);
+            block += 64;
+            blockCount -= 4U;
+            const __m128i fold512 = foldConstants<512U>();
+            while (blockCount >= 4U)
+            {
+                acc0 = fold(acc0, fold512, loadBlock(block));
+                acc1 = fold(acc1, fold512, loadBlock(block + 16));
+                acc2 = fold(acc2, fold512, loadBlock(block + 32));
+                acc3 = fold(acc3, fold512, loadBlock(block + 48));
+                block += 64;
+                blockCount -= 4U;
+            }
+            acc = fold(acc0, foldConstants<384U>(), acc3);
+            acc = fold(acc1, foldConstants<256U>(), acc);
+            acc = fold(acc2, foldConstants<128U>(), acc);
+        }
+        else
+        {
+            acc = _mm_xor_si128(loadBlock(block), initial);
+            block += 16;
+            --blockCount;
+        }
+        const __m128i fold128 = foldConstants<128U>();
+        while (blockCount > 0U)
+        {
+            acc = fold(acc, fold128, loadBlock(block));
+            block += 16;
+            --blockCount;
+        }
+        // the folded value is congruent to the processed message so the table code can finish it
+        alignas(16) std::uint8_t folded[16];
+        const __m128i swapMask = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        _mm_store_si128(reinterpret_cast<__m128i *>(folded), _mm_shuffle_epi8(acc, swapMask));
+        const auto foldedCrc = slice8(folded, 16U, 0U);
+        return slice8(block, dataLength - static_cast<std::size_t>(block - data), foldedCrc);
+    }
+
+    bool clmulSupported()
+    {
+        const auto &features = pmu::cpuFeatures();
+        return features.pclmul && features.ssse3;
+    }
+#else
+    std::uint16_t clmul(const std::uint8_t *data, std::size_t dataLength, std::uint16_t crc)
+    {
+        return slice8(data, dataLength, crc);
+    }
+
+    bool clmulSupported() { return false; }
+#endif
+}  // namespace crc
+
+using CrcFunction = std::uint16_t (*)(const std::uint8_t *, std::size_t, std::uint16_t);
+
+static CrcFunction selectCrcFunction() { return crc::clmulSupported() ? crc::clmul : crc::slice8; }
+
+std::uint16_t crcCCITT(const std::uint8_t *data, std::size_t dataLength, std::uint16_t crc)
+{
+    static const CrcFunction crcFunction = selectCrcFunction();
+    return crcFunction(data, dataLength, crc);
+}
+}  // namespace c37118
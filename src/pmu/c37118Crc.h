@@ -0,0 +1,43 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/** @file
+CRC-CCITT calculation for C37.118 frames
+
+f(x) = x^16 + x^12 + x^5 + 1,  processed most significant bit first with an initial value of 0xFFFF
+and no final xor.  Several bit exact implementations are provided,  the fastest one supported by the processor
+is selected at runtime and used by crcCCITT
+*/
+namespace c37118
+{
+static constexpr std::uint16_t crc_initial_value{0xFFFF};
+
+/** compute the CRC over dataLength bytes
+@param data pointer to the bytes to process
+@param dataLength the number of bytes to include in the CRC
+@param crc the starting value of the crc register,  use a previous result to continue a calculation
+*/
+std::uint16_t crcCCITT(const std::uint8_t *data, std::size_t dataLength, std::uint16_t crc = crc_initial_value);
+
+namespace crc
+{
+    /** the one byte at a time shift and xor algorithm from the IEEE C37.118 sample code*/
+    std::uint16_t bitwise(const std::uint8_t *data, std::size_t dataLength, std::uint16_t crc);
+
+    /** table driven algorithm processing 8 bytes per step*/
+    std::uint16_t slice8(const std::uint8_t *data, std::size_t dataLength, std::uint16_t crc);
+
+    /** carry-less multiplication folding algorithm, only valid if clmulSupported() returns true*/
+    std::uint16_t clmul(const std::uint8_t *data, std::size_t dataLength, std::uint16_t crc);
+
+    /** check if the processor supports the carry-less multiplication algorithm*/
+    bool clmulSupported();
+}  // namespace crc
+}  // namespace c37118
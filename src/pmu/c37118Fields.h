@@ -0,0 +1,76 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+/** @file
+inline helpers for reading and writing the big endian fields of C37.118 frames
+*/
+namespace c37118
+{
+inline std::uint16_t readUInt16(const std::uint8_t *data)
+{
+    return static_cast<std::uint16_t>((static_cast<std::uint16_t>(data[0]) << 8U) + data[1]);
+}
+
+inline std::int16_t readInt16(const std::uint8_t *data) { return static_cast<std::int16_t>(readUInt16(data)); }
+
+inline std::uint32_t readUInt32(const std::uint8_t *data)
+{
+    return (static_cast<std::uint32_t>(data[0]) << 24U) | (static_cast<std::uint32_t>(data[1]) << 16U) |
+      (static_cast<std::uint32_t>(data[2]) << 8U) | static_cast<std::uint32_t>(data[3]);
+}
+
+inline float readFloat(const std::uint8_t *data)
+{
+    const std::uint32_t bits = readUInt32(data);
+    float val;
+    std::memcpy(&val, &bits, sizeof(float));
+    return val;
+}
+
+inline void writeUInt16(std::uint8_t *data, std::uint16_t val)
+{
+    data[0] = static_cast<std::uint8_t>(val >> 8U);
+    data[1] = static_cast<std::uint8_t>(val & 0xFFU);
+}
+
+inline void writeUInt32(std::uint8_t *data, std::uint32_t val)
+{
+    data[0] = static_cast<std::uint8_t>(val >> 24U);
+    data[1] = static_cast<std::uint8_t>((val >> 16U) & 0xFFU);
+    data[2] = static_cast<std::uint8_t>((val >> 8U) & 0xFFU);
+    data[3] = static_cast<std::uint8_t>(val & 0xFFU);
+}
+
+inline void writeFloat(std::uint8_t *data, double val)
+{
+    const auto fval = static_cast<float>(val);
+    std::uint32_t bits;
+    std::memcpy(&bits, &fval, sizeof(float));
+    writeUInt32(data, bits);
+}
+
+/** convert a scaled value to the bits of the nearest 16 bit signed integer,  saturating at the limits
+@details the comparisons match the vector min/max instructions so the vector kernels produce identical results*/
+inline std::uint16_t toInt16(double val)
+{
+    val = (val < 32767.0) ? val : 32767.0;
+    val = (val > -32768.0) ? val : -32768.0;
+    return static_cast<std::uint16_t>(static_cast<std::int16_t>(std::lrint(val)));
+}
+
+/** convert a scaled value to the nearest 16 bit unsigned integer,  saturating at the limits*/
+inline std::uint16_t toUInt16(double val)
+{
+    val = (val < 65535.0) ? val : 65535.0;
+    val = (val > 0.0) ? val : 0.0;
+    return static_cast<std::uint16_t>(std::lrint(val));
+}
+}  // namespace c37118
@@ -0,0 +1,421 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "c37118Kernels.h"
+
+#include "CpuFeatures.hpp"
+#include "c37118Fields.h"
+
+#if defined(HELICS_PMU_X86)
+#include <immintrin.h>
+#endif
+
+namespace c37118
+{
+namespace kernels
+{
+    namespace scalar
+    {
+        void decodeInt16Pairs(const std::uint8_t *data, std::size_t count, const double *scale, double *values)
+        {
+            for (std::size_t ii = 0; ii < count; ++ii, data += 4, values += 2)
+            {
+                values[0] = static_cast<double>(readInt16(data)) * scale[ii];
+                values[1] = static_cast<double>(readInt16(data + 2)) * scale[ii];
+            }
+        }
+
+        void decodeFloats(const std::uint8_t *data, std::size_t count, double *values)
+        {
+            for (std::size_t ii = 0; ii < count; ++ii, data += 4)
+            {
+                values[ii] = readFloat(data);
+            }
+        }
+
+        void
+          encodeInt16Pairs(const double *values, std::size_t count, const double *inverseScale, std::uint8_t *data)
+        {
+            for (std::size_t ii = 0; ii < count; ++ii, data += 4, values += 2)
+            {
+                writeUInt16(data, toInt16(values[0] * inverseScale[ii]));
+                writeUInt16(data + 2, toInt16(values[1] * inverseScale[ii]));
+            }
+        }
+
+        void encodeFloats(const double *values, std::size_t count, std::uint8_t *data)
+        {
+            for (std::size_t ii = 0; ii < count; ++ii, data += 4)
+            {
+                writeFloat(data, values[ii]);
+            }
+        }
+
+        std::size_t findByte(const std::uint8_t *data, std::size_t count, std::uint8_t value)
+        {
+            std::size_t ii = 0;
+            while (ii < count && data[ii] != value)
+            {
+                ++ii;
+            }
+            return ii;
+        }
+    }  // namespace scalar
+
+#if defined(HELICS_PMU_X86)
+    /* shuffle masks reversing the bytes of each 16 bit and 32 bit lane*/
+#define HELICS_PMU_SWAP16 _mm_set_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1)
+#define HELICS_PMU_SWAP32 _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3)
+
+    /* index of the lowest set bit of a non zero mask*/
+    static inline std::size_t firstSetBit(std::uint32_t mask)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return index;
+#else
+        return static_cast<std::size_t>(__builtin_ctz(mask));
+#endif
+    }
+
+    namespace sse41
+    {
+        HELICS_PMU_TARGET("sse4.1")
+        void decodeInt16Pairs(const std::uint8_t *data, std::size_t count, const double *scale, double *values)
+        {
+            const __m128i swap = HELICS_PMU_SWAP16;
+            std::size_t ii = 0;
+            for (; ii + 4 <= count; ii += 4, data += 16, values += 8)
+            {
+                const __m128i raw = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), swap);
+                const __m128i low = _mm_cvtepi16_epi32(raw);
+                const __m128i high = _mm_cvtepi16_epi32(_mm_srli_si128(raw, 8));
+                _mm_storeu_pd(values, _mm_mul_pd(_mm_cvtepi32_pd(low), _mm_set1_pd(scale[ii])));
+                _mm_storeu_pd(values + 2,
+                              _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(low, 8)), _mm_set1_pd(scale[ii + 1])));
+                _mm_storeu_pd(values + 4, _mm_mul_pd(_mm_cvtepi32_pd(high), _mm_set1_pd(scale[ii + 2])));
+                _mm_storeu_pd(values + 6,
+                              _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(high, 8)), _mm_set1_pd(scale[ii + 3])));
+            }
+            scalar::decodeInt16Pairs(data, count - ii, scale + ii, values);
+        }
+
+        HELICS_PMU_TARGET("sse4.1")
+        void decodeFloats(const std::uint8_t *data, std::size_t count, double *values)
+        {
+            const __m128i swap = HELICS_PMU_SWAP32;
+            std::size_t ii = 0;
+            for (; ii + 4 <= count; ii += 4, data += 16, values += 4)
+            {
+                const __m128 raw = _mm_castsi128_ps(
+                  _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), swap));
+                _mm_storeu_pd(values, _mm_cvtps_pd(raw));
+                _mm_storeu_pd(values + 2, _mm_cvtps_pd(_mm_movehl_ps(raw, raw)));
+            }
+            scalar::decodeFloats(data, count - ii, values);
+        }
+
+        HELICS_PMU_TARGET("sse4.1")
+        static inline __m128i scaleToInt32(const double *values, double inverseScale)
+        {
+            const __m128d scaled = _mm_mul_pd(_mm_loadu_pd(values), _mm_set1_pd(inverseScale));
+            const __m128d clamped =
+              _mm_max_pd(_mm_min_pd(scaled, _mm_set1_pd(32767.0)), _mm_set1_pd(-32768.0));
+            return _mm_cvtpd_epi32(clamped);
+        }
+
+        HELICS_PMU_TARGET("sse4.1")
+        void
+          encodeInt16Pairs(const double *values, std::size_t count, const double *inverseScale, std::uint8_t *data)
+        {
+            const __m128i swap = HELICS_PMU_SWAP16;
+            std::size_t ii = 0;
+            for (; ii + 4 <= count; ii += 4, data += 16, values += 8)
+            {
+                const __m128i low = _mm_unpacklo_epi64(scaleToInt32(values, inverseScale[ii]),
+                                                       scaleToInt32(values + 2, inverseScale[ii + 1]));
+                const __m128i high = _mm_unpacklo_epi64(scaleToInt32(values + 4, inverseScale[ii + 2]),
+                                                        scaleToInt32(values + 6, inverseScale[ii + 3]));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(data),
+                                 _mm_shuffle_epi8(_mm_packs_epi32(low, high), swap));
+            }
+            scalar::encodeInt16Pairs(values, count - ii, inverseScale + ii, data);
+        }
+
+        HELICS_PMU_TARGET("sse4.1")
+        void encodeFloats(const double *values, std::size_t count, std::uint8_t *data)
+        {
+            const __m128i swap = HELICS_PMU_SWAP32;
+            std::size_t ii = 0;
+            for (; ii + 4 <= count; ii += 4, data += 16, values += 4)
+            {
+                const __m128 floats =
+                  _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(values)), _mm_cvtpd_ps(_mm_loadu_pd(values + 2)));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(data),
+                                 _mm_shuffle_epi8(_mm_castps_si128(floats), swap));
+            }
+            scalar::encodeFloats(values, count - ii, data);
+        }
+
+        HELICS_PMU_TARGET("sse4.1")
+        std::size_t findByte(const std::uint8_t *data, std::size_t count, std::uint8_t value)
+        {
+            const __m128i target = _mm_set1_epi8(static_cast<char>(value));
+            std::size_t ii = 0;
+            for (; ii + 16 <= count; ii += 16)
+            {
+                const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + ii));
+                const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, target)));
+                if (mask != 0U)
+                {
+                    return ii + firstSetBit(mask);
+                }
+            }
+            return ii + scalar::findByte(data + ii, count - ii, value);
+        }
+    }  // namespace sse41
+
+    namespace avx2
+    {
+        HELICS_PMU_TARGET("avx2")
+        void decodeInt16Pairs(const std::uint8_t *data, std::size_t count, const double *scale, double *values)
+        {
+            const __m128i swap = HELICS_PMU_SWAP16;
+            std::size_t ii = 0;
+            for (; ii + 4 <= count; ii += 4, data += 16, values += 8)
+            {
+                const __m128i raw = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), swap);
+                const __m256i ints = _mm256_cvtepi16_epi32(raw);
+                const __m256d scales = _mm256_loadu_pd(scale + ii);
+                // duplicate each scale factor for the real and imaginary parts
+                const __m256d lowScale = _mm256_permute4x64_pd(scales, 0x50);
+                const __m256d highScale = _mm256_permute4x64_pd(scales, 0xFA);
+                _mm256_storeu_pd(values,
+                                 _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(ints)), lowScale));
+                _mm256_storeu_pd(values + 4,
+                                 _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(ints, 1)), highScale));
+            }
+            // leave the 256 bit state before continuing in the legacy encoded tail
+            _mm256_zeroupper();
+            scalar::decodeInt16Pairs(data, count - ii, scale + ii, values);
+        }
+
+        HELICS_PMU_TARGET("avx2")
+        void decodeFloats(const std::uint8_t *data, std::size_t count, double *values)
+        {
+            const __m128i swap = HELICS_PMU_SWAP32;
+            std::size_t ii = 0;
+            for (; ii + 8 <= count; ii += 8, data += 32, values += 8)
+            {
+                const __m128 first = _mm_castsi128_ps(
+                  _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), swap));
+                const __m128 second = _mm_castsi128_ps(
+                  _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16)), swap));
+                _mm256_storeu_pd(values, _mm256_cvtps_pd(first));
+                _mm256_storeu_pd(values + 4, _mm256_cvtps_pd(second));
+            }
+            _mm256_zeroupper();
+            sse41::decodeFloats(data, count - ii, values);
+        }
+
+        HELICS_PMU_TARGET("avx2")
+        static inline __m128i scaleToInt32(__m256d values, __m256d inverseScale)
+        {
+            const __m256d scaled = _mm256_mul_pd(values, inverseScale);
+            const __m256d clamped =
+              _mm256_max_pd(_mm256_min_pd(scaled, _mm256_set1_pd(32767.0)), _mm256_set1_pd(-32768.0));
+            return _mm256_cvtpd_epi32(clamped);
+        }
+
+        HELICS_PMU_TARGET("avx2")
+        void
+          encodeInt16Pairs(const double *values, std::size_t count, const double *inverseScale, std::uint8_t *data)
+        {
+            const __m128i swap = HELICS_PMU_SWAP16;
+            std::size_t ii = 0;
+            for (; ii + 4 <= count; ii += 4, data += 16, values += 8)
+            {
+                const __m256d scales = _mm256_loadu_pd(inverseScale + ii);
+                const __m128i low = scaleToInt32(_mm256_loadu_pd(values), _mm256_permute4x64_pd(scales, 0x50));
+                const __m128i high =
+                  scaleToInt32(_mm256_loadu_pd(values + 4), _mm256_permute4x64_pd(scales, 0xFA));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(data),
+                                 _mm_shuffle_epi8(_mm_packs_epi32(low, high), swap));
+            }
+            _mm256_zeroupper();
+            scalar::encodeInt16Pairs(values, count - ii, inverseScale + ii, data);
+        }
+
+        HELICS_PMU_TARGET("avx2")
+        void encodeFloats(const double *values, std::size_t count, std::uint8_t *data)
+        {
+            const __m128i swap = HELICS_PMU_SWAP32;
+            std::size_t ii = 0;
+            for (; ii + 4 <= count; ii += 4, data += 16, values += 4)
+            {
+                const __m128 floats = _mm256_cvtpd_ps(_mm256_loadu_pd(values));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(data),
+                                 _mm_shuffle_epi8(_mm_castps_si128(floats), swap));
+            }
+            _mm256_zeroupper();
+            scalar::encodeFloats(values, count - ii, data);
+        }
+
+        HELICS_PMU_TARGET("avx2")
+        std::size_t findByte(const std::uint8_t *data, std::size_t count, std::uint8_t value)
+        {
+            const __m256i target = _mm256_set1_epi8(static_cast<char>(value));
+            std::size_t ii = 0;
+            for (; ii + 32 <= count; ii += 32)
+            {
+                const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + ii));
+                const auto mask =
+                  static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, target)));
+                if (mask != 0U)
+                {
+                    _mm256_zeroupper();
+                    return ii + firstSetBit(mask);
+                }
+            }
+            _mm256_zeroupper();
+            return ii + sse41::findByte(data + ii, count - ii, value);
+        }
+    }  // namespace avx2
+
+#undef HELICS_PMU_SWAP16
+#undef HELICS_PMU_SWAP32
+
+    bool sse41Supported()
+    {
+        const auto &features = pmu::cpuFeatures();
+        return features.sse41 && features.ssse3;
+    }
+
+    bool avx2Supported() { return pmu::cpuFeatures().avx2; }
+#else
+    namespace sse41
+    {
+        void decodeInt16Pairs(const std::uint8_t *data, std::size_t count, const double *scale, double *values)
+        {
+            scalar::decodeInt16Pairs(data, count, scale, values);
+        }
+        void decodeFloats(const std::uint8_t *data, std::size_t count, double *values)
+        {
+            scalar::decodeFloats(data, count, values);
+        }
+        void
+          encodeInt16Pairs(const double *values, std::size_t count, const double *inverseScale, std::uint8_t *data)
+        {
+            scalar::encodeInt16Pairs(values, count, inverseScale, data);
+        }
+        void encodeFloats(const double *values, std::size_t count, std::uint8_t *data)
+        {
+            scalar::encodeFloats(values, count, data);
+        }
+        std::size_t findByte(const std::uint8_t *data, std::size_t count, std::uint8_t value)
+        {
+            return scalar::findByte(data, count, value);
+        }
+    }  // namespace sse41
+
+    namespace avx2
+    {
+        void decodeInt16Pairs(const std::uint8_t *data, std::size_t count, const double *scale, double *values)
+        {
+            scalar::decodeInt16Pairs(data, count, scale, values);
+        }
+        void decodeFloats(const std::uint8_t *data, std::size_t count, double *values)
+        {
+            scalar::decodeFloats(data, count, values);
+        }
+        void
+          encodeInt16Pairs(const double *values, std::size_t count, const double *inverseScale, std::uint8_t *data)
+        {
+            scalar::encodeInt16Pairs(values, count, inverseScale, data);
+        }
+        void encodeFloats(const double *values, std::size_t count, std::uint8_t *data)
+        {
+            scalar::encodeFloats(values, count, data);
+        }
+        std::size_t findByte(const std::uint8_t *data, std::size_t count, std::uint8_t value)
+        {
+            return scalar::findByte(data, count, value);
+        }
+    }  // namespace avx2
+
+    bool sse41Supported() { return false; }
+    bool avx2Supported() { return false; }
+#endif
+}  // namespace kernels
+
+/* the set of kernels selected for the running processor*/
+class KernelSet
+{
+  public:
+    void (*decodeInt16Pairs)(const std::uint8_t *, std::size_t, const double *, double *);
+    void (*decodeFloats)(const std::uint8_t *, std::size_t, double *);
+    void (*encodeInt16Pairs)(const double *, std::size_t, const double *, std::uint8_t *);
+    void (*encodeFloats)(const double *, std::size_t, std::uint8_t *);
+    std::size_t (*findByte)(const std::uint8_t *, std::size_t, std::uint8_t);
+};
+
+static KernelSet selectKernels()
+{
+    if (kernels::avx2Supported())
+    {
+        return {kernels::avx2::decodeInt16Pairs,
+                kernels::avx2::decodeFloats,
+                kernels::avx2::encodeInt16Pairs,
+                kernels::avx2::encodeFloats,
+                kernels::avx2::findByte};
+    }
+    if (kernels::sse41Supported())
+    {
+        return {kernels::sse41::decodeInt16Pairs,
+                kernels::sse41::decodeFloats,
+                kernels::sse41::encodeInt16Pairs,
+                kernels::sse41::encodeFloats,
+                kernels::sse41::findByte};
+    }
+    return {kernels::scalar::decodeInt16Pairs,
+            kernels::scalar::decodeFloats,
+            kernels::scalar::encodeInt16Pairs,
+            kernels::scalar::encodeFloats,
+            kernels::scalar::findByte};
+}
+
+static const KernelSet &activeKernels()
+{
+    static const KernelSet kernelSet = selectKernels();
+    return kernelSet;
+}
+
+void decodeInt16Pairs(const std::uint8_t *data, std::size_t count, const double *scale, double *values)
+{
+    activeKernels().decodeInt16Pairs(data, count, scale, values);
+}
+
+void decodeFloats(const std::uint8_t *data, std::size_t count, double *values)
+{
+    activeKernels().decodeFloats(data, count, values);
+}
+
+void encodeInt16Pairs(const double *values, std::size_t count, const double *inverseScale, std::uint8_t *data)
+{
+    activeKernels().encodeInt16Pairs(values, count, inverseScale, data);
+}
+
+void encodeFloats(const double *values, std::size_t count, std::uint8_t *data)
+{
+    activeKernels().encodeFloats(values, count, data);
+}
+
+std::size_t findByte(const std::uint8_t *data, std::size_t count, std::uint8_t value)
+{
+    return activeKernels().findByte(data, count, value);
+}
+}  // namespace c37118
@@ -0,0 +1,77 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/** @file
+vectorized conversion kernels for the repeated fields of C37.118 data frames and for scanning streams of frames
+
+The dispatching functions select the fastest implementation supported by the processor at runtime.  All the
+implementations produce bit identical results,  integer conversions round to nearest (ties to even) and saturate
+*/
+namespace c37118
+{
+/** the minimum number of channels in a PMU block before the codec uses the vector kernels*/
+static constexpr std::size_t kernel_minimum_channels{8U};
+
+/** decode count big endian int16 pairs into interleaved doubles,  both values of pair ii are multiplied by
+ * scale[ii]*/
+void decodeInt16Pairs(const std::uint8_t *data, std::size_t count, const double *scale, double *values);
+
+/** decode count big endian float32 values into doubles*/
+void decodeFloats(const std::uint8_t *data, std::size_t count, double *values);
+
+/** encode count pairs of interleaved doubles,  multiplied by inverseScale[ii],  as big endian int16 pairs*/
+void encodeInt16Pairs(const double *values, std::size_t count, const double *inverseScale, std::uint8_t *data);
+
+/** encode count doubles as big endian float32 values*/
+void encodeFloats(const double *values, std::size_t count, std::uint8_t *data);
+
+/** find the first occurrence of a byte value
+@return the index of the first match or count if the value is not present*/
+std::size_t findByte(const std::uint8_t *data, std::size_t count, std::uint8_t value);
+
+namespace kernels
+{
+    /** portable implementations*/
+    namespace scalar
+    {
+        void decodeInt16Pairs(const std::uint8_t *data, std::size_t count, const double *scale, double *values);
+        void decodeFloats(const std::uint8_t *data, std::size_t count, double *values);
+        void
+          encodeInt16Pairs(const double *values, std::size_t count, const double *inverseScale, std::uint8_t *data);
+        void encodeFloats(const double *values, std::size_t count, std::uint8_t *data);
+        std::size_t findByte(const std::uint8_t *data, std::size_t count, std::uint8_t value);
+    }  // namespace scalar
+
+    /** 128 bit implementations, only valid if sse41Supported() returns true*/
+    namespace sse41
+    {
+        void decodeInt16Pairs(const std::uint8_t *data, std::size_t count, const double *scale, double *values);
+        void decodeFloats(const std::uint8_t *data, std::size_t count, double *values);
+        void
+          encodeInt16Pairs(const double *values, std::size_t count, const double *inverseScale, std::uint8_t *data);
+        void encodeFloats(const double *values, std::size_t count, std::uint8_t *data);
+        std::size_t findByte(const std::uint8_t *data, std::size_t count, std::uint8_t value);
+    }  // namespace sse41
+
+    /** 256 bit implementations, only valid if avx2Supported() returns true*/
+    namespace avx2
+    {
+        void decodeInt16Pairs(const std::uint8_t *data, std::size_t count, const double *scale, double *values);
+        void decodeFloats(const std::uint8_t *data, std::size_t count, double *values);
+        void
+          encodeInt16Pairs(const double *values, std::size_t count, const double *inverseScale, std::uint8_t *data);
+        void encodeFloats(const double *values, std::size_t count, std::uint8_t *data);
+        std::size_t findByte(const std::uint8_t *data, std::size_t count, std::uint8_t value);
+    }  // namespace avx2
+
+    bool sse41Supported();
+    bool avx2Supported();
+}  // namespace kernels
+}  // namespace c37118
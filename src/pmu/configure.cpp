@@ -5,6 +5,7 @@ the top-level NOTICE for additional details. All rights reserved. SPDX-License-I
 */
 
 #include "configure.hpp"
+#include "FrameLayout.hpp"
 #include "JsonProcessingFunctions.hpp"
 #include "json/json.h"
 #include <iostream>
@@ -179,9 +180,8 @@ void writePmuDataJson(Json::Value &jv, const PmuData &pmu)
     jv["pmu"].append(std::move(pmuJ));
 }
 
-PmuData loadPmuDataJson(const Json::Value &jv)
-    {
-        PmuData data;
+static void loadPmuDataJson(const Json::Value &jv, PmuData &data)
+{
     data.freq = jv["freq"].asDouble();
     data.rocof = jv["rocof"].asDouble();
 
@@ -211,7 +211,6 @@ PmuData loadPmuDataJson(const Json::Value &jv)
     {
         data.digital.push_back(static_cast<std::uint16_t>(digital.asUInt()));
     }
-    return data;
 }
 
 void addDataFrameJson(Json::Value &jv, const PmuDataFrame &pdf) 
@@ -226,13 +225,13 @@ void addDataFrameJson(Json::Value &jv, const PmuDataFrame &pdf)
     }
 }
 
-PmuDataFrame loadDataFrame(const Json::Value &jv,bool checkObject)
+PmuDataFrame loadDataFrame(const Json::Value &jv, bool checkObject, const FrameAllocator &alloc)
 { 
         if (checkObject && jv.isMember("data"))
         {
-            return loadDataFrame(jv["data"], false);
+            return loadDataFrame(jv["data"], false, alloc);
         }
-        PmuDataFrame pdf;
+        PmuDataFrame pdf(alloc);
         if (!jv.isObject())
         {
             pdf.parseResult = ParseResult::not_parsed;
@@ -267,12 +266,12 @@ PmuDataFrame loadDataFrame(const Json::Value &jv,bool checkObject)
     {
         for (auto &pmucfg : pmu)
         {
-            pdf.pmus.push_back(loadPmuDataJson(pmucfg));
+            loadPmuDataJson(pmucfg, pdf.pmus.emplace_back());
         }
     }
     else
     {
-       pdf.pmus.push_back(loadPmuDataJson(pmu));
+       loadPmuDataJson(pmu, pdf.pmus.emplace_back());
     }
     pdf.parseResult = ParseResult::parse_complete;
     return pdf;
@@ -372,7 +371,10 @@ static int insertDigitalConfig(Json::Value &dgtl, PmuConfig &pmu, int currentCnt
 static PmuConfig loadPmuConfigJson(Json::Value &jv)
 {
     PmuConfig pmu;
-    fileops::replaceIfMember(jv, "name", pmu.stationName);
+    if (jv.isMember("name"))
+    {
+        pmu.stationName = jv["name"].asString();
+    }
     int data{0};
     fileops::replaceIfMember(jv, "id", data);
     fileops::replaceIfMember(jv, "idcode", data);
@@ -504,7 +506,7 @@ Config loadConfigJson(const Json::Value& jv) {
         }
         newConfig.pmus.push_back(std::move(pmucfg));
     }
-    
+    updateFrameLayout(newConfig);
     return newConfig;
 }
 
@@ -544,7 +546,7 @@ static void addPmuJson(const PmuConfig &pmu, Json::Value &jv)
         jv["pmu"] = Json::arrayValue;
     }
     Json::Value pbase;
-    pbase["name"] = pmu.stationName;
+    pbase["name"] = std::string(pmu.stationName);
     pbase["idcode"] = pmu.sourceID;
     pbase["cfgcnt"] = pmu.changeCount;
     pbase["phasor_format"] = pmu.phasorFormat == integer_format ? "integer" : "floating_point";
@@ -558,7 +560,7 @@ static void addPmuJson(const PmuConfig &pmu, Json::Value &jv)
         for (int ii = 0; ii < pmu.phasorCount; ++ii)
         {
             Json::Value phasor;
-            phasor["name"] = pmu.phasorNames[ii];
+            phasor["name"] = std::string(pmu.phasorNames[ii]);
             phasor["scale"] = pmu.phasorConversion[ii];
             switch (pmu.phasorType[ii])
             {
@@ -581,7 +583,7 @@ static void addPmuJson(const PmuConfig &pmu, Json::Value &jv)
         for (int ii = 0; ii < pmu.analogCount; ++ii)
         {
             Json::Value analog;
-            analog["name"] = pmu.analogNames[ii];
+            analog["name"] = std::string(pmu.analogNames[ii]);
             analog["scale"] = pmu.analogConversion[ii];
             switch (pmu.analogType[ii])
             {
@@ -611,7 +613,7 @@ static void addPmuJson(const PmuConfig &pmu, Json::Value &jv)
             digital["name"] = Json::arrayValue;
             for (int jj=0;jj<16;++jj)
             {
-                digital["name"].append(pmu.digitChannelNames[ii * 16 + jj]);
+                digital["name"].append(std::string(pmu.digitChannelNames[ii * 16 + jj]));
             }
             digital["active"] = pmu.digitalActive[ii];
             digital["nominal"] = pmu.digitalNominal[ii];
@@ -752,25 +754,39 @@ void writeDataFile(const std::string& dataFile, const std::vector<PmuDataFrame>&
 }
 
 
-const std::vector<PmuDataFrame> loadDataFile(const std::string &dataFile)
+template <class FrameVector>
+static void loadDataFile(const std::string &dataFile, FrameVector &dataV, const FrameAllocator &alloc)
 {
-    std::vector<PmuDataFrame> dataV;
     if (fileops::hasJsonExtension(dataFile))
     {
         auto jv = fileops::loadJson(dataFile);
         auto data = jv["data"];
         if (data.isArray())
         {
+            dataV.reserve(data.size());
             for (auto &dvsection : data)
             {
-                dataV.push_back(loadDataFrame(dvsection, false));
+                dataV.push_back(loadDataFrame(dvsection, false, alloc));
             }
         }
         else
         {
-            dataV.push_back(loadDataFrame(data, false));
+            dataV.push_back(loadDataFrame(data, false, alloc));
         }
     }
+}
+
+const std::vector<PmuDataFrame> loadDataFile(const std::string &dataFile)
+{
+    std::vector<PmuDataFrame> dataV;
+    loadDataFile(dataFile, dataV, FrameAllocator{});
+    return dataV;
+}
+
+std::pmr::vector<PmuDataFrame> loadDataFile(const std::string &dataFile, const FrameAllocator &alloc)
+{
+    std::pmr::vector<PmuDataFrame> dataV(alloc);
+    loadDataFile(dataFile, dataV, alloc);
     return dataV;
 }
 }  // namespace c37118
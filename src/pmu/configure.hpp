@@ -20,7 +20,9 @@ namespace c37118
 
 	void writeConfig(const std::string &configFile, const Config &config);
 
-	PmuDataFrame loadDataFrame(const Json::Value &jv,bool checkObject=true);
+	/** load a data frame from json
+	@param alloc the allocator for the containers of the frame*/
+	PmuDataFrame loadDataFrame(const Json::Value &jv, bool checkObject = true, const FrameAllocator &alloc = {});
 
 	void writeDataJson(Json::Value &df, const PmuDataFrame &data);
     void writeDataJson(Json::Value &df, const std::vector<PmuDataFrame> &data);
@@ -29,4 +31,6 @@ namespace c37118
     void writeDataFile(const std::string &dataFile, const std::vector<PmuDataFrame> &data);
 
 	const std::vector<PmuDataFrame> loadDataFile(const std::string &dataFile);
+	/** load a data file with all the frames allocated from a single allocator such as that of a FrameArena*/
+	std::pmr::vector<PmuDataFrame> loadDataFile(const std::string &dataFile, const FrameAllocator &alloc);
  }
\ No newline at end of file
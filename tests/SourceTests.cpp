@@ -104,3 +104,36 @@ TEST(stable_source, test1)
 
      EXPECT_EQ(pdf.soc, std::chrono::duration_cast<std::chrono::seconds>(clk.time_since_epoch()).count()+2);
  }
+
+TEST(stable_source, encoded_frames)
+{
+    pmu::StableSource ssrc;
+    auto testConfig = testConfig1(12);
+    ssrc.setConfig(testConfig);
+    ssrc.setData(testDataFrame(12));
+
+    auto clk = std::chrono::system_clock::now().time_since_epoch();
+    std::vector<std::uint8_t> buffer(1024);
+    for (int ii = 0; ii < 3; ++ii)
+    {
+        auto frameTime = clk + std::chrono::milliseconds(ii * 33);
+        auto size = ssrc.generateFrame(buffer.data(), buffer.size(), frameTime);
+        ASSERT_GT(size, 0U);
+
+        c37118::PmuDataFrame expected;
+        ssrc.fillDataFrame(expected, frameTime);
+        std::vector<std::uint8_t> reference(1024);
+        ASSERT_EQ(c37118::generateDataFrame(reference.data(), reference.size(), testConfig, expected), size);
+        // the time fields may differ by a count from rounding the fraction of second
+        EXPECT_TRUE(std::equal(reference.begin(), reference.begin() + 6, buffer.begin()));
+        EXPECT_TRUE(std::equal(reference.begin() + 14, reference.begin() + size - 2, buffer.begin() + 14));
+
+        auto pdf = c37118::parseDataFrame(buffer.data(), size, testConfig);
+        ASSERT_EQ(pdf.parseResult, c37118::ParseResult::parse_complete);
+        EXPECT_EQ(pdf.soc, std::chrono::duration_cast<std::chrono::seconds>(frameTime).count());
+        EXPECT_NEAR(pdf.fracSec, expected.fracSec, 1.0 / testConfig.timeBase);
+        ASSERT_EQ(pdf.pmus.size(), 1U);
+        EXPECT_FLOAT_EQ(pdf.pmus[0].phasors[0].real(), 120.0);
+    }
+    EXPECT_EQ(ssrc.generateFrame(buffer.data(), 10, clk), 0U);
+}
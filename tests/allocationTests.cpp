@@ -0,0 +1,357 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <gtest/gtest.h>
+#include "testConfigs.h"
+#include "../src/pmu/c37118.h"
+#include "../src/pmu/Concentrator.hpp"
+#include "../src/pmu/ConcentratorOutput.hpp"
+#include "../src/pmu/FrameBatch.hpp"
+#include "../src/pmu/FrameExtractor.hpp"
+#include "../src/pmu/FrameMemory.hpp"
+#include "../src/pmu/FrameRelay.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+/* replacement global allocation functions that count allocations while a test enables counting*/
+static std::atomic<bool> countAllocations{false};
+static std::atomic<std::size_t> allocationCount{0};
+
+void *operator new(std::size_t size)
+{
+    if (countAllocations.load(std::memory_order_relaxed))
+    {
+        ++allocationCount;
+    }
+    if (size == 0)
+    {
+        size = 1;
+    }
+    void *ptr = std::malloc(size);
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](std::size_t size) { return operator new(size); }
+
+/* GCC inlines these into code which allocated with operator new and reports the free as a mismatch,  but the
+replacement operator new above allocates with malloc*/
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t /*size*/) noexcept { std::free(ptr); }
+
+void operator delete[](void *ptr, std::size_t /*size*/) noexcept { std::free(ptr); }
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#    pragma GCC diagnostic pop
+#endif
+
+class AllocationCounter
+{
+  public:
+    AllocationCounter()
+    {
+        allocationCount = 0;
+        countAllocations = true;
+    }
+    ~AllocationCounter() { countAllocations = false; }
+    std::size_t count() const { return allocationCount.load(); }
+};
+
+using namespace c37118;
+
+static void checkSteadyStateParse(const PcapPacketParser &p, const Config &cfg)
+{
+    PmuDataFrame pdf;
+    std::size_t frames{0};
+    std::size_t allocations{0};
+    for (std::size_t ii = 0; ii < p.packetCount(); ++ii)
+    {
+        const auto &pkt = p.getPacket(ii);
+        if (getPacketType(pkt.data(), pkt.size()) != PmuPacketType::data ||
+            getIdCode(pkt.data(), pkt.size()) != cfg.idcode)
+        {
+            continue;
+        }
+        if (frames == 0)
+        {
+            // warm up the storage
+            EXPECT_EQ(parseDataFrame(pkt.data(), pkt.size(), cfg, pdf), ParseResult::parse_complete);
+        }
+        else
+        {
+            AllocationCounter counter;
+            EXPECT_EQ(parseDataFrame(pkt.data(), pkt.size(), cfg, pdf), ParseResult::parse_complete);
+            allocations += counter.count();
+        }
+        ++frames;
+    }
+    EXPECT_GT(frames, 1U);
+    EXPECT_EQ(allocations, 0U);
+}
+
+TEST(allocation, parse_into_single_pmu)
+{
+    PcapPacketParser p(TEST_DIR "/C37.118_1PMU_TCP.pcap");
+    auto cfg = loadCaptureConfig(p, 1);
+    ASSERT_EQ(cfg.pmus.size(), 1U);
+    checkSteadyStateParse(p, cfg);
+}
+
+TEST(allocation, parse_into_multi_pmu)
+{
+    PcapPacketParser p(TEST_DIR "/C37.118_4in1PMU_TCP.pcap");
+    auto cfg = loadCaptureConfig(p, 4);
+    ASSERT_EQ(cfg.pmus.size(), 4U);
+    checkSteadyStateParse(p, cfg);
+}
+
+TEST(allocation, parse_into_without_layout)
+{
+    // a configuration built without a layout compiles one for the thread on the first frame only
+    PcapPacketParser p(TEST_DIR "/C37.118_1PMU_TCP.pcap");
+    auto cfg = loadCaptureConfig(p, 1);
+    cfg.layout.reset();
+    checkSteadyStateParse(p, cfg);
+}
+
+TEST(allocation, parse_into_matches_by_value)
+{
+    PcapPacketParser p(TEST_DIR "/C37.118_1PMU_UDP.pcap");
+    auto cfg = loadCaptureConfig(p, 2);
+    const auto &pkt = p.getPacketMatch(c37118::sync_lead, 4);
+    auto pdf = parseDataFrame(pkt.data(), pkt.size(), cfg);
+
+    PmuDataFrame reused;
+    EXPECT_EQ(parseDataFrame(pkt.data(), pkt.size(), cfg, reused), pdf.parseResult);
+    EXPECT_EQ(reused.soc, pdf.soc);
+    EXPECT_DOUBLE_EQ(reused.fracSec, pdf.fracSec);
+    ASSERT_EQ(reused.pmus.size(), pdf.pmus.size());
+    EXPECT_EQ(reused.pmus[0].phasors, pdf.pmus[0].phasors);
+    EXPECT_EQ(reused.pmus[0].digital, pdf.pmus[0].digital);
+    EXPECT_DOUBLE_EQ(reused.pmus[0].freq, pdf.pmus[0].freq);
+}
+
+TEST(allocation, arena_batch)
+{
+    PcapPacketParser p(TEST_DIR "/C37.118_4in1PMU_TCP.pcap");
+    auto cfg = loadCaptureConfig(p, 4);
+    ASSERT_EQ(cfg.pmus.size(), 4U);
+    FrameArena arena(256U * 1024U);
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        AllocationCounter counter;
+        {
+            // every frame of the capture is decoded into storage taken from the arena
+            std::pmr::vector<PmuDataFrame> frames(arena.allocator());
+            for (std::size_t ii = 0; ii < p.packetCount(); ++ii)
+            {
+                const auto &pkt = p.getPacket(ii);
+                if (getPacketType(pkt.data(), pkt.size()) != PmuPacketType::data)
+                {
+                    continue;
+                }
+                auto &frame = frames.emplace_back();
+                EXPECT_EQ(parseDataFrame(pkt.data(), pkt.size(), cfg, frame), ParseResult::parse_complete);
+            }
+            EXPECT_GT(frames.size(), 2U);
+            EXPECT_EQ(frames.back().pmus[0].phasors.get_allocator().resource(), arena.resource());
+        }
+        arena.release();
+        EXPECT_EQ(counter.count(), 0U);
+    }
+}
+
+TEST(allocation, arena_copies)
+{
+    PcapPacketParser p(TEST_DIR "/C37.118_4in1PMU_TCP.pcap");
+    auto cfg = loadCaptureConfig(p, 4);
+    const auto &pkt = p.getPacket(7);
+    auto pdf = parseDataFrame(pkt.data(), pkt.size(), cfg);
+    ASSERT_EQ(pdf.parseResult, ParseResult::parse_complete);
+
+    FrameArena arena;
+    AllocationCounter counter;
+    Config cfgCopy(cfg, arena.allocator());
+    PmuDataFrame frameCopy(pdf, arena.allocator());
+    FrameBatch batch(arena.allocator());
+    const std::uint8_t *data = pkt.data();
+    const std::size_t size = pkt.size();
+    EXPECT_EQ(parseDataFrames(&data, &size, 1U, cfgCopy, batch), 1U);
+    EXPECT_EQ(counter.count(), 0U);
+
+    ASSERT_EQ(cfgCopy.pmus.size(), cfg.pmus.size());
+    EXPECT_EQ(cfgCopy.pmus[1].stationName, cfg.pmus[1].stationName);
+    EXPECT_EQ(cfgCopy.pmus[1].phasorNames[0], cfg.pmus[1].phasorNames[0]);
+    EXPECT_EQ(cfgCopy.pmus[1].phasorNames.get_allocator().resource(), arena.resource());
+    EXPECT_EQ(frameCopy.pmus[3].phasors, pdf.pmus[3].phasors);
+    EXPECT_EQ(frameCopy.pmus[3].digital.get_allocator().resource(), arena.resource());
+    EXPECT_EQ(batch.soc[0], pdf.soc);
+}
+
+TEST(allocation, pool_reuse)
+{
+    PcapPacketParser p(TEST_DIR "/C37.118_1PMU_TCP.pcap");
+    auto cfg = loadCaptureConfig(p, 1);
+    FramePool pool;
+    std::size_t allocations{0};
+    std::size_t frames{0};
+    for (std::size_t ii = 0; ii < p.packetCount(); ++ii)
+    {
+        const auto &pkt = p.getPacket(ii);
+        if (getPacketType(pkt.data(), pkt.size()) != PmuPacketType::data)
+        {
+            continue;
+        }
+        AllocationCounter counter;
+        {
+            PmuDataFrame frame(pool.allocator());
+            EXPECT_EQ(parseDataFrame(pkt.data(), pkt.size(), cfg, frame), ParseResult::parse_complete);
+        }
+        // the first frame populates the pools
+        if (frames++ > 0)
+        {
+            allocations += counter.count();
+        }
+    }
+    EXPECT_GT(frames, 2U);
+    EXPECT_EQ(allocations, 0U);
+}
+
+TEST(allocation, concentrator_steady_state)
+{
+    PcapPacketParser p(TEST_DIR "/C37.118_1PMU_TCP.pcap");
+    auto cfg = loadCaptureConfig(p, 1);
+    // the capture stream repeated under several idcodes
+    constexpr std::uint16_t stream_count{8U};
+    std::vector<Config> streams;
+    for (std::uint16_t ii = 0; ii < stream_count; ++ii)
+    {
+        streams.push_back(cfg);
+        streams.back().idcode = static_cast<std::uint16_t>(cfg.idcode + ii);
+    }
+    pmu::Concentrator pdc(streams, cfg.dataRate, std::chrono::seconds(1));
+    std::size_t released{0};
+    pdc.setOutputCall([&released](const pmu::AlignedFrames &set) { released += set.complete ? 1U : 0U; });
+
+    PmuDataFrame pdf;
+    std::size_t allocations{0};
+    std::size_t frames{0};
+    for (std::size_t ii = 0; ii < p.packetCount(); ++ii)
+    {
+        const auto &pkt = p.getPacket(ii);
+        if (getPacketType(pkt.data(), pkt.size()) != PmuPacketType::data ||
+            parseDataFrame(pkt.data(), pkt.size(), cfg, pdf) != ParseResult::parse_complete)
+        {
+            continue;
+        }
+        // the slots are preallocated from the configurations so even the first frames do not allocate
+        AllocationCounter counter;
+        for (std::uint16_t jj = 0; jj < stream_count; ++jj)
+        {
+            pdf.idcode = streams[jj].idcode;
+            pdc.push(pdf);
+        }
+        pdc.release();
+        allocations += counter.count();
+        ++frames;
+    }
+    EXPECT_GT(frames, 2U);
+    EXPECT_EQ(released, frames);
+    EXPECT_EQ(allocations, 0U);
+}
+
+TEST(allocation, concentrator_output_steady_state)
+{
+    PcapPacketParser p(TEST_DIR "/C37.118_1PMU_TCP.pcap");
+    auto cfg = loadCaptureConfig(p, 1);
+    constexpr std::uint16_t stream_count{8U};
+    std::vector<Config> streams;
+    for (std::uint16_t ii = 0; ii < stream_count; ++ii)
+    {
+        streams.push_back(cfg);
+        streams.back().idcode = static_cast<std::uint16_t>(cfg.idcode + ii);
+    }
+    pmu::Concentrator pdc(streams, cfg.dataRate, std::chrono::seconds(1));
+    // converting to floating point goes through the decode and encode path
+    pmu::ConcentratorOutput output(
+      streams, 1U, cfg.dataRate, cfg.timeBase, pmu::ConcentratedFormat::floating_point);
+    std::vector<std::uint8_t> buffer(output.frameSize());
+    std::size_t encoded{0};
+    pdc.setOutputCall([&](const pmu::AlignedFrames &set) {
+        encoded += (output.encode(set, buffer.data(), buffer.size()) == buffer.size()) ? 1U : 0U;
+    });
+
+    PmuDataFrame pdf;
+    std::size_t allocations{0};
+    std::size_t frames{0};
+    for (std::size_t ii = 0; ii < p.packetCount(); ++ii)
+    {
+        const auto &pkt = p.getPacket(ii);
+        if (getPacketType(pkt.data(), pkt.size()) != PmuPacketType::data ||
+            parseDataFrame(pkt.data(), pkt.size(), cfg, pdf) != ParseResult::parse_complete)
+        {
+            continue;
+        }
+        AllocationCounter counter;
+        for (std::uint16_t jj = 0; jj < stream_count; ++jj)
+        {
+            pdf.idcode = streams[jj].idcode;
+            pdc.push(pdf);
+        }
+        pdc.release();
+        allocations += counter.count();
+        ++frames;
+    }
+    EXPECT_GT(frames, 2U);
+    EXPECT_EQ(encoded, frames);
+    EXPECT_EQ(allocations, 0U);
+}
+
+TEST(allocation, relay_steady_state)
+{
+    PcapPacketParser p(TEST_DIR "/C37.118_1PMU_TCP.pcap");
+    pmu::FrameRelay relay;
+    relay.mapIdcode(getIdCode(p.getPacket(1).data(), p.getPacket(1).size()), 77U);
+    std::size_t forwarded{0};
+    relay.addOutput([&forwarded](const FrameSpan & /*frame*/) { ++forwarded; });
+    FrameExtractor input;
+
+    std::size_t allocations{0};
+    std::size_t frames{0};
+    for (std::size_t ii = 0; ii < p.packetCount(); ++ii)
+    {
+        const auto &pkt = p.getPacket(ii);
+        if (getPacketType(pkt.data(), pkt.size()) != PmuPacketType::data)
+        {
+            continue;
+        }
+        // each frame is split across two reads so the framer retains part of it
+        const std::size_t split = pkt.size() / 2U;
+        AllocationCounter counter;
+        relay.relay(input, pkt.data(), split);
+        relay.relay(input, pkt.data() + split, pkt.size() - split);
+        // the first frame sizes the buffer of the framer
+        if (frames++ > 0)
+        {
+            allocations += counter.count();
+        }
+    }
+    EXPECT_GT(frames, 2U);
+    EXPECT_EQ(forwarded, frames);
+    EXPECT_EQ(relay.framesRewritten(), frames);
+    EXPECT_EQ(allocations, 0U);
+}
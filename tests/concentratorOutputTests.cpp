@@ -0,0 +1,210 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <gtest/gtest.h>
+#include "testConfigs.h"
+#include "../src/pmu/ConcentratorOutput.hpp"
+#include "../src/pmu/c37118Crc.h"
+#include "../src/pmu/c37118Fields.h"
+
+#include <cmath>
+#include <cstring>
+
+using namespace c37118;
+
+static constexpr std::size_t frame_count{100U};
+
+/* the concentrated capture split into one stream per PMU as the individual devices would send it*/
+class concentratorOutput: public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        PcapPacketParser p(TEST_DIR "/C37.118_4in1PMU_TCP.pcap");
+        captureConfig = loadCaptureConfig(p, 4);
+        ASSERT_EQ(captureConfig.pmus.size(), 4U);
+        updateFrameLayout(captureConfig);
+        for (std::size_t ii = 0; ii < captureConfig.pmus.size(); ++ii)
+        {
+            Config stream;
+            stream.idcode = static_cast<std::uint16_t>(1000U + ii);
+            stream.dataRate = captureConfig.dataRate;
+            stream.timeBase = captureConfig.timeBase;
+            stream.pmus.push_back(captureConfig.pmus[ii]);
+            updateFrameLayout(stream);
+            streams.push_back(std::move(stream));
+        }
+        // several data frames share a TCP segment and some are split across two,  so the frames are found in the
+        // joined packets by their header and CRC
+        std::vector<std::uint8_t> bytes;
+        for (std::size_t ii = 0; ii < p.packetCount(); ++ii)
+        {
+            bytes.insert(bytes.end(), p.getPacket(ii).begin(), p.getPacket(ii).end());
+        }
+        const std::size_t frameSize = captureConfig.layout->frameSize;
+        for (std::size_t ii = 0; ii + frameSize <= bytes.size() && captured.size() < frame_count; ++ii)
+        {
+            const auto *frame = bytes.data() + ii;
+            if (getPacketType(frame, frameSize) == PmuPacketType::data && readUInt16(frame + 2) == frameSize &&
+                readUInt16(frame + 4) == captureConfig.idcode &&
+                crcCCITT(frame, frameSize - 2) == readUInt16(frame + frameSize - 2))
+            {
+                captured.emplace_back(frame, frame + frameSize);
+                ii += frameSize - 1;
+            }
+        }
+        ASSERT_GT(captured.size(), 2U);
+    }
+
+    /* the data frame of one PMU of a captured frame as sent by its own stream*/
+    std::vector<std::uint8_t> streamFrame(const std::vector<std::uint8_t> &frame, std::size_t pmu) const
+    {
+        const auto &block = captureConfig.layout->pmus[pmu];
+        std::vector<std::uint8_t> bytes(frame.begin(), frame.begin() + common_frame_size);
+        bytes.insert(bytes.end(), frame.begin() + block.offset, frame.begin() + block.offset + block.size);
+        bytes.resize(bytes.size() + 2U);
+        writeUInt16(bytes.data() + 2, static_cast<std::uint16_t>(bytes.size()));
+        writeUInt16(bytes.data() + 4, streams[pmu].idcode);
+        writeUInt16(bytes.data() + bytes.size() - 2, crcCCITT(bytes.data(), bytes.size() - 2));
+        return bytes;
+    }
+
+    /* push the streams of a captured frame as raw bytes and release the set*/
+    void pushFrame(pmu::Concentrator &pdc, const std::vector<std::uint8_t> &frame, std::size_t streamCount)
+    {
+        for (std::size_t ii = 0; ii < streamCount; ++ii)
+        {
+            const auto bytes = streamFrame(frame, ii);
+            pdc.push(FrameSpan{bytes.data(), bytes.size()});
+        }
+        pdc.release(std::chrono::steady_clock::now() + std::chrono::seconds(2));
+    }
+
+    Config captureConfig;
+    std::vector<Config> streams;
+    std::vector<std::vector<std::uint8_t>> captured;
+};
+
+TEST_F(concentratorOutput, copies_matching_blocks)
+{
+    pmu::ConcentratorOutput output(streams, captureConfig.idcode, captureConfig.dataRate, captureConfig.timeBase);
+    ASSERT_EQ(output.frameSize(), captureConfig.layout->frameSize);
+    ASSERT_EQ(output.config().pmus.size(), 4U);
+
+    pmu::Concentrator pdc(streams, captureConfig.dataRate, std::chrono::seconds(1));
+    std::vector<std::uint8_t> buffer(output.frameSize());
+    std::vector<std::vector<std::uint8_t>> encoded;
+    pdc.setOutputCall([&](const pmu::AlignedFrames &set) {
+        ASSERT_EQ(output.encode(set, buffer.data(), buffer.size()), output.frameSize());
+        encoded.push_back(buffer);
+    });
+    for (const auto &frame : captured)
+    {
+        pushFrame(pdc, frame, streams.size());
+    }
+
+    // the concentrated stream reproduces the capture it was split from
+    ASSERT_EQ(encoded.size(), captured.size());
+    for (std::size_t ii = 0; ii < captured.size(); ++ii)
+    {
+        EXPECT_EQ(encoded[ii], captured[ii]) << "frame " << ii;
+    }
+    EXPECT_EQ(output.copiedBlocks(), 4U * captured.size());
+    EXPECT_EQ(output.encodedBlocks(), 0U);
+    EXPECT_EQ(output.missingBlocks(), 0U);
+
+    // the concentrated frames parse with the synthesized configuration
+    PmuDataFrame pdf;
+    EXPECT_EQ(parseDataFrame(encoded[0].data(), encoded[0].size(), output.config(), pdf),
+              ParseResult::parse_complete);
+    EXPECT_EQ(pdf.pmus.size(), 4U);
+}
+
+TEST_F(concentratorOutput, missing_pmu)
+{
+    pmu::ConcentratorOutput output(streams, 7U, captureConfig.dataRate, captureConfig.timeBase);
+    constexpr std::chrono::milliseconds window{10};
+    pmu::Concentrator pdc(streams, captureConfig.dataRate, window);
+    std::vector<std::uint8_t> buffer(output.frameSize());
+    std::size_t sets{0U};
+    pdc.setOutputCall([&](const pmu::AlignedFrames &set) {
+        ASSERT_EQ(output.encode(set, buffer.data(), buffer.size()), output.frameSize());
+        ++sets;
+    });
+    // the last stream does not arrive
+    pushFrame(pdc, captured[0], streams.size() - 1U);
+    ASSERT_EQ(sets, 1U);
+    EXPECT_EQ(output.missingBlocks(), 1U);
+
+    EXPECT_EQ(readUInt16(buffer.data() + 4), 7U);
+    EXPECT_EQ(readUInt16(buffer.data() + buffer.size() - 2), crcCCITT(buffer.data(), buffer.size() - 2));
+    const auto &missing = output.config().layout->pmus[3];
+    EXPECT_EQ(readUInt16(buffer.data() + missing.offset), stat_data_invalid);
+    PmuDataFrame pdf;
+    ASSERT_EQ(parseDataFrame(buffer.data(), buffer.size(), output.config(), pdf), ParseResult::parse_complete);
+    EXPECT_EQ(pdf.pmus[3].stat, stat_data_invalid);
+    if (missing.phasorEncoding == PhasorEncoding::float_rectangular ||
+        missing.phasorEncoding == PhasorEncoding::float_polar)
+    {
+        EXPECT_TRUE(std::isnan(std::abs(pdf.pmus[3].phasors[0])));
+    }
+    else
+    {
+        EXPECT_EQ(readUInt16(buffer.data() + missing.phasorOffset), 0x8000U);
+    }
+
+    // the blocks of the streams which arrived are unchanged
+    const auto &first = output.config().layout->pmus[0];
+    EXPECT_EQ(std::memcmp(buffer.data() + first.offset, captured[0].data() + first.offset, first.size), 0);
+}
+
+TEST_F(concentratorOutput, floating_point_conversion)
+{
+    pmu::ConcentratorOutput output(streams,
+                                   captureConfig.idcode,
+                                   captureConfig.dataRate,
+                                   captureConfig.timeBase,
+                                   pmu::ConcentratedFormat::floating_point);
+    for (const auto &pmu : output.config().pmus)
+    {
+        EXPECT_EQ(pmu.phasorFormat, floating_point_format);
+        EXPECT_EQ(pmu.freqFormat, floating_point_format);
+        EXPECT_EQ(pmu.analogFormat, floating_point_format);
+    }
+
+    pmu::Concentrator pdc(streams, captureConfig.dataRate, std::chrono::seconds(1));
+    std::vector<std::uint8_t> buffer(output.frameSize());
+    pdc.setOutputCall([&](const pmu::AlignedFrames &set) {
+        ASSERT_EQ(output.encode(set, buffer.data(), buffer.size()), output.frameSize());
+    });
+    pushFrame(pdc, captured[1], streams.size());
+
+    PmuDataFrame expected;
+    PmuDataFrame converted;
+    ASSERT_EQ(parseDataFrame(captured[1].data(), captured[1].size(), captureConfig, expected),
+              ParseResult::parse_complete);
+    ASSERT_EQ(parseDataFrame(buffer.data(), buffer.size(), output.config(), converted), ParseResult::parse_complete);
+    EXPECT_EQ(converted.soc, expected.soc);
+    EXPECT_EQ(converted.fracSecTicks, expected.fracSecTicks);
+    ASSERT_EQ(converted.pmus.size(), expected.pmus.size());
+    for (std::size_t ii = 0; ii < expected.pmus.size(); ++ii)
+    {
+        const auto &source = captureConfig.pmus[ii];
+        EXPECT_EQ(converted.pmus[ii].stat, expected.pmus[ii].stat);
+        ASSERT_EQ(converted.pmus[ii].phasors.size(), expected.pmus[ii].phasors.size());
+        for (std::size_t jj = 0; jj < expected.pmus[ii].phasors.size(); ++jj)
+        {
+            EXPECT_NEAR(std::abs(converted.pmus[ii].phasors[jj] - expected.pmus[ii].phasors[jj]),
+                        0.0,
+                        1e-5 * std::abs(expected.pmus[ii].phasors[jj]) + 1e-6);
+        }
+        // integer frequencies are sent as a deviation and converted to the full frequency
+        const double nominal = (source.freqFormat == floating_point_format) ? 0.0 : source.nominalFrequency;
+        EXPECT_NEAR(converted.pmus[ii].freq, expected.pmus[ii].freq + nominal, 1e-4);
+        EXPECT_EQ(converted.pmus[ii].digital, expected.pmus[ii].digital);
+    }
+    EXPECT_EQ(output.copiedBlocks() + output.encodedBlocks(), 4U);
+}
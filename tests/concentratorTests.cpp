@@ -0,0 +1,227 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <gtest/gtest.h>
+#include "testConfigs.h"
+#include "../src/pmu/Concentrator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+
+using namespace c37118;
+
+static constexpr std::int16_t data_rate{60};
+static constexpr std::uint32_t time_base{1000000U};
+static constexpr std::uint32_t base_soc{1600000000U};
+
+/* a data frame of a stream for a frame counted from the start of base_soc*/
+static PmuDataFrame streamFrame(std::uint16_t idcode, std::int64_t frameIndex)
+{
+    PmuDataFrame pdf;
+    pdf.idcode = idcode;
+    pdf.soc = base_soc + static_cast<std::uint32_t>(frameIndex / data_rate);
+    pdf.fracSecTicks = static_cast<std::uint32_t>((frameIndex % data_rate) * time_base / data_rate);
+    PmuData pd;
+    pd.phasors = {std::polar(static_cast<double>(idcode), 0.0), std::polar(static_cast<double>(frameIndex), 0.0)};
+    pd.analog = {1.0};
+    pd.freq = 0.0;
+    pd.rocof = 0.0;
+    pd.stat = 0;
+    pdf.pmus.push_back(pd);
+    return pdf;
+}
+
+static std::int64_t timeIndex(std::int64_t frameIndex)
+{
+    return static_cast<std::int64_t>(base_soc) * data_rate + frameIndex;
+}
+
+static std::vector<Config> streamConfigs(std::uint16_t count)
+{
+    std::vector<Config> configs;
+    for (std::uint16_t ii = 0; ii < count; ++ii)
+    {
+        configs.push_back(streamConfig(static_cast<std::uint16_t>(10U + ii), data_rate, floating_point_format, 1U));
+    }
+    return configs;
+}
+
+TEST(concentrator, complete_sets)
+{
+    pmu::Concentrator pdc(streamConfigs(3), data_rate, std::chrono::seconds(1));
+    std::vector<std::int64_t> times;
+    std::vector<std::size_t> present;
+    int badFrames{0};
+    pdc.setOutputCall([&](const pmu::AlignedFrames &set) {
+        times.push_back(set.timeIndex);
+        present.push_back(set.present);
+        for (std::size_t ii = 0; ii < set.frames.size(); ++ii)
+        {
+            const auto *frame = set.frames[ii];
+            if (frame == nullptr || frame->idcode != 10U + ii || frame->soc != set.soc ||
+                frame->pmus[0].phasors[1].real() != static_cast<double>(set.timeIndex - timeIndex(0)))
+            {
+                ++badFrames;
+            }
+        }
+    });
+
+    // the frames of five times arrive out of order
+    std::vector<PmuDataFrame> frames;
+    for (std::int64_t frame = 0; frame < 5; ++frame)
+    {
+        for (std::uint16_t idcode = 10U; idcode < 13U; ++idcode)
+        {
+            frames.push_back(streamFrame(idcode, frame + 58));
+        }
+    }
+    std::mt19937 generator(5);
+    std::shuffle(frames.begin(), frames.end(), generator);
+    std::size_t completed{0U};
+    for (const auto &frame : frames)
+    {
+        const auto result = pdc.push(frame);
+        ASSERT_TRUE(result == pmu::AlignResult::accepted || result == pmu::AlignResult::completed);
+        completed += (result == pmu::AlignResult::completed) ? 1U : 0U;
+    }
+    EXPECT_EQ(completed, 5U);
+    EXPECT_EQ(pdc.release(), 5U);
+
+    // the sets cross a second boundary and are released in time order
+    const std::vector<std::int64_t> expected{
+      timeIndex(58), timeIndex(59), timeIndex(60), timeIndex(61), timeIndex(62)};
+    EXPECT_EQ(times, expected);
+    EXPECT_EQ(present, std::vector<std::size_t>(5U, 3U));
+    EXPECT_EQ(badFrames, 0);
+    EXPECT_EQ(pdc.completeSets(), 5U);
+    EXPECT_EQ(pdc.partialSets(), 0U);
+    EXPECT_EQ(pdc.framesAccepted(), 15U);
+}
+
+TEST(concentrator, wait_window)
+{
+    constexpr std::chrono::milliseconds window{50};
+    pmu::Concentrator pdc(streamConfigs(3), data_rate, window);
+    std::vector<pmu::AlignedFrames> sets;
+    pdc.setOutputCall([&](const pmu::AlignedFrames &set) { sets.push_back(set); });
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(pdc.push(streamFrame(10U, 10), start), pmu::AlignResult::accepted);
+    EXPECT_EQ(pdc.push(streamFrame(11U, 10), start), pmu::AlignResult::accepted);
+    EXPECT_EQ(pdc.push(streamFrame(11U, 10), start), pmu::AlignResult::duplicate);
+    // the slot waits for the missing stream until the window passes
+    EXPECT_EQ(pdc.release(start + window / 2), 0U);
+    EXPECT_EQ(pdc.release(start + window), 1U);
+    ASSERT_EQ(sets.size(), 1U);
+    EXPECT_FALSE(sets[0].complete);
+    EXPECT_EQ(sets[0].present, 2U);
+    EXPECT_EQ(sets[0].timeIndex, timeIndex(10));
+    EXPECT_EQ(sets[0].frames[pdc.streamIndex(12U)], nullptr);
+    EXPECT_EQ(pdc.partialSets(), 1U);
+
+    // frames for the released time are counted rather than held
+    EXPECT_EQ(pdc.push(streamFrame(12U, 10), start + window), pmu::AlignResult::late);
+    EXPECT_EQ(pdc.push(streamFrame(12U, 9), start + window), pmu::AlignResult::late);
+    EXPECT_EQ(pdc.lateFrames(), 2U);
+
+    // a time without any frames is skipped once a later slot is ready
+    for (std::uint16_t idcode = 10U; idcode < 13U; ++idcode)
+    {
+        pdc.push(streamFrame(idcode, 12), start + window);
+    }
+    EXPECT_EQ(pdc.release(start + window), 1U);
+    ASSERT_EQ(sets.size(), 2U);
+    EXPECT_EQ(sets[1].timeIndex, timeIndex(12));
+    EXPECT_TRUE(sets[1].complete);
+    EXPECT_EQ(pdc.push(streamFrame(10U, 11), start + window), pmu::AlignResult::late);
+
+    // frames further ahead than the ring are rejected and unknown streams are counted
+    EXPECT_EQ(pdc.push(streamFrame(10U, 13 + data_rate), start + window), pmu::AlignResult::early);
+    EXPECT_EQ(pdc.push(streamFrame(99U, 13), start + window), pmu::AlignResult::unknown_stream);
+    EXPECT_EQ(pdc.earlyFrames(), 1U);
+    EXPECT_EQ(pdc.unknownFrames(), 1U);
+    EXPECT_EQ(pdc.duplicateFrames(), 1U);
+}
+
+TEST(concentrator, parallel_producers)
+{
+    constexpr std::uint16_t stream_count{500U};
+    constexpr std::int64_t frame_count{data_rate};
+    constexpr std::size_t producer_count{4U};
+    const auto configs = streamConfigs(stream_count);
+    pmu::Concentrator pdc(configs, data_rate, std::chrono::seconds(5));
+
+    std::vector<std::int64_t> times;
+    std::size_t incomplete{0U};
+    int badFrames{0};
+    pdc.setOutputCall([&](const pmu::AlignedFrames &set) {
+        times.push_back(set.timeIndex);
+        if (!set.complete)
+        {
+            ++incomplete;
+        }
+        for (std::size_t ii = 0; ii < set.frames.size(); ++ii)
+        {
+            const auto *frame = set.frames[ii];
+            if (frame != nullptr && (frame->idcode != configs[ii].idcode ||
+                                     frame->pmus[0].phasors[1].real() !=
+                                       static_cast<double>(set.timeIndex - timeIndex(0))))
+            {
+                ++badFrames;
+            }
+        }
+    });
+
+    // each producer delivers the frames of its streams in time order as a receiver thread would
+    std::vector<std::vector<PmuDataFrame>> frames(producer_count);
+    for (std::int64_t frame = 0; frame < frame_count; ++frame)
+    {
+        for (std::uint16_t ii = 0; ii < stream_count; ++ii)
+        {
+            frames[ii % producer_count].push_back(streamFrame(configs[ii].idcode, frame));
+        }
+    }
+    std::atomic<std::size_t> rejected{0U};
+    std::vector<std::thread> producers;
+    for (std::size_t ii = 0; ii < producer_count; ++ii)
+    {
+        producers.emplace_back([&, ii]() {
+            for (const auto &frame : frames[ii])
+            {
+                const auto result = pdc.push(frame);
+                if (result != pmu::AlignResult::accepted && result != pmu::AlignResult::completed)
+                {
+                    ++rejected;
+                }
+            }
+        });
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (times.size() < static_cast<std::size_t>(frame_count) && std::chrono::steady_clock::now() < deadline)
+    {
+        if (pdc.release() == 0U)
+        {
+            std::this_thread::yield();
+        }
+    }
+    for (auto &producer : producers)
+    {
+        producer.join();
+    }
+
+    EXPECT_EQ(rejected.load(), 0U);
+    ASSERT_EQ(times.size(), static_cast<std::size_t>(frame_count));
+    for (std::size_t ii = 0; ii < times.size(); ++ii)
+    {
+        EXPECT_EQ(times[ii], timeIndex(static_cast<std::int64_t>(ii)));
+    }
+    EXPECT_EQ(incomplete, 0U);
+    EXPECT_EQ(badFrames, 0);
+    EXPECT_EQ(pdc.framesAccepted(), static_cast<std::uint64_t>(stream_count) * frame_count);
+    EXPECT_EQ(pdc.lateFrames(), 0U);
+}
@@ -0,0 +1,87 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <gtest/gtest.h>
+#include "PcapPacketParser.h"
+#include "../src/pmu/c37118.h"
+#include "../src/pmu/c37118Crc.h"
+
+#include <random>
+
+using namespace c37118;
+
+class crcFiles : public ::testing::TestWithParam<const char *>
+{
+};
+
+/* every complete frame in the captures must match its transmitted CRC with every implementation*/
+TEST_P(crcFiles, frame_crc)
+{
+    PcapPacketParser p(std::string(TEST_DIR "/") + GetParam());
+    std::size_t checked{0};
+    for (std::size_t ii = 0; ii < p.packetCount(); ++ii)
+    {
+        const auto &pkt = p.getPacket(ii);
+        auto size = getPacketSize(pkt.data(), pkt.size());
+        if (size < min_packet_size || size > pkt.size())
+        {
+            continue;
+        }
+        std::uint16_t actualCRC = pkt[size - 2] * 256 + pkt[size - 1];
+        EXPECT_EQ(crc::bitwise(pkt.data(), size - 2U, crc_initial_value), actualCRC);
+        EXPECT_EQ(crc::slice8(pkt.data(), size - 2U, crc_initial_value), actualCRC);
+        if (crc::clmulSupported())
+        {
+            EXPECT_EQ(crc::clmul(pkt.data(), size - 2U, crc_initial_value), actualCRC);
+        }
+        EXPECT_EQ(crcCCITT(pkt.data(), size - 2U), actualCRC);
+        ++checked;
+    }
+    EXPECT_GT(checked, 0U);
+}
+
+INSTANTIATE_TEST_SUITE_P(crc,
+                         crcFiles,
+                         ::testing::Values("C37.118_1PMU_TCP.pcap",
+                                           "C37.118_1PMU_UDP.pcap",
+                                           "C37.118_4in1PMU_TCP.pcap",
+                                           "C37.118_2PMUsInSync_TCP.pcap"));
+
+TEST(crc, lengths)
+{
+    std::mt19937 gen(17);
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::vector<std::uint8_t> buffer(1200);
+    for (auto &byte : buffer)
+    {
+        byte = static_cast<std::uint8_t>(dist(gen));
+    }
+    for (std::size_t len = 0; len < buffer.size(); ++len)
+    {
+        auto expected = crc::bitwise(buffer.data(), len, crc_initial_value);
+        ASSERT_EQ(crc::slice8(buffer.data(), len, crc_initial_value), expected) << "length " << len;
+        if (crc::clmulSupported())
+        {
+            ASSERT_EQ(crc::clmul(buffer.data(), len, crc_initial_value), expected) << "length " << len;
+        }
+        ASSERT_EQ(crcCCITT(buffer.data(), len), expected) << "length " << len;
+    }
+}
+
+TEST(crc, continuation)
+{
+    std::vector<std::uint8_t> buffer(700);
+    for (std::size_t ii = 0; ii < buffer.size(); ++ii)
+    {
+        buffer[ii] = static_cast<std::uint8_t>(ii * 31U + 7U);
+    }
+    auto expected = crcCCITT(buffer.data(), buffer.size());
+    for (std::size_t split : {1U, 15U, 64U, 129U, 500U})
+    {
+        auto partial = crcCCITT(buffer.data(), split);
+        EXPECT_EQ(crcCCITT(buffer.data() + split, buffer.size() - split, partial), expected);
+    }
+}
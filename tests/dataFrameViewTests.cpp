@@ -0,0 +1,111 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <gtest/gtest.h>
+#include "PcapPacketParser.h"
+#include "../src/pmu/c37118.h"
+#include "../src/pmu/DataFrameView.hpp"
+
+using namespace c37118;
+
+static void checkView(const DataFrameView &view, const PmuDataFrame &pdf)
+{
+    EXPECT_EQ(view.parseResult(), pdf.parseResult);
+    EXPECT_EQ(view.idcode(), pdf.idcode);
+    EXPECT_EQ(view.soc(), pdf.soc);
+    EXPECT_EQ(view.fracSec(), pdf.fracSec);
+    EXPECT_EQ(view.timeQuality(), pdf.timeQuality);
+    ASSERT_EQ(view.pmuCount(), pdf.pmus.size());
+    for (std::size_t ii = 0; ii < pdf.pmus.size(); ++ii)
+    {
+        const auto &pmu = pdf.pmus[ii];
+        EXPECT_EQ(view.stat(ii), pmu.stat);
+        EXPECT_EQ(view.freq(ii), pmu.freq);
+        EXPECT_EQ(view.rocof(ii), pmu.rocof);
+        ASSERT_EQ(view.phasorCount(ii), pmu.phasors.size());
+        for (std::size_t jj = 0; jj < pmu.phasors.size(); ++jj)
+        {
+            EXPECT_EQ(view.phasor(ii, jj), pmu.phasors[jj]);
+        }
+        ASSERT_EQ(view.analogCount(ii), pmu.analog.size());
+        for (std::size_t jj = 0; jj < pmu.analog.size(); ++jj)
+        {
+            EXPECT_EQ(view.analog(ii, jj), pmu.analog[jj]);
+        }
+        ASSERT_EQ(view.digitalWordCount(ii), pmu.digital.size());
+        for (std::size_t jj = 0; jj < pmu.digital.size(); ++jj)
+        {
+            EXPECT_EQ(view.digital(ii, jj), pmu.digital[jj]);
+        }
+    }
+}
+
+TEST(dataFrameView, matches_parse)
+{
+    PcapPacketParser p(TEST_DIR "/C37.118_2PMUsInSync_TCP.pcap");
+    const auto &cfgPkt = p.getPacketMatch(sync_lead, 1);
+    Config cfg;
+    ASSERT_EQ(parseConfig2(cfgPkt.data(), cfgPkt.size(), cfg), ParseResult::parse_complete);
+
+    std::size_t checked{0};
+    DataFrameView view;
+    for (std::size_t ii = 0; ii < p.packetCount(); ++ii)
+    {
+        const auto &pkt = p.getPacket(ii);
+        if (getPacketType(pkt.data(), pkt.size()) != PmuPacketType::data)
+        {
+            continue;
+        }
+        auto pdf = parseDataFrame(pkt.data(), pkt.size(), cfg);
+        auto result = view.attach(pkt.data(), pkt.size(), cfg);
+        EXPECT_EQ(result, pdf.parseResult);
+        if (pdf.parseResult == ParseResult::parse_complete)
+        {
+            ASSERT_TRUE(view.valid());
+            checkView(view, pdf);
+            ++checked;
+        }
+    }
+    EXPECT_GT(checked, 0U);
+}
+
+TEST(dataFrameView, multi_pmu)
+{
+    PcapPacketParser p(TEST_DIR "/C37.118_4in1PMU_TCP.pcap");
+    const auto &pkt = p.getPacket(4);
+    std::vector<std::uint8_t> buffer(pkt.begin(), pkt.end());
+    buffer.insert(buffer.end(), p.getPacket(5).begin(), p.getPacket(5).end());
+    Config cfg;
+    ASSERT_EQ(parseConfig2(buffer.data(), buffer.size(), cfg), ParseResult::parse_complete);
+    ASSERT_EQ(cfg.pmus.size(), 4U);
+
+    const auto &data = p.getPacket(7);
+    auto pdf = parseDataFrame(data.data(), data.size(), cfg);
+    ASSERT_EQ(pdf.parseResult, ParseResult::parse_complete);
+    DataFrameView view(data.data(), data.size(), cfg);
+    checkView(view, pdf);
+}
+
+TEST(dataFrameView, invalid_frames)
+{
+    PcapPacketParser p(TEST_DIR "/C37.118_1PMU_TCP.pcap");
+    const auto &cfgPkt = p.getPacketMatch(sync_lead, config2_code | version2005, 0);
+    Config cfg;
+    ASSERT_EQ(parseConfig2(cfgPkt.data(), cfgPkt.size(), cfg), ParseResult::parse_complete);
+
+    DataFrameView view(cfgPkt.data(), cfgPkt.size(), cfg);
+    EXPECT_EQ(view.parseResult(), ParseResult::incorrect_type);
+    EXPECT_FALSE(view.valid());
+
+    const auto &data = p.getPacketMatch(sync_lead, data_frame_code | version2005, 0);
+    std::vector<std::uint8_t> corrupt(data.begin(), data.end());
+    corrupt[20] ^= 0xFFU;
+    EXPECT_EQ(view.attach(corrupt.data(), corrupt.size(), cfg), ParseResult::invalid_checksum);
+    EXPECT_FALSE(view.valid());
+
+    EXPECT_EQ(view.attach(data.data(), data.size(), cfg), ParseResult::parse_complete);
+    EXPECT_TRUE(view.valid());
+}
@@ -0,0 +1,242 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <gtest/gtest.h>
+#include "testConfigs.h"
+#include "../src/pmu/c37118.h"
+#include "../src/pmu/FrameBatch.hpp"
+#include "../src/pmu/FrameLayout.hpp"
+
+using namespace c37118;
+
+static void checkRow(const FrameBatch &batch, std::size_t row, const PmuDataFrame &pdf)
+{
+    EXPECT_EQ(batch.parseResult[row], pdf.parseResult);
+    EXPECT_EQ(batch.soc[row], pdf.soc);
+    EXPECT_EQ(batch.fracSec[row], pdf.fracSec);
+    EXPECT_EQ(batch.timeQuality[row], pdf.timeQuality);
+    ASSERT_EQ(batch.pmus.size(), pdf.pmus.size());
+    for (std::size_t ii = 0; ii < pdf.pmus.size(); ++ii)
+    {
+        const auto &columns = batch.pmus[ii];
+        const auto &pmu = pdf.pmus[ii];
+        EXPECT_EQ(columns.stat[row], pmu.stat);
+        EXPECT_EQ(columns.freq[row], pmu.freq);
+        EXPECT_EQ(columns.rocof[row], pmu.rocof);
+        ASSERT_EQ(columns.phasorCount, pmu.phasors.size());
+        for (std::size_t jj = 0; jj < pmu.phasors.size(); ++jj)
+        {
+            EXPECT_EQ(columns.real(jj)[row], pmu.phasors[jj].real());
+            EXPECT_EQ(columns.imag(jj)[row], pmu.phasors[jj].imag());
+        }
+        ASSERT_EQ(columns.analogCount, pmu.analog.size());
+        for (std::size_t jj = 0; jj < pmu.analog.size(); ++jj)
+        {
+            EXPECT_EQ(columns.analogChannel(jj)[row], pmu.analog[jj]);
+        }
+        ASSERT_EQ(columns.digitalWordCount, pmu.digital.size());
+        for (std::size_t jj = 0; jj < pmu.digital.size(); ++jj)
+        {
+            EXPECT_EQ(columns.digitalWord(jj)[row], pmu.digital[jj]);
+        }
+    }
+}
+
+TEST(frameBatch, frame_pointers)
+{
+    PcapPacketParser p(TEST_DIR "/C37.118_2PMUsInSync_TCP.pcap");
+    const auto &cfgPkt = p.getPacketMatch(sync_lead, 1);
+    Config cfg;
+    ASSERT_EQ(parseConfig2(cfgPkt.data(), cfgPkt.size(), cfg), ParseResult::parse_complete);
+
+    std::vector<const std::uint8_t *> frames;
+    std::vector<std::size_t> sizes;
+    std::vector<PmuDataFrame> expected;
+    for (std::size_t ii = 0; ii < p.packetCount(); ++ii)
+    {
+        const auto &pkt = p.getPacket(ii);
+        if (getPacketType(pkt.data(), pkt.size()) != PmuPacketType::data)
+        {
+            continue;
+        }
+        // frames from the other PMU in the capture are recorded as failures
+        frames.push_back(pkt.data());
+        sizes.push_back(pkt.size());
+        expected.push_back(parseDataFrame(pkt.data(), pkt.size(), cfg));
+    }
+    ASSERT_GT(frames.size(), 2U);
+
+    FrameBatch batch;
+    auto decoded = parseDataFrames(frames.data(), sizes.data(), frames.size(), cfg, batch);
+    ASSERT_EQ(batch.frameCount, frames.size());
+    std::size_t complete{0};
+    for (std::size_t ii = 0; ii < expected.size(); ++ii)
+    {
+        if (expected[ii].parseResult == ParseResult::parse_complete)
+        {
+            checkRow(batch, ii, expected[ii]);
+            ++complete;
+        }
+        else
+        {
+            EXPECT_NE(batch.parseResult[ii], ParseResult::parse_complete);
+        }
+    }
+    EXPECT_EQ(decoded, complete);
+    EXPECT_GT(complete, 0U);
+}
+
+TEST(frameBatch, concatenated_frames)
+{
+    PcapPacketParser p(TEST_DIR "/C37.118_4in1PMU_TCP.pcap");
+    auto cfg = loadCaptureConfig(p, 4);
+    ASSERT_EQ(cfg.pmus.size(), 4U);
+
+    std::vector<std::uint8_t> buffer;
+    std::vector<PmuDataFrame> expected;
+    for (std::size_t ii = 0; ii < p.packetCount(); ++ii)
+    {
+        const auto &pkt = p.getPacket(ii);
+        if (getPacketType(pkt.data(), pkt.size()) != PmuPacketType::data ||
+            getPacketSize(pkt.data(), pkt.size()) != pkt.size())
+        {
+            continue;
+        }
+        buffer.insert(buffer.end(), pkt.begin(), pkt.end());
+        expected.push_back(parseDataFrame(pkt.data(), pkt.size(), cfg));
+    }
+    ASSERT_GT(expected.size(), 2U);
+    // a trailing partial frame is ignored
+    buffer.insert(buffer.end(), p.getPacket(7).begin(), p.getPacket(7).begin() + 20);
+
+    FrameBatch batch;
+    auto decoded = parseDataFrames(buffer.data(), buffer.size(), cfg, batch);
+    EXPECT_EQ(decoded, expected.size());
+    ASSERT_EQ(batch.frameCount, expected.size());
+    for (std::size_t ii = 0; ii < expected.size(); ++ii)
+    {
+        checkRow(batch, ii, expected[ii]);
+    }
+
+    // decoding a smaller batch reuses the storage
+    auto half = buffer.size() / 2;
+    decoded = parseDataFrames(buffer.data(), half, cfg, batch);
+    EXPECT_EQ(batch.frameCount, decoded);
+    EXPECT_LT(decoded, expected.size());
+    for (std::size_t ii = 0; ii < decoded; ++ii)
+    {
+        checkRow(batch, ii, expected[ii]);
+    }
+}
+
+/* the columns match the frame decoder for every combination of formats,  with enough channels for the vector
+ * kernels*/
+TEST(frameBatch, format_combinations)
+{
+    auto cfg = streamConfig(5, 30, floating_point_format, 10U, 10U);
+    const auto base = cfg.pmus[0];
+    cfg.pmus.clear();
+    for (std::uint8_t format = 0; format < 16; ++format)
+    {
+        auto pmu = base;
+        pmu.phasorCoordinates = ((format & 1U) != 0U) ? polar_phasor : rectangular_phasor;
+        pmu.phasorFormat = (format >> 1U) & 1U;
+        pmu.freqFormat = (format >> 2U) & 1U;
+        pmu.analogFormat = (format >> 3U) & 1U;
+        cfg.pmus.push_back(pmu);
+    }
+    updateFrameLayout(cfg);
+
+    std::vector<PmuDataFrame> frames(3);
+    for (std::size_t ii = 0; ii < frames.size(); ++ii)
+    {
+        auto &frame = frames[ii];
+        frame.idcode = cfg.idcode;
+        frame.soc = 1600000000U;
+        frame.fracSec = static_cast<double>(ii) / 30.0;
+        frame.pmus.resize(cfg.pmus.size());
+        for (auto &pmu : frame.pmus)
+        {
+            pmu.stat = 0;
+            pmu.freq = 0.01 * static_cast<double>(ii);
+            pmu.rocof = 0.001;
+            for (std::size_t jj = 0; jj < 10U; ++jj)
+            {
+                const auto channel = static_cast<double>(jj);
+                pmu.phasors.push_back(std::polar(100.0 + channel + static_cast<double>(ii), -0.2 * channel));
+                pmu.analog.push_back(static_cast<double>(jj) - static_cast<double>(ii));
+            }
+        }
+    }
+    std::vector<std::uint8_t> buffer;
+    std::vector<std::size_t> offsets;
+    ASSERT_EQ(generateDataFrames(frames.data(), frames.size(), cfg, buffer, offsets), frames.size());
+
+    FrameBatch batch;
+    EXPECT_EQ(parseDataFrames(buffer.data(), buffer.size(), cfg, batch), frames.size());
+    for (std::size_t ii = 0; ii < frames.size(); ++ii)
+    {
+        checkRow(batch, ii, parseDataFrame(buffer.data() + offsets[ii], offsets[ii + 1] - offsets[ii], cfg));
+    }
+}
+
+TEST(frameBatch, encode_frames)
+{
+    PcapPacketParser p(TEST_DIR "/C37.118_4in1PMU_TCP.pcap");
+    auto cfg = loadCaptureConfig(p, 4);
+    ASSERT_EQ(cfg.pmus.size(), 4U);
+
+    std::vector<PmuDataFrame> frames;
+    for (std::size_t ii = 0; ii < p.packetCount(); ++ii)
+    {
+        const auto &pkt = p.getPacket(ii);
+        if (getPacketType(pkt.data(), pkt.size()) != PmuPacketType::data ||
+            getPacketSize(pkt.data(), pkt.size()) != pkt.size())
+        {
+            continue;
+        }
+        frames.push_back(parseDataFrame(pkt.data(), pkt.size(), cfg));
+        ASSERT_EQ(frames.back().parseResult, ParseResult::parse_complete);
+    }
+    ASSERT_GT(frames.size(), 2U);
+
+    std::vector<std::uint8_t> buffer;
+    std::vector<std::size_t> offsets;
+    auto count = generateDataFrames(frames.data(), frames.size(), cfg, buffer, offsets);
+    ASSERT_EQ(count, frames.size());
+    ASSERT_EQ(offsets.size(), frames.size() + 1U);
+    EXPECT_EQ(offsets.back(), buffer.size());
+
+    std::vector<std::uint8_t> single(cfg.layout->frameSize);
+    for (std::size_t ii = 0; ii < frames.size(); ++ii)
+    {
+        auto size = generateDataFrame(single.data(), single.size(), cfg, frames[ii]);
+        ASSERT_EQ(offsets[ii + 1] - offsets[ii], size);
+        EXPECT_TRUE(std::equal(single.begin(), single.end(), buffer.begin() + offsets[ii]));
+    }
+
+    // the columnar batch decoded from the buffer encodes back to the same bytes
+    FrameBatch batch;
+    ASSERT_EQ(parseDataFrames(buffer.data(), buffer.size(), cfg, batch), frames.size());
+    std::vector<std::uint8_t> columnBuffer;
+    std::vector<std::size_t> columnOffsets;
+    EXPECT_EQ(generateDataFrames(batch, cfg, columnBuffer, columnOffsets), frames.size());
+    EXPECT_EQ(columnOffsets, offsets);
+    EXPECT_EQ(columnBuffer, buffer);
+
+    // failed rows are skipped
+    batch.parseResult[1] = ParseResult::invalid_checksum;
+    EXPECT_EQ(generateDataFrames(batch, cfg, columnBuffer, columnOffsets), frames.size() - 1U);
+    EXPECT_EQ(columnBuffer.size(), buffer.size() - cfg.layout->frameSize);
+
+    // the time is encoded from the count
+    batch.parseResult[1] = ParseResult::parse_complete;
+    batch.fracSecTicks[0] = cfg.timeBase / 2U;
+    ASSERT_EQ(generateDataFrames(batch, cfg, columnBuffer, columnOffsets), frames.size());
+    auto edited = parseDataFrame(columnBuffer.data(), columnOffsets[1], cfg);
+    ASSERT_EQ(edited.parseResult, ParseResult::parse_complete);
+    EXPECT_EQ(edited.fracSecTicks, cfg.timeBase / 2U);
+}
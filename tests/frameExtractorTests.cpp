@@ -0,0 +1,161 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <gtest/gtest.h>
+#include "PcapPacketParser.h"
+#include "../src/pmu/c37118.h"
+#include "../src/pmu/FrameExtractor.hpp"
+
+#include <algorithm>
+
+using namespace c37118;
+
+/* the complete frames of a capture concatenated into a single stream*/
+static std::vector<std::vector<std::uint8_t>> loadFrames(const char *file, std::vector<std::uint8_t> &stream)
+{
+    PcapPacketParser p(std::string(TEST_DIR "/") + file);
+    std::vector<std::vector<std::uint8_t>> frames;
+    // the TCP captures split some frames across packets and contain some packets from other protocols
+    std::size_t offset{0U};
+    for (std::size_t ii = 0; ii < p.packetCount(); ++ii)
+    {
+        const auto &pkt = p.getPacket(ii);
+        if (offset == stream.size() && (pkt.empty() || pkt[0] != sync_lead))
+        {
+            continue;
+        }
+        stream.insert(stream.end(), pkt.begin(), pkt.end());
+        while (offset < stream.size())
+        {
+            auto size = getPacketSize(stream.data() + offset, stream.size() - offset);
+            if (size < min_packet_size || size > stream.size() - offset)
+            {
+                break;
+            }
+            frames.emplace_back(stream.begin() + offset, stream.begin() + offset + size);
+            offset += size;
+        }
+    }
+    stream.resize(offset);
+    return frames;
+}
+
+static std::vector<std::vector<std::uint8_t>> extractAll(FrameExtractor &extractor)
+{
+    std::vector<std::vector<std::uint8_t>> frames;
+    FrameSpan frame;
+    while (extractor.next(frame))
+    {
+        frames.emplace_back(frame.data, frame.data + frame.size);
+    }
+    return frames;
+}
+
+TEST(frameExtractor, chunk_sizes)
+{
+    std::vector<std::uint8_t> stream;
+    auto expected = loadFrames("C37.118_4in1PMU_TCP.pcap", stream);
+    ASSERT_GT(expected.size(), 5U);
+    for (std::size_t chunk : {1U, 7U, 16U, 100U, 1500U, 100000U})
+    {
+        FrameExtractor extractor;
+        std::vector<std::vector<std::uint8_t>> frames;
+        for (std::size_t offset = 0; offset < stream.size(); offset += chunk)
+        {
+            extractor.push(stream.data() + offset, std::min(chunk, stream.size() - offset));
+            auto found = extractAll(extractor);
+            frames.insert(frames.end(), found.begin(), found.end());
+        }
+        EXPECT_EQ(frames, expected) << "chunk size " << chunk;
+        EXPECT_EQ(extractor.frameCount(), expected.size());
+        EXPECT_EQ(extractor.droppedBytes(), 0U);
+        EXPECT_EQ(extractor.crcFailures(), 0U);
+        EXPECT_EQ(extractor.pending(), 0U);
+    }
+}
+
+TEST(frameExtractor, reused_buffer)
+{
+    std::vector<std::uint8_t> stream;
+    auto expected = loadFrames("C37.118_4in1PMU_TCP.pcap", stream);
+    ASSERT_GT(expected.size(), 5U);
+    // a single read buffer is overwritten as soon as next reports that more data is needed
+    std::vector<std::uint8_t> buffer(100U);
+    FrameExtractor extractor;
+    std::vector<std::vector<std::uint8_t>> frames;
+    for (std::size_t offset = 0; offset < stream.size(); offset += buffer.size())
+    {
+        const auto size = std::min(buffer.size(), stream.size() - offset);
+        std::copy_n(stream.begin() + static_cast<std::ptrdiff_t>(offset), size, buffer.begin());
+        extractor.push(buffer.data(), size);
+        auto found = extractAll(extractor);
+        frames.insert(frames.end(), found.begin(), found.end());
+        std::fill(buffer.begin(), buffer.end(), std::uint8_t{0xAAU});
+    }
+    EXPECT_EQ(frames, expected);
+    EXPECT_EQ(extractor.droppedBytes(), 0U);
+    EXPECT_EQ(extractor.pending(), 0U);
+}
+
+TEST(frameExtractor, resynchronize)
+{
+    std::vector<std::uint8_t> stream;
+    auto expected = loadFrames("C37.118_1PMU_TCP.pcap", stream);
+    ASSERT_GT(expected.size(), 4U);
+
+    std::vector<std::uint8_t> corrupt{0x01, 0x02, sync_lead, 0x03, 0x04};
+    corrupt.insert(corrupt.end(), expected[0].begin(), expected[0].end());
+    // a frame with a bad CRC
+    auto bad = expected[1];
+    bad[bad.size() / 2] ^= 0x10U;
+    corrupt.insert(corrupt.end(), bad.begin(), bad.end());
+    corrupt.insert(corrupt.end(), 37, 0x55);
+    for (std::size_t ii = 2; ii < expected.size(); ++ii)
+    {
+        corrupt.insert(corrupt.end(), expected[ii].begin(), expected[ii].end());
+    }
+
+    FrameExtractor extractor;
+    std::vector<std::vector<std::uint8_t>> frames;
+    for (std::size_t offset = 0; offset < corrupt.size(); offset += 60)
+    {
+        extractor.push(corrupt.data() + offset, std::min<std::size_t>(60U, corrupt.size() - offset));
+        auto found = extractAll(extractor);
+        frames.insert(frames.end(), found.begin(), found.end());
+    }
+    expected.erase(expected.begin() + 1);
+    EXPECT_EQ(frames, expected);
+    // the search for the next frame may find sync bytes inside the corrupt frame
+    EXPECT_GE(extractor.crcFailures(), 1U);
+    EXPECT_EQ(extractor.droppedBytes(), 5U + bad.size() + 37U);
+}
+
+TEST(frameExtractor, datagrams)
+{
+    std::vector<std::uint8_t> stream;
+    auto expected = loadFrames("C37.118_2PMUsInSync_TCP.pcap", stream);
+    ASSERT_GT(expected.size(), 4U);
+
+    // two frames per datagram followed by a truncated frame which must not leak into the next datagram
+    FrameExtractor extractor;
+    std::vector<std::vector<std::uint8_t>> frames;
+    std::size_t truncated{0U};
+    for (std::size_t ii = 0; ii + 2 < expected.size(); ii += 3)
+    {
+        std::vector<std::uint8_t> datagram(expected[ii].begin(), expected[ii].end());
+        datagram.insert(datagram.end(), expected[ii + 1].begin(), expected[ii + 1].end());
+        datagram.insert(datagram.end(), expected[ii + 2].begin(), expected[ii + 2].begin() + 10);
+        truncated += 10U;
+        extractor.push(datagram.data(), datagram.size());
+        auto found = extractAll(extractor);
+        extractor.flush();
+        EXPECT_EQ(found.size(), 2U);
+        frames.insert(frames.end(), found.begin(), found.end());
+    }
+    EXPECT_EQ(frames.size(), 2U * (expected.size() / 3U));
+    EXPECT_EQ(extractor.droppedBytes(), truncated);
+    EXPECT_EQ(extractor.crcFailures(), 0U);
+}
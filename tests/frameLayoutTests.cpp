@@ -0,0 +1,335 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <gtest/gtest.h>
+#include "testConfigs.h"
+#include "../src/pmu/c37118.h"
+#include "../src/pmu/FrameLayout.hpp"
+
+#include <cmath>
+
+using namespace c37118;
+
+static PmuConfig integerPmu(std::uint16_t phasors, bool polar)
+{
+    PmuConfig pmu{};
+    pmu.phasorFormat = integer_format;
+    pmu.analogFormat = integer_format;
+    pmu.freqFormat = integer_format;
+    pmu.phasorCoordinates = polar ? polar_phasor : rectangular_phasor;
+    pmu.phasorCount = phasors;
+    pmu.analogCount = 2;
+    pmu.digitalWordCount = 1;
+    for (std::uint16_t ii = 0; ii < phasors; ++ii)
+    {
+        pmu.phasorConversion.push_back(915527U * (ii + 1U));
+    }
+    return pmu;
+}
+
+TEST(frameLayout, capture_frame_size)
+{
+    PcapPacketParser p(TEST_DIR "/C37.118_4in1PMU_TCP.pcap");
+    auto cfg = loadCaptureConfig(p, 4);
+    ASSERT_TRUE(cfg.layout);
+    const auto &pkt = p.getPacket(7);
+    ASSERT_EQ(getPacketType(pkt.data(), pkt.size()), PmuPacketType::data);
+    EXPECT_EQ(cfg.layout->frameSize, getPacketSize(pkt.data(), pkt.size()));
+    ASSERT_EQ(cfg.layout->pmus.size(), 4U);
+    for (std::size_t ii = 1; ii < 4; ++ii)
+    {
+        EXPECT_EQ(cfg.layout->pmus[ii].offset, cfg.layout->pmus[ii - 1].offset + cfg.layout->pmus[ii - 1].size);
+    }
+}
+
+TEST(frameLayout, block_offsets)
+{
+    Config cfg;
+    cfg.pmus.push_back(integerPmu(3, false));
+    auto layout = compileFrameLayout(cfg);
+    const auto &block = layout->pmus[0];
+    EXPECT_EQ(block.offset, common_frame_size);
+    EXPECT_EQ(block.phasorOffset, common_frame_size + 2U);
+    EXPECT_EQ(block.freqOffset, block.phasorOffset + 12U);
+    EXPECT_EQ(block.analogOffset, block.freqOffset + 4U);
+    EXPECT_EQ(block.digitalOffset, block.analogOffset + 4U);
+    EXPECT_EQ(layout->frameSize, block.digitalOffset + 2U + 2U);
+    EXPECT_EQ(block.phasorEncoding, PhasorEncoding::integer_rectangular);
+    EXPECT_DOUBLE_EQ(block.phasorScale[1], 915527.0 * 2.0 * 1e-5);
+}
+
+TEST(frameLayout, integer_round_trip)
+{
+    Config cfg;
+    cfg.idcode = 17;
+    cfg.pmus.push_back(integerPmu(3, false));
+    cfg.pmus.push_back(integerPmu(2, true));
+    updateFrameLayout(cfg);
+
+    PmuDataFrame frame;
+    frame.soc = 1600000000U;
+    frame.fracSec = 0.25;
+    frame.pmus.resize(2);
+    for (auto &pmu : frame.pmus)
+    {
+        pmu.stat = 0x0010;
+        // integer frequencies are transmitted as the deviation from nominal
+        pmu.freq = 0.012;
+        pmu.rocof = -0.004;
+        pmu.analog = {12.0, -47.0};
+        pmu.digital = {0xA5A5};
+    }
+    frame.pmus[0].phasors = {{1200.5, -400.25}, {-3000.0, 2999.0}, {10.0, 0.0}};
+    frame.pmus[1].phasors = {std::polar(1500.0, 1.2), std::polar(7000.0, -2.5)};
+
+    std::vector<std::uint8_t> buffer(1024);
+    auto size = generateDataFrame(buffer.data(), buffer.size(), cfg, frame);
+    ASSERT_EQ(size, cfg.layout->frameSize);
+
+    auto decoded = parseDataFrame(buffer.data(), size, cfg);
+    ASSERT_EQ(decoded.parseResult, ParseResult::parse_complete);
+    ASSERT_EQ(decoded.pmus.size(), 2U);
+    for (std::size_t ii = 0; ii < 2; ++ii)
+    {
+        const auto &block = cfg.layout->pmus[ii];
+        const auto &expected = frame.pmus[ii];
+        const auto &actual = decoded.pmus[ii];
+        EXPECT_EQ(actual.stat, expected.stat);
+        ASSERT_EQ(actual.phasors.size(), expected.phasors.size());
+        for (std::size_t jj = 0; jj < expected.phasors.size(); ++jj)
+        {
+            // rounding to the nearest step bounds the error to half the scale in each coordinate
+            EXPECT_LE(std::abs(actual.phasors[jj] - expected.phasors[jj]),
+                      block.phasorScale[jj] + std::abs(expected.phasors[jj]) * integer_angle_scale);
+        }
+        EXPECT_NEAR(actual.freq, expected.freq, integer_frequency_scale / 2.0);
+        EXPECT_NEAR(actual.rocof, expected.rocof, integer_frequency_scale / 2.0);
+        EXPECT_EQ(actual.analog, expected.analog);
+        EXPECT_EQ(actual.digital, expected.digital);
+    }
+}
+
+TEST(frameLayout, integer_saturation)
+{
+    Config cfg;
+    cfg.pmus.push_back(integerPmu(1, false));
+    updateFrameLayout(cfg);
+
+    PmuDataFrame frame;
+    frame.pmus.resize(1);
+    frame.pmus[0].phasors = {{1e9, -1e9}};
+    frame.pmus[0].analog = {1e6, -1e6};
+    frame.pmus[0].digital = {0};
+
+    std::vector<std::uint8_t> buffer(256);
+    auto size = generateDataFrame(buffer.data(), buffer.size(), cfg, frame);
+    ASSERT_GT(size, 0U);
+    auto decoded = parseDataFrame(buffer.data(), size, cfg);
+    const double scale = cfg.layout->pmus[0].phasorScale[0];
+    EXPECT_DOUBLE_EQ(decoded.pmus[0].phasors[0].real(), 32767.0 * scale);
+    EXPECT_DOUBLE_EQ(decoded.pmus[0].phasors[0].imag(), -32768.0 * scale);
+    EXPECT_DOUBLE_EQ(decoded.pmus[0].analog[0], 32767.0);
+    EXPECT_DOUBLE_EQ(decoded.pmus[0].analog[1], -32768.0);
+}
+
+TEST(frameLayout, stale_layout)
+{
+    PcapPacketParser p(TEST_DIR "/C37.118_1PMU_TCP.pcap");
+    auto cfg = loadCaptureConfig(p, 1);
+    std::size_t index{2};
+    while (index < p.packetCount() &&
+           getPacketType(p.getPacket(index).data(), p.getPacket(index).size()) != PmuPacketType::data)
+    {
+        ++index;
+    }
+    const auto &pkt = p.getPacket(index);
+    ASSERT_EQ(getPacketType(pkt.data(), pkt.size()), PmuPacketType::data);
+    auto expected = parseDataFrame(pkt.data(), pkt.size(), cfg);
+    ASSERT_EQ(expected.parseResult, ParseResult::parse_complete);
+
+    // a layout that does not match the configuration is ignored
+    Config other;
+    other.pmus.push_back(integerPmu(1, false));
+    updateFrameLayout(other);
+    cfg.layout = other.layout;
+    auto actual = parseDataFrame(pkt.data(), pkt.size(), cfg);
+    ASSERT_EQ(actual.parseResult, ParseResult::parse_complete);
+    EXPECT_EQ(actual.pmus[0].phasors, expected.pmus[0].phasors);
+
+    cfg.pmus[0].analogCount += 1;
+    cfg.pmus[0].analogConversion.push_back(1);
+    actual = parseDataFrame(pkt.data(), pkt.size(), cfg);
+    EXPECT_EQ(actual.parseResult, ParseResult::config_mismatch);
+}
+
+TEST(frameLayout, changed_conversion)
+{
+    Config cfg;
+    cfg.pmus.push_back(integerPmu(1, false));
+    updateFrameLayout(cfg);
+
+    PmuDataFrame frame;
+    frame.pmus.resize(1);
+    frame.pmus[0].phasors = {{10.0, -20.0}};
+    frame.pmus[0].analog = {1.0, 2.0};
+    frame.pmus[0].digital = {0};
+    std::vector<std::uint8_t> buffer(256);
+    auto size = generateDataFrame(buffer.data(), buffer.size(), cfg, frame);
+    ASSERT_GT(size, 0U);
+
+    // the layout still has the scale of the old conversion factor so it is not used
+    cfg.pmus[0].phasorConversion[0] *= 2U;
+    EXPECT_FALSE(cfg.layout->matches(cfg));
+    auto decoded = parseDataFrame(buffer.data(), size, cfg);
+    ASSERT_EQ(decoded.parseResult, ParseResult::parse_complete);
+    // the value was encoded with half the scale it is now decoded with
+    const double scale = static_cast<double>(cfg.pmus[0].phasorConversion[0]) * integer_phasor_scale;
+    EXPECT_DOUBLE_EQ(decoded.pmus[0].phasors[0].real(), std::round(10.0 / (scale / 2.0)) * scale);
+
+    updateFrameLayout(cfg);
+    EXPECT_TRUE(cfg.layout->matches(cfg));
+}
+
+/* every combination of formats selects its own codec and round trips through the frame*/
+TEST(frameLayout, format_combinations)
+{
+    Config cfg;
+    cfg.idcode = 5;
+    for (std::uint8_t format = 0; format < 16; ++format)
+    {
+        auto pmu = integerPmu(3, (format & 1U) != 0U);
+        pmu.phasorFormat = (format >> 1U) & 1U;
+        pmu.freqFormat = (format >> 2U) & 1U;
+        pmu.analogFormat = (format >> 3U) & 1U;
+        cfg.pmus.push_back(pmu);
+    }
+    updateFrameLayout(cfg);
+    for (std::size_t ii = 0; ii < cfg.layout->pmus.size(); ++ii)
+    {
+        ASSERT_NE(cfg.layout->pmus[ii].decoder, nullptr);
+        ASSERT_NE(cfg.layout->pmus[ii].encoder, nullptr);
+        ASSERT_NE(cfg.layout->pmus[ii].columnDecoder, nullptr);
+        for (std::size_t jj = 0; jj < ii; ++jj)
+        {
+            EXPECT_NE(cfg.layout->pmus[ii].decoder, cfg.layout->pmus[jj].decoder);
+            EXPECT_NE(cfg.layout->pmus[ii].encoder, cfg.layout->pmus[jj].encoder);
+            EXPECT_NE(cfg.layout->pmus[ii].columnDecoder, cfg.layout->pmus[jj].columnDecoder);
+        }
+    }
+
+    PmuDataFrame frame;
+    frame.soc = 1600000000U;
+    frame.fracSec = 0.5;
+    frame.pmus.resize(cfg.pmus.size());
+    for (auto &pmu : frame.pmus)
+    {
+        pmu.stat = 0x0200;
+        pmu.freq = 0.025;
+        pmu.rocof = 0.002;
+        pmu.phasors = {std::polar(1000.0, 0.5), std::polar(2000.0, -1.0), std::polar(500.0, 3.0)};
+        pmu.analog = {3.0, -8.0};
+        pmu.digital = {0x1234};
+    }
+    std::vector<std::uint8_t> buffer(2048);
+    auto size = generateDataFrame(buffer.data(), buffer.size(), cfg, frame);
+    ASSERT_EQ(size, cfg.layout->frameSize);
+    auto decoded = parseDataFrame(buffer.data(), size, cfg);
+    ASSERT_EQ(decoded.parseResult, ParseResult::parse_complete);
+    for (std::size_t ii = 0; ii < frame.pmus.size(); ++ii)
+    {
+        const auto &block = cfg.layout->pmus[ii];
+        const auto &expected = frame.pmus[ii];
+        const auto &actual = decoded.pmus[ii];
+        EXPECT_EQ(actual.stat, expected.stat);
+        for (std::size_t jj = 0; jj < expected.phasors.size(); ++jj)
+        {
+            EXPECT_LE(std::abs(actual.phasors[jj] - expected.phasors[jj]),
+                      block.phasorScale[jj] + std::abs(expected.phasors[jj]) * integer_angle_scale)
+              << "format " << ii;
+        }
+        EXPECT_NEAR(actual.freq, expected.freq, integer_frequency_scale / 2.0);
+        EXPECT_NEAR(actual.rocof, expected.rocof, integer_frequency_scale / 2.0);
+        EXPECT_EQ(actual.analog, expected.analog);
+        EXPECT_EQ(actual.digital, expected.digital);
+    }
+}
+
+TEST(frameLayout, compact_frames)
+{
+    Config cfg;
+    cfg.idcode = 5;
+    for (std::uint8_t format = 0; format < 16; ++format)
+    {
+        // enough phasors that the double decoder uses the vector kernels
+        auto pmu = integerPmu(10, (format & 1U) != 0U);
+        pmu.phasorFormat = (format >> 1U) & 1U;
+        pmu.freqFormat = (format >> 2U) & 1U;
+        pmu.analogFormat = (format >> 3U) & 1U;
+        pmu.analogCount = 9;
+        cfg.pmus.push_back(pmu);
+    }
+    updateFrameLayout(cfg);
+
+    PmuDataFrame frame;
+    frame.soc = 1600000000U;
+    frame.fracSec = 0.25;
+    frame.timeQuality = 0;
+    frame.pmus.resize(cfg.pmus.size());
+    for (auto &pmu : frame.pmus)
+    {
+        pmu.stat = 0x0200;
+        pmu.freq = 0.025;
+        pmu.rocof = 0.002;
+        for (int ii = 0; ii < 10; ++ii)
+        {
+            pmu.phasors.push_back(std::polar(1000.0 + 37.0 * ii, 0.3 * ii - 1.2));
+            pmu.analog.push_back(static_cast<double>(ii * 7 - 30));
+        }
+        pmu.analog.pop_back();
+        pmu.digital = {0x4321};
+    }
+    std::vector<std::uint8_t> buffer(8192);
+    auto size = generateDataFrame(buffer.data(), buffer.size(), cfg, frame);
+    ASSERT_EQ(size, cfg.layout->frameSize);
+
+    auto decoded = parseDataFrame(buffer.data(), size, cfg);
+    CompactPmuDataFrame compact;
+    ASSERT_EQ(parseDataFrame(buffer.data(), size, cfg, compact), ParseResult::parse_complete);
+    EXPECT_EQ(compact.soc, decoded.soc);
+    EXPECT_EQ(compact.fracSecTicks, decoded.fracSecTicks);
+    ASSERT_EQ(compact.pmus.size(), decoded.pmus.size());
+
+    // decoding directly to float matches narrowing the double decoding
+    const CompactPmuDataFrame converted(decoded);
+    for (std::size_t ii = 0; ii < compact.pmus.size(); ++ii)
+    {
+        const auto &expected = converted.pmus[ii];
+        const auto &actual = compact.pmus[ii];
+        EXPECT_EQ(actual.stat, expected.stat);
+        EXPECT_EQ(actual.phasors, expected.phasors) << "format " << ii;
+        EXPECT_EQ(actual.freq, expected.freq);
+        EXPECT_EQ(actual.rocof, expected.rocof);
+        EXPECT_EQ(actual.analog, expected.analog);
+        EXPECT_EQ(actual.digital, expected.digital);
+    }
+
+    // widening back to double gives frames that encode the same values
+    const PmuDataFrame widened(compact);
+    std::vector<std::uint8_t> again(buffer.size());
+    ASSERT_EQ(generateDataFrame(again.data(), again.size(), cfg, widened), size);
+    auto redecoded = parseDataFrame(again.data(), size, cfg);
+    for (std::size_t ii = 0; ii < compact.pmus.size(); ++ii)
+    {
+        const auto &block = cfg.layout->pmus[ii];
+        for (std::size_t jj = 0; jj < block.phasorCount; ++jj)
+        {
+            EXPECT_LE(std::abs(redecoded.pmus[ii].phasors[jj] - decoded.pmus[ii].phasors[jj]),
+                      block.phasorScale[jj] + std::abs(decoded.pmus[ii].phasors[jj]) * 1e-6)
+              << "format " << ii;
+        }
+        EXPECT_EQ(redecoded.pmus[ii].analog, decoded.pmus[ii].analog);
+    }
+}
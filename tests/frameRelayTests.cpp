@@ -0,0 +1,239 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <gtest/gtest.h>
+#include "PcapPacketParser.h"
+#include "../src/pmu/FrameRelay.hpp"
+#include "../src/pmu/c37118Crc.h"
+#include "../src/pmu/c37118Fields.h"
+
+#include <asio/io_context.hpp>
+#include <asio/ip/udp.hpp>
+
+#include <random>
+#include <thread>
+
+using udp = asio::ip::udp;
+using namespace c37118;
+
+/* the frames of the single PMU capture,  each packet holds one whole frame*/
+static std::vector<std::vector<std::uint8_t>> captureFrames()
+{
+    PcapPacketParser p(TEST_DIR "/C37.118_1PMU_TCP.pcap");
+    std::vector<std::vector<std::uint8_t>> frames;
+    for (std::size_t ii = 0; ii < p.packetCount(); ++ii)
+    {
+        const auto &pkt = p.getPacket(ii);
+        if (pkt.size() > common_frame_size && pkt[0] == sync_lead && readUInt16(pkt.data() + 2) == pkt.size())
+        {
+            frames.emplace_back(pkt.begin(), pkt.end());
+        }
+    }
+    return frames;
+}
+
+static std::vector<std::uint8_t> joinFrames(const std::vector<std::vector<std::uint8_t>> &frames)
+{
+    std::vector<std::uint8_t> stream;
+    for (const auto &frame : frames)
+    {
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+    return stream;
+}
+
+/* relay a byte stream in chunks of random size as they would arrive from a TCP connection*/
+static std::size_t relayStream(pmu::FrameRelay &relay, FrameExtractor &input, const std::vector<std::uint8_t> &stream)
+{
+    std::mt19937 generator(3);
+    std::uniform_int_distribution<std::size_t> chunkSize(1U, 200U);
+    std::size_t relayed{0U};
+    std::size_t offset{0U};
+    while (offset < stream.size())
+    {
+        const auto size = std::min(chunkSize(generator), stream.size() - offset);
+        relayed += relay.relay(input, stream.data() + offset, size);
+        offset += size;
+    }
+    return relayed;
+}
+
+TEST(frameRelay, forwards_unchanged)
+{
+    const auto frames = captureFrames();
+    ASSERT_GT(frames.size(), 10U);
+    pmu::FrameRelay relay;
+    std::vector<std::vector<std::uint8_t>> forwarded;
+    relay.addOutput([&forwarded](const FrameSpan &frame) { forwarded.emplace_back(frame.data, frame.data + frame.size); });
+
+    FrameExtractor input;
+    EXPECT_EQ(relayStream(relay, input, joinFrames(frames)), frames.size());
+    EXPECT_EQ(forwarded, frames);
+    EXPECT_EQ(relay.framesRelayed(), frames.size());
+    EXPECT_EQ(relay.framesRewritten(), 0U);
+    EXPECT_EQ(relay.crcFailures(), 0U);
+}
+
+TEST(frameRelay, reused_read_buffer)
+{
+    const auto frames = captureFrames();
+    pmu::FrameRelay relay;
+    std::vector<std::vector<std::uint8_t>> forwarded;
+    relay.addOutput([&forwarded](const FrameSpan &frame) { forwarded.emplace_back(frame.data, frame.data + frame.size); });
+
+    // every read overwrites the same socket buffer,  so split frames must be retained by the relay
+    const auto stream = joinFrames(frames);
+    std::vector<std::uint8_t> buffer(50U);
+    FrameExtractor input;
+    for (std::size_t offset = 0; offset < stream.size(); offset += buffer.size())
+    {
+        const auto size = std::min(buffer.size(), stream.size() - offset);
+        std::copy(stream.begin() + offset, stream.begin() + offset + size, buffer.begin());
+        relay.relay(input, buffer.data(), size);
+        std::fill(buffer.begin(), buffer.end(), 0U);
+    }
+    EXPECT_EQ(forwarded, frames);
+    EXPECT_EQ(relay.crcFailures(), 0U);
+}
+
+TEST(frameRelay, rewrite_idcode)
+{
+    const auto frames = captureFrames();
+    const auto idcode = readUInt16(frames[0].data() + 4);
+    pmu::FrameRelay relay;
+    relay.mapIdcode(idcode, 4321U);
+    std::vector<std::vector<std::uint8_t>> forwarded;
+    relay.addOutput([&forwarded](const FrameSpan &frame) { forwarded.emplace_back(frame.data, frame.data + frame.size); });
+
+    FrameExtractor input;
+    EXPECT_EQ(relayStream(relay, input, joinFrames(frames)), frames.size());
+    ASSERT_EQ(forwarded.size(), frames.size());
+    for (std::size_t ii = 0; ii < frames.size(); ++ii)
+    {
+        const auto &frame = forwarded[ii];
+        ASSERT_EQ(frame.size(), frames[ii].size());
+        EXPECT_EQ(readUInt16(frame.data() + 4), 4321U);
+        EXPECT_EQ(readUInt16(frame.data() + frame.size() - 2), crcCCITT(frame.data(), frame.size() - 2));
+        // everything but the idcode and the CRC is forwarded as it was received
+        EXPECT_TRUE(std::equal(frame.begin(), frame.begin() + 4, frames[ii].begin()));
+        EXPECT_TRUE(std::equal(frame.begin() + 6, frame.end() - 2, frames[ii].begin() + 6));
+    }
+    EXPECT_EQ(relay.framesRewritten(), frames.size());
+}
+
+TEST(frameRelay, crc_failures)
+{
+    auto frames = captureFrames();
+    // corrupt a measurement of one frame
+    frames[3][20] ^= 0x10U;
+    pmu::FrameRelay relay;
+    std::size_t forwarded{0U};
+    relay.addOutput([&forwarded](const FrameSpan & /*frame*/) { ++forwarded; });
+
+    FrameExtractor input;
+    EXPECT_EQ(relayStream(relay, input, joinFrames(frames)), frames.size() - 1U);
+    EXPECT_EQ(forwarded, frames.size() - 1U);
+    EXPECT_EQ(relay.crcFailures(), 1U);
+
+    // complete frames from an input without a framer are checked as well
+    EXPECT_FALSE(relay.relayFrame(FrameSpan{frames[3].data(), frames[3].size()}));
+    EXPECT_TRUE(relay.relayFrame(FrameSpan{frames[4].data(), frames[4].size()}));
+    EXPECT_EQ(relay.crcFailures(), 2U);
+    EXPECT_EQ(forwarded, frames.size());
+}
+
+TEST(frameRelay, udp_outputs)
+{
+    const auto frames = captureFrames();
+    asio::io_context context;
+    std::vector<std::unique_ptr<udp::socket>> receivers;
+    auto output = std::make_shared<pmu::UdpRelayOutput>(context);
+    for (int ii = 0; ii < 2; ++ii)
+    {
+        receivers.push_back(
+          std::make_unique<udp::socket>(context, udp::endpoint(asio::ip::make_address("127.0.0.1"), 0)));
+        ASSERT_TRUE(output->addDestination("127.0.0.1", std::to_string(receivers.back()->local_endpoint().port())));
+    }
+    pmu::FrameRelay relay;
+    relay.addOutput(output);
+
+    // all the frames of a chunk are sent to both destinations together
+    constexpr std::size_t frame_count{10U};
+    const auto stream = joinFrames({frames.begin(), frames.begin() + frame_count});
+    FrameExtractor input;
+    EXPECT_EQ(relay.relay(input, stream.data(), stream.size()), frame_count);
+    EXPECT_EQ(output->datagramsSent(), 2U * frame_count);
+    EXPECT_EQ(output->sendErrors(), 0U);
+#ifdef __linux__
+    EXPECT_EQ(output->sendCalls(), 1U);
+#endif
+
+    std::vector<std::uint8_t> buffer(65536U);
+    for (auto &receiver : receivers)
+    {
+        for (std::size_t ii = 0; ii < frame_count; ++ii)
+        {
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+            while (receiver->available() == 0U && std::chrono::steady_clock::now() < deadline)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            ASSERT_GT(receiver->available(), 0U);
+            const auto size = receiver->receive(asio::buffer(buffer));
+            EXPECT_EQ(std::vector<std::uint8_t>(buffer.begin(), buffer.begin() + size), frames[ii]);
+        }
+    }
+}
+
+TEST(frameRelay, many_streams)
+{
+    // the data frames of the capture sent by thousands of streams,  each on its own connection
+    constexpr std::uint16_t stream_count{2000U};
+    auto frames = captureFrames();
+    frames.erase(std::remove_if(frames.begin(),
+                                frames.end(),
+                                [](const std::vector<std::uint8_t> &frame) {
+                                    return getPacketType(frame.data(), frame.size()) != PmuPacketType::data;
+                                }),
+                 frames.end());
+    const std::size_t frame_count = std::min<std::size_t>(frames.size(), 30U);
+    std::vector<std::vector<std::uint8_t>> streams(stream_count);
+    pmu::FrameRelay relay;
+    for (std::uint16_t ii = 0; ii < stream_count; ++ii)
+    {
+        auto streamFrames = frames;
+        streamFrames.resize(frame_count);
+        for (auto &frame : streamFrames)
+        {
+            writeUInt16(frame.data() + 4, static_cast<std::uint16_t>(ii + 1U));
+            writeUInt16(frame.data() + frame.size() - 2, crcCCITT(frame.data(), frame.size() - 2));
+        }
+        streams[ii] = joinFrames(streamFrames);
+        relay.mapIdcode(static_cast<std::uint16_t>(ii + 1U), static_cast<std::uint16_t>(ii + 30001U));
+    }
+    std::size_t badFrames{0U};
+    relay.addOutput([&badFrames](const FrameSpan &frame) {
+        if (readUInt16(frame.data + 4) <= 30000U ||
+            crcCCITT(frame.data, frame.size - 2) != readUInt16(frame.data + frame.size - 2))
+        {
+            ++badFrames;
+        }
+    });
+
+    // each connection delivers one frame per read,  interleaved with the other connections
+    std::vector<FrameExtractor> inputs(stream_count);
+    const std::size_t frameSize = frames[0].size();
+    for (std::size_t frame = 0; frame < frame_count; ++frame)
+    {
+        for (std::size_t ii = 0; ii < stream_count; ++ii)
+        {
+            relay.relay(inputs[ii], streams[ii].data() + frame * frameSize, frameSize);
+        }
+    }
+    EXPECT_EQ(relay.framesRelayed(), stream_count * frame_count);
+    EXPECT_EQ(relay.framesRewritten(), stream_count * frame_count);
+    EXPECT_EQ(badFrames, 0U);
+}
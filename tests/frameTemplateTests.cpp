@@ -0,0 +1,126 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <gtest/gtest.h>
+#include "../src/pmu/c37118.h"
+#include "../src/pmu/c37118Crc.h"
+#include "../src/pmu/FrameLayout.hpp"
+#include "../src/pmu/FrameTemplate.hpp"
+
+#include <random>
+
+using namespace c37118;
+
+static Config templateConfig()
+{
+    Config cfg;
+    cfg.idcode = 23;
+    for (std::uint16_t ii = 0; ii < 3; ++ii)
+    {
+        PmuConfig pmu{};
+        pmu.phasorFormat = (ii == 0) ? integer_format : floating_point_format;
+        pmu.analogFormat = floating_point_format;
+        pmu.freqFormat = integer_format;
+        pmu.phasorCoordinates = rectangular_phasor;
+        pmu.phasorCount = 4;
+        pmu.analogCount = 2;
+        pmu.digitalWordCount = 1;
+        pmu.phasorConversion.assign(4, 915527U);
+        cfg.pmus.push_back(pmu);
+    }
+    updateFrameLayout(cfg);
+    return cfg;
+}
+
+static PmuDataFrame templateFrame()
+{
+    PmuDataFrame frame;
+    frame.pmus.resize(3);
+    for (auto &pmu : frame.pmus)
+    {
+        pmu.stat = 0;
+        pmu.freq = 0.02;
+        pmu.rocof = 0.0;
+        pmu.phasors = {{120.0, 0.0}, {-60.0, 103.9}, {-60.0, -103.9}, {5.0, 1.0}};
+        pmu.analog = {1.5, -2.5};
+        pmu.digital = {0x0F0F};
+    }
+    return frame;
+}
+
+TEST(frameTemplate, time_patch)
+{
+    auto cfg = templateConfig();
+    auto frame = templateFrame();
+    DataFrameTemplate tmp;
+    auto size = tmp.encode(cfg, frame);
+    ASSERT_EQ(size, cfg.layout->frameSize);
+    EXPECT_TRUE(tmp.matches(cfg));
+    const std::vector<std::uint8_t> original(tmp.data(), tmp.data() + tmp.size());
+
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<std::uint32_t> soc(0U, 0xFFFFFFFFU);
+    std::uniform_int_distribution<std::uint32_t> frac(0U, 999999U);
+    std::uniform_int_distribution<std::uint32_t> quality(0U, 15U);
+    for (int ii = 0; ii < 200; ++ii)
+    {
+        const auto fracSec = frac(gen) + (quality(gen) << 24U);
+        const auto seconds = soc(gen);
+        tmp.setTime(seconds, fracSec);
+        ASSERT_EQ(crcCCITT(tmp.data(), size - 2U), tmp.data()[size - 2] * 256U + tmp.data()[size - 1]);
+        // only the time fields and the CRC change
+        EXPECT_TRUE(std::equal(original.begin(), original.begin() + 6, tmp.data()));
+        EXPECT_TRUE(std::equal(original.begin() + 14, original.end() - 2, tmp.data() + 14));
+
+        auto decoded = parseDataFrame(tmp.data(), size, cfg);
+        ASSERT_EQ(decoded.parseResult, ParseResult::parse_complete);
+        EXPECT_EQ(decoded.soc, seconds);
+        EXPECT_EQ(decoded.timeQuality, fracSec >> 24U);
+        EXPECT_EQ(decoded.fracSec, static_cast<double>(fracSec & 0x00FFFFFFU) / cfg.timeBase);
+    }
+}
+
+TEST(frameTemplate, matches_generated)
+{
+    auto cfg = templateConfig();
+    auto frame = templateFrame();
+    DataFrameTemplate tmp;
+    ASSERT_GT(tmp.encode(cfg, frame), 0U);
+
+    frame.soc = 1600000123U;
+    frame.fracSec = 0.5;
+    frame.timeQuality = 0x05;
+    std::vector<std::uint8_t> expected(cfg.layout->frameSize);
+    ASSERT_EQ(generateDataFrame(expected.data(), expected.size(), cfg, frame), expected.size());
+
+    tmp.setTime(frame.soc, (0x05U << 24U) + cfg.timeBase / 2U);
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), tmp.data()));
+}
+
+TEST(frameTemplate, config_change)
+{
+    auto cfg = templateConfig();
+    DataFrameTemplate tmp;
+    ASSERT_GT(tmp.encode(cfg, templateFrame()), 0U);
+    EXPECT_TRUE(tmp.matches(cfg));
+    // a copy changed after the layout was compiled still carries the old layout
+    auto changed = cfg;
+    changed.pmus[0].phasorConversion[0] *= 2U;
+    EXPECT_FALSE(tmp.matches(changed));
+    // a separately compiled layout of the same structure matches
+    auto recompiled = cfg;
+    updateFrameLayout(recompiled);
+    EXPECT_TRUE(tmp.matches(recompiled));
+    cfg.idcode = 24;
+    EXPECT_FALSE(tmp.matches(cfg));
+    cfg.idcode = 23;
+    cfg.pmus[1].analogCount = 3;
+    updateFrameLayout(cfg);
+    EXPECT_FALSE(tmp.matches(cfg));
+    tmp.clear();
+    EXPECT_TRUE(tmp.empty());
+    EXPECT_FALSE(tmp.matches(templateConfig()));
+}
@@ -0,0 +1,200 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <gtest/gtest.h>
+#include "../src/pmu/c37118Kernels.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace c37118;
+
+/* the vector kernels must be bit identical to the scalar kernels for every count including the tails*/
+TEST(kernels, decode_int16_pairs)
+{
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<int> bytes(0, 255);
+    std::uniform_real_distribution<double> scales(1e-5, 10.0);
+    std::vector<std::uint8_t> data(4 * 40);
+    std::vector<double> scale(40);
+    for (auto &byte : data)
+    {
+        byte = static_cast<std::uint8_t>(bytes(gen));
+    }
+    for (auto &val : scale)
+    {
+        val = scales(gen);
+    }
+    for (std::size_t count = 0; count <= scale.size(); ++count)
+    {
+        std::vector<double> expected(2 * count);
+        std::vector<double> actual(2 * count);
+        kernels::scalar::decodeInt16Pairs(data.data(), count, scale.data(), expected.data());
+        if (kernels::sse41Supported())
+        {
+            kernels::sse41::decodeInt16Pairs(data.data(), count, scale.data(), actual.data());
+            ASSERT_EQ(actual, expected) << "count " << count;
+        }
+        if (kernels::avx2Supported())
+        {
+            kernels::avx2::decodeInt16Pairs(data.data(), count, scale.data(), actual.data());
+            ASSERT_EQ(actual, expected) << "count " << count;
+        }
+        decodeInt16Pairs(data.data(), count, scale.data(), actual.data());
+        ASSERT_EQ(actual, expected) << "count " << count;
+    }
+}
+
+TEST(kernels, decode_floats)
+{
+    std::mt19937 gen(29);
+    std::uniform_real_distribution<float> values(-1e6F, 1e6F);
+    std::vector<std::uint8_t> data(4 * 40);
+    for (std::size_t ii = 0; ii < data.size(); ii += 4)
+    {
+        float val = values(gen);
+        std::uint32_t bits;
+        std::memcpy(&bits, &val, sizeof(bits));
+        data[ii] = static_cast<std::uint8_t>(bits >> 24U);
+        data[ii + 1] = static_cast<std::uint8_t>(bits >> 16U);
+        data[ii + 2] = static_cast<std::uint8_t>(bits >> 8U);
+        data[ii + 3] = static_cast<std::uint8_t>(bits);
+    }
+    for (std::size_t count = 0; count <= 40; ++count)
+    {
+        std::vector<double> expected(count);
+        std::vector<double> actual(count);
+        kernels::scalar::decodeFloats(data.data(), count, expected.data());
+        if (kernels::sse41Supported())
+        {
+            kernels::sse41::decodeFloats(data.data(), count, actual.data());
+            ASSERT_EQ(actual, expected) << "count " << count;
+        }
+        if (kernels::avx2Supported())
+        {
+            kernels::avx2::decodeFloats(data.data(), count, actual.data());
+            ASSERT_EQ(actual, expected) << "count " << count;
+        }
+        decodeFloats(data.data(), count, actual.data());
+        ASSERT_EQ(actual, expected) << "count " << count;
+    }
+}
+
+/* includes values that saturate and values exactly half way between integers*/
+TEST(kernels, encode_int16_pairs)
+{
+    std::mt19937 gen(31);
+    std::uniform_real_distribution<double> values(-50000.0, 50000.0);
+    std::vector<double> input(2 * 40);
+    std::vector<double> inverseScale(40, 1.0);
+    for (auto &val : input)
+    {
+        val = values(gen);
+    }
+    input[1] = 0.5;
+    input[2] = -2.5;
+    input[5] = 32767.5;
+    input[6] = -32768.5;
+    input[9] = 1e300;
+    input[10] = -1e300;
+    inverseScale[7] = 0.37;
+    inverseScale[12] = 1e-3;
+    for (std::size_t count = 0; count <= inverseScale.size(); ++count)
+    {
+        std::vector<std::uint8_t> expected(4 * count);
+        std::vector<std::uint8_t> actual(4 * count);
+        kernels::scalar::encodeInt16Pairs(input.data(), count, inverseScale.data(), expected.data());
+        if (kernels::sse41Supported())
+        {
+            kernels::sse41::encodeInt16Pairs(input.data(), count, inverseScale.data(), actual.data());
+            ASSERT_EQ(actual, expected) << "count " << count;
+        }
+        if (kernels::avx2Supported())
+        {
+            kernels::avx2::encodeInt16Pairs(input.data(), count, inverseScale.data(), actual.data());
+            ASSERT_EQ(actual, expected) << "count " << count;
+        }
+        encodeInt16Pairs(input.data(), count, inverseScale.data(), actual.data());
+        ASSERT_EQ(actual, expected) << "count " << count;
+    }
+}
+
+TEST(kernels, encode_floats)
+{
+    std::mt19937 gen(37);
+    std::uniform_real_distribution<double> values(-1e6, 1e6);
+    std::vector<double> input(40);
+    for (auto &val : input)
+    {
+        val = values(gen);
+    }
+    for (std::size_t count = 0; count <= input.size(); ++count)
+    {
+        std::vector<std::uint8_t> expected(4 * count);
+        std::vector<std::uint8_t> actual(4 * count);
+        kernels::scalar::encodeFloats(input.data(), count, expected.data());
+        if (kernels::sse41Supported())
+        {
+            kernels::sse41::encodeFloats(input.data(), count, actual.data());
+            ASSERT_EQ(actual, expected) << "count " << count;
+        }
+        if (kernels::avx2Supported())
+        {
+            kernels::avx2::encodeFloats(input.data(), count, actual.data());
+            ASSERT_EQ(actual, expected) << "count " << count;
+        }
+        encodeFloats(input.data(), count, actual.data());
+        ASSERT_EQ(actual, expected) << "count " << count;
+    }
+}
+
+TEST(kernels, int16_round_trip)
+{
+    std::vector<std::uint8_t> data(4 * 32);
+    for (std::size_t ii = 0; ii < data.size(); ++ii)
+    {
+        data[ii] = static_cast<std::uint8_t>(ii * 37U + 11U);
+    }
+    std::vector<double> scale(32, 1e-5);
+    std::vector<double> inverseScale(32, 1e5);
+    std::vector<double> values(64);
+    std::vector<std::uint8_t> output(data.size());
+    decodeInt16Pairs(data.data(), 32, scale.data(), values.data());
+    encodeInt16Pairs(values.data(), 32, inverseScale.data(), output.data());
+    EXPECT_EQ(output, data);
+}
+
+TEST(kernels, find_byte)
+{
+    std::vector<std::uint8_t> data(100, 0x55);
+    for (std::size_t position = 0; position <= data.size(); ++position)
+    {
+        if (position < data.size())
+        {
+            data[position] = 0xAA;
+        }
+        for (std::size_t start : {0U, 1U, 5U})
+        {
+            const std::size_t count = data.size() - start;
+            const std::size_t expected = kernels::scalar::findByte(data.data() + start, count, 0xAA);
+            ASSERT_EQ(expected, (position >= start) ? position - start : count);
+            if (kernels::sse41Supported())
+            {
+                ASSERT_EQ(kernels::sse41::findByte(data.data() + start, count, 0xAA), expected);
+            }
+            if (kernels::avx2Supported())
+            {
+                ASSERT_EQ(kernels::avx2::findByte(data.data() + start, count, 0xAA), expected);
+            }
+            ASSERT_EQ(findByte(data.data() + start, count, 0xAA), expected);
+        }
+        if (position < data.size())
+        {
+            data[position] = 0x55;
+        }
+    }
+}
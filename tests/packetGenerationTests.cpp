@@ -8,6 +8,7 @@ the top-level NOTICE for additional details. All rights reserved. SPDX-License-I
 #include "PcapPacketParser.h"
 #include "../src/pmu/c37118.h"
 #include "../src/pmu/configure.hpp"
+#include "../src/pmu/FrameMemory.hpp"
 #include "../src/pmu/JsonProcessingFunctions.hpp"
 #include <filesystem>
 
@@ -426,6 +427,16 @@ TEST_F(PMU_TCP, json_data_generation)
 
     EXPECT_TRUE(match);
 
+    // the same file loaded into an arena
+    FrameArena arena;
+    auto arenaFrames = c37118::loadDataFile(fileName, arena.allocator());
+    ASSERT_EQ(arenaFrames.size(), 1U);
+    EXPECT_EQ(arenaFrames.front().pmus[0].phasors.get_allocator().resource(), arena.resource());
+    std::vector<std::uint8_t> arenaBuffer(1024);
+    size = generateDataFrame(arenaBuffer.data(), arenaBuffer.size(), cfg, arenaFrames.front());
+    arenaBuffer.resize(size);
+    EXPECT_EQ(arenaBuffer, buffer);
+
     std::filesystem::remove(fileName);
 }
 
@@ -304,4 +304,62 @@ TEST(header, headerGeneration)
 
     auto str = parseHeader(buffer.data(), bsize);
     EXPECT_EQ(str, headerString);
-}
\ No newline at end of file
+}
+
+TEST_F(PMU4_TCP, config_channel_names)
+{
+    std::vector<std::uint8_t> buffer(p.getPacket(4).begin(), p.getPacket(4).end());
+    buffer.insert(buffer.end(), p.getPacket(5).begin(), p.getPacket(5).end());
+    Config cfg;
+    ASSERT_EQ(parseConfig2(buffer.data(), buffer.size(), cfg), ParseResult::parse_complete);
+    for (const auto &pmu : cfg.pmus)
+    {
+        EXPECT_EQ(pmu.phasorNames.size(), pmu.phasorCount);
+        EXPECT_EQ(pmu.analogNames.size(), pmu.analogCount);
+        EXPECT_EQ(pmu.digitChannelNames.size(), 16U * pmu.digitalWordCount);
+        for (std::size_t ii = 0; ii < pmu.phasorNames.size(); ++ii)
+        {
+            EXPECT_LE(pmu.phasorNames[ii].size(), channel_name_size);
+        }
+    }
+
+    std::vector<std::uint8_t> generated(buffer.size() + 100);
+    auto size = generateConfig2(generated.data(), generated.size(), cfg);
+    ASSERT_GT(size, 0U);
+    Config copy;
+    ASSERT_EQ(parseConfig2(generated.data(), size, copy), ParseResult::parse_complete);
+    ASSERT_EQ(copy.pmus.size(), cfg.pmus.size());
+    for (std::size_t ii = 0; ii < cfg.pmus.size(); ++ii)
+    {
+        const auto &pmu = cfg.pmus[ii];
+        for (std::size_t jj = 0; jj < pmu.phasorNames.size(); ++jj)
+        {
+            EXPECT_EQ(copy.pmus[ii].phasorNames[jj], pmu.phasorNames[jj]);
+        }
+        for (std::size_t jj = 0; jj < pmu.digitChannelNames.size(); ++jj)
+        {
+            EXPECT_EQ(copy.pmus[ii].digitChannelNames[jj], pmu.digitChannelNames[jj]);
+        }
+    }
+}
+
+TEST(channelNames, table)
+{
+    ChannelNameTable names{"VA", "VB", "a name longer than sixteen"};
+    ASSERT_EQ(names.size(), 3U);
+    EXPECT_EQ(names[0], "VA");
+    EXPECT_EQ(names[1], "VB");
+    EXPECT_EQ(names[2], "a name longer th");
+    names.push_back("IA");
+    names.assign(1, "VB2");
+    EXPECT_EQ(names[1], "VB2");
+    EXPECT_EQ(names[3], "IA");
+    names.resize(5);
+    EXPECT_TRUE(names[4].empty());
+    // fields are copied as they appear in a frame including padding spaces
+    const std::string fields = "PHASOR 1        PHASOR 2        ";
+    names.assignFields(reinterpret_cast<const std::uint8_t *>(fields.data()), 2);
+    ASSERT_EQ(names.size(), 2U);
+    EXPECT_EQ(names[1], "PHASOR 2        ");
+    EXPECT_EQ(std::string(names.fields(), 32), fields);
+}
@@ -0,0 +1,206 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <gtest/gtest.h>
+#include "testConfigs.h"
+#include "../src/pmu/ReceiverGroup.hpp"
+#include "../src/pmu/TcpPmu.hpp"
+
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+
+#include <map>
+#include <mutex>
+#include <thread>
+
+using tcp = asio::ip::tcp;
+using namespace c37118;
+
+class receiverGroup: public ::testing::Test
+{
+  protected:
+    void TearDown() override
+    {
+        group.stop();
+        servers.clear();
+        runner.stop();
+    }
+    /* start a PMU and add it to the group*/
+    void addServer(std::uint16_t idcode)
+    {
+        servers.push_back(std::make_unique<pmu::TcpPmu>(stableSource(streamConfig(idcode, 30), idcode), context));
+        servers.back()->setInterface("127.0.0.1", "0");
+        ASSERT_TRUE(servers.back()->startServer(*context));
+        group.addDevice("127.0.0.1", std::to_string(servers.back()->getPort()), idcode);
+    }
+    void run() { runner.start(*context); }
+    /* wait for a condition on the state shared with the callbacks*/
+    template <class Condition>
+    bool waitLocked(Condition condition)
+    {
+        return waitFor(wait_timeout, [this, &condition]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return condition();
+        });
+    }
+
+    std::shared_ptr<asio::io_context> context{std::make_shared<asio::io_context>()};
+    std::vector<std::unique_ptr<pmu::TcpPmu>> servers;
+    pmu::ReceiverGroup group;
+    IoRunner runner;
+
+    std::mutex mutex;
+};
+
+TEST_F(receiverGroup, parallel_startup)
+{
+    constexpr std::uint16_t server_count{40U};
+    constexpr std::size_t silent_count{5U};
+    constexpr std::chrono::milliseconds config_timeout{400};
+    for (std::uint16_t ii = 0; ii < server_count; ++ii)
+    {
+        addServer(static_cast<std::uint16_t>(100U + ii));
+    }
+    // devices which accept the connection but never answer,  each takes the full configuration timeout
+    std::vector<std::unique_ptr<tcp::acceptor>> silent;
+    for (std::size_t ii = 0; ii < silent_count; ++ii)
+    {
+        silent.push_back(
+          std::make_unique<tcp::acceptor>(*context, tcp::endpoint(asio::ip::make_address("127.0.0.1"), 0)));
+        group.addDevice("127.0.0.1", std::to_string(silent.back()->local_endpoint().port()), 900U);
+    }
+    // a device refusing the connection
+    std::uint16_t refusedPort{0U};
+    {
+        tcp::acceptor closed(*context, tcp::endpoint(asio::ip::make_address("127.0.0.1"), 0));
+        refusedPort = closed.local_endpoint().port();
+    }
+    const auto refused = group.addDevice("127.0.0.1", std::to_string(refusedPort), 901U);
+    group.setTimeouts(std::chrono::milliseconds(2000), config_timeout);
+
+    std::map<std::size_t, std::vector<pmu::DeviceState>> transitions;
+    std::map<std::size_t, int> frames;
+    int badFrames{0};
+    group.setStateCall([&](std::size_t device, pmu::DeviceState state) {
+        std::lock_guard<std::mutex> lock(mutex);
+        transitions[device].push_back(state);
+    });
+    group.setFrameCall([&](std::size_t device, const FrameSpan &frame, const Config &config) {
+        std::lock_guard<std::mutex> lock(mutex);
+        PmuDataFrame pdf;
+        if (config.idcode == 100U + device &&
+            parseDataFrame(frame.data, frame.size, config, pdf) == ParseResult::parse_complete &&
+            pdf.idcode == config.idcode && std::abs(pdf.pmus[0].phasors[0].real() - config.idcode) < 0.01)
+        {
+            ++frames[device];
+        }
+        else
+        {
+            ++badFrames;
+        }
+    });
+    run();
+
+    const auto startTime = std::chrono::steady_clock::now();
+    group.start(*context);
+    ASSERT_TRUE(group.waitForStartup(std::chrono::seconds(5)));
+    const auto startup = std::chrono::steady_clock::now() - startTime;
+    // the silent devices time out together rather than one after another
+    EXPECT_GE(startup, config_timeout);
+    EXPECT_LT(startup, config_timeout * silent_count);
+
+    EXPECT_EQ(group.streamingCount(), server_count);
+    for (std::size_t ii = 0; ii < server_count; ++ii)
+    {
+        EXPECT_EQ(group.getState(ii), pmu::DeviceState::streaming);
+        const auto config = group.getConfig(ii);
+        EXPECT_EQ(config.idcode, 100U + ii);
+        ASSERT_EQ(config.pmus.size(), 1U);
+        EXPECT_EQ(std::string(config.pmus[0].stationName.c_str()), "STREAM" + std::to_string(100U + ii));
+    }
+    for (std::size_t ii = server_count; ii < group.deviceCount(); ++ii)
+    {
+        EXPECT_EQ(group.getState(ii), pmu::DeviceState::failed);
+        EXPECT_TRUE(group.getConfig(ii).pmus.empty());
+    }
+
+    ASSERT_TRUE(waitLocked([&]() {
+        if (frames.size() < server_count)
+        {
+            return false;
+        }
+        for (const auto &device : frames)
+        {
+            if (device.second < 2)
+            {
+                return false;
+            }
+        }
+        return true;
+    }));
+
+    // every connection is closed and no frame is delivered once stop returns
+    group.stop();
+    EXPECT_EQ(group.streamingCount(), 0U);
+    int delivered{0};
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto &device : frames)
+        {
+            delivered += device.second;
+        }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    int after{0};
+    for (const auto &device : frames)
+    {
+        after += device.second;
+    }
+    EXPECT_EQ(after, delivered);
+    EXPECT_EQ(badFrames, 0);
+    const std::vector<pmu::DeviceState> streamed{pmu::DeviceState::connecting,
+                                                 pmu::DeviceState::configuring,
+                                                 pmu::DeviceState::streaming,
+                                                 pmu::DeviceState::closed};
+    for (std::size_t ii = 0; ii < server_count; ++ii)
+    {
+        EXPECT_EQ(transitions[ii], streamed) << "device " << ii;
+    }
+    const std::vector<pmu::DeviceState> timedOut{
+      pmu::DeviceState::connecting, pmu::DeviceState::configuring, pmu::DeviceState::failed};
+    EXPECT_EQ(transitions[server_count], timedOut);
+    const std::vector<pmu::DeviceState> refusedStates{pmu::DeviceState::connecting, pmu::DeviceState::failed};
+    EXPECT_EQ(transitions[refused], refusedStates);
+}
+
+TEST_F(receiverGroup, destroyed_while_streaming)
+{
+    addServer(300U);
+    run();
+    int frames{0};
+    {
+        pmu::ReceiverGroup streaming;
+        streaming.addDevice("127.0.0.1", std::to_string(servers.back()->getPort()), 300U);
+        // the callback uses state owned by the test,  it must not run once the group is destroyed
+        streaming.setFrameCall([&](std::size_t /*device*/, const FrameSpan & /*frame*/, const Config & /*config*/) {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++frames;
+        });
+        streaming.start(*context);
+        ASSERT_TRUE(streaming.waitForStartup(std::chrono::seconds(5)));
+        ASSERT_TRUE(waitLocked([&]() { return frames > 2; }));
+    }
+    int delivered{0};
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        delivered = frames;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(frames, delivered);
+}
@@ -0,0 +1,302 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <gtest/gtest.h>
+#include "testConfigs.h"
+#include "../src/pmu/FrameExtractor.hpp"
+#include "../src/pmu/FrameTimeSequence.hpp"
+#include "../src/pmu/Receiver.hpp"
+#include "../src/pmu/TcpPmu.hpp"
+
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/write.hpp>
+
+#include <algorithm>
+#include <thread>
+
+using tcp = asio::ip::tcp;
+using namespace c37118;
+
+static constexpr std::uint16_t server_idcode{7U};
+
+static std::shared_ptr<pmu::StableSource> serverSource(std::uint16_t phasorCount = 3U, std::int16_t dataRate = 60)
+{
+    return stableSource(streamConfig(server_idcode, dataRate, floating_point_format, 0U, phasorCount));
+}
+
+/* a PDC connection reading the frames from the server*/
+class TestClient
+{
+  public:
+    TestClient(asio::io_context &context, std::uint16_t port, int receiveBufferSize = 0): mSocket(context)
+    {
+        mSocket.open(tcp::v4());
+        if (receiveBufferSize > 0)
+        {
+            mSocket.set_option(asio::socket_base::receive_buffer_size(receiveBufferSize));
+        }
+        mSocket.connect(tcp::endpoint(asio::ip::make_address("127.0.0.1"), port));
+    }
+
+    void command(PmuCommand cmd)
+    {
+        std::uint8_t buffer[64];
+        const auto size = generateCommand(buffer, sizeof(buffer), cmd, server_idcode);
+        asio::write(mSocket, asio::buffer(buffer, size));
+    }
+
+    /* read frames until count frames of a type have been received or the timeout expires*/
+    std::size_t readFrames(PmuPacketType type,
+                           std::size_t count,
+                           std::chrono::milliseconds timeout = std::chrono::milliseconds(5000))
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (frameCount(type) < count && std::chrono::steady_clock::now() < deadline)
+        {
+            asio::error_code ec;
+            const auto available = mSocket.available(ec);
+            if (ec)
+            {
+                break;
+            }
+            if (available == 0U)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                continue;
+            }
+            mBuffer.resize(available);
+            const auto bytes = mSocket.read_some(asio::buffer(mBuffer.data(), mBuffer.size()), ec);
+            if (ec)
+            {
+                break;
+            }
+            mExtractor.push(mBuffer.data(), bytes);
+            FrameSpan frame;
+            while (mExtractor.next(frame))
+            {
+                frames.emplace_back(frame.data, frame.data + frame.size);
+            }
+        }
+        return frameCount(type);
+    }
+
+    std::size_t frameCount(PmuPacketType type) const
+    {
+        return static_cast<std::size_t>(std::count_if(frames.begin(), frames.end(), [type](const auto &frame) {
+            return getPacketType(frame.data(), frame.size()) == type;
+        }));
+    }
+
+    std::vector<std::vector<std::uint8_t>> dataFrames() const
+    {
+        std::vector<std::vector<std::uint8_t>> result;
+        std::copy_if(frames.begin(), frames.end(), std::back_inserter(result), [](const auto &frame) {
+            return getPacketType(frame.data(), frame.size()) == PmuPacketType::data;
+        });
+        return result;
+    }
+
+    std::vector<std::vector<std::uint8_t>> frames;
+
+  private:
+    tcp::socket mSocket;
+    std::vector<std::uint8_t> mBuffer;
+    FrameExtractor mExtractor;
+};
+
+/* the position of a data frame in the sequence of frames of a data rate*/
+static std::int64_t frameIndex(const std::vector<std::uint8_t> &frame, const Config &cfg)
+{
+    PmuDataFrame pdf;
+    if (parseDataFrame(frame.data(), frame.size(), cfg, pdf) != ParseResult::parse_complete)
+    {
+        return -1;
+    }
+    const FrameTimeSequence sequence(cfg);
+    const auto &ticks = sequence.ticks();
+    const auto tick = std::find(ticks.begin(), ticks.end(), pdf.fracSecTicks);
+    if (tick == ticks.end())
+    {
+        return -1;
+    }
+    return static_cast<std::int64_t>(pdf.soc) * cfg.dataRate + (tick - ticks.begin());
+}
+
+class tcpPmu: public ::testing::Test
+{
+  protected:
+    void startServer(std::shared_ptr<pmu::StableSource> serverSrc,
+                     std::size_t queueLimit = pmu::default_send_queue_limit,
+                     pmu::SlowClientPolicy policy = pmu::SlowClientPolicy::drop_oldest,
+                     int sendBufferSize = 0)
+    {
+        source = std::move(serverSrc);
+        server = std::make_unique<pmu::TcpPmu>(source, context);
+        server->setInterface("127.0.0.1", "0");
+        server->setHeader("test server");
+        server->setSendQueue(queueLimit, policy);
+        server->setSendBufferSize(sendBufferSize);
+        ASSERT_TRUE(server->startServer(*context));
+        ASSERT_NE(server->getPort(), 0U);
+        runner.start(*context);
+    }
+
+    /* a client which turns data on and stops reading while another client keeps up*/
+    void slowClient(pmu::SlowClientPolicy policy)
+    {
+        // frames of 8kB at 120 frames per second with small socket buffers
+        startServer(serverSource(1000U, 120), 4U, policy, 4096);
+        asio::io_context clientContext;
+        TestClient slow(clientContext, server->getPort(), 4096);
+        TestClient fast(clientContext, server->getPort());
+        slow.command(PmuCommand::data_on);
+        fast.command(PmuCommand::data_on);
+        ASSERT_GE(fast.readFrames(PmuPacketType::data, 60U), 60U);
+
+        // the slow client does not delay the frames of the other client
+        const auto &cfg = source->getConfig();
+        const auto frames = fast.dataFrames();
+        for (std::size_t ii = 1; ii < frames.size(); ++ii)
+        {
+            EXPECT_EQ(frameIndex(frames[ii], cfg), frameIndex(frames[ii - 1], cfg) + 1);
+        }
+        EXPECT_EQ(server->queueHighWater(), 4U);
+        if (policy == pmu::SlowClientPolicy::disconnect)
+        {
+            EXPECT_EQ(server->slowClientDisconnects(), 1U);
+            EXPECT_EQ(server->droppedFrames(), 0U);
+            EXPECT_EQ(server->sessionCount(), 1U);
+            return;
+        }
+        EXPECT_GT(server->droppedFrames(), 0U);
+        EXPECT_EQ(server->slowClientDisconnects(), 0U);
+        EXPECT_EQ(server->sessionCount(), 2U);
+        // the frames the slow client does get are in order
+        slow.readFrames(PmuPacketType::data, 1000U, std::chrono::milliseconds(200));
+        const auto slowFrames = slow.dataFrames();
+        ASSERT_GT(slowFrames.size(), 1U);
+        for (std::size_t ii = 1; ii < slowFrames.size(); ++ii)
+        {
+            EXPECT_GT(frameIndex(slowFrames[ii], cfg), frameIndex(slowFrames[ii - 1], cfg));
+        }
+    }
+
+    void TearDown() override
+    {
+        server.reset();
+        runner.stop();
+    }
+
+    std::shared_ptr<pmu::StableSource> source;
+    std::shared_ptr<asio::io_context> context{std::make_shared<asio::io_context>()};
+    std::unique_ptr<pmu::TcpPmu> server;
+    IoRunner runner;
+};
+
+TEST_F(tcpPmu, commands)
+{
+    startServer(serverSource());
+    asio::io_context clientContext;
+    TestClient client(clientContext, server->getPort());
+    client.command(PmuCommand::send_config2);
+    ASSERT_EQ(client.readFrames(PmuPacketType::config2, 1U), 1U);
+    Config cfg;
+    EXPECT_EQ(parseConfig2(client.frames[0].data(), client.frames[0].size(), cfg), ParseResult::parse_complete);
+    EXPECT_EQ(cfg.idcode, server_idcode);
+    EXPECT_EQ(cfg.dataRate, 60);
+    ASSERT_EQ(cfg.pmus.size(), 1U);
+    EXPECT_EQ(cfg.pmus[0].phasorCount, 3U);
+
+    client.command(PmuCommand::send_header);
+    EXPECT_EQ(client.readFrames(PmuPacketType::header, 1U), 1U);
+    client.command(PmuCommand::send_config1);
+    EXPECT_EQ(client.readFrames(PmuPacketType::config1, 1U), 1U);
+    // no data is sent until it is requested
+    client.readFrames(PmuPacketType::data, 1U, std::chrono::milliseconds(100));
+    EXPECT_EQ(client.frameCount(PmuPacketType::data), 0U);
+    EXPECT_EQ(server->sessionCount(), 1U);
+}
+
+TEST_F(tcpPmu, receiver_split_config)
+{
+    startServer(serverSource(20U));
+    pmu::Receiver receiver;
+    receiver.address = "127.0.0.1";
+    receiver.port = std::to_string(server->getPort());
+    receiver.idCode = server_idcode;
+    ASSERT_TRUE(receiver.connect(*context));
+    // every read reuses one buffer much smaller than the configuration frame
+    receiver.buffer.resize(64U);
+    ASSERT_TRUE(receiver.getConfig());
+    EXPECT_EQ(receiver.config.idcode, server_idcode);
+    ASSERT_EQ(receiver.config.pmus.size(), 1U);
+    EXPECT_EQ(receiver.config.pmus[0].phasorCount, 20U);
+    receiver.connection->close();
+}
+
+TEST_F(tcpPmu, fan_out)
+{
+    startServer(serverSource());
+    asio::io_context clientContext;
+    std::vector<std::unique_ptr<TestClient>> clients;
+    for (int ii = 0; ii < 3; ++ii)
+    {
+        clients.push_back(std::make_unique<TestClient>(clientContext, server->getPort()));
+        clients.back()->command(PmuCommand::data_on);
+    }
+    // a client that only asks for the configuration
+    TestClient idle(clientContext, server->getPort());
+    idle.command(PmuCommand::send_config2);
+    ASSERT_EQ(idle.readFrames(PmuPacketType::config2, 1U), 1U);
+
+    for (auto &client : clients)
+    {
+        ASSERT_GE(client->readFrames(PmuPacketType::data, 8U), 8U);
+    }
+    const auto &cfg = source->getConfig();
+    FrameTimeSequence sequence(cfg);
+    for (const auto &frame : clients[0]->dataFrames())
+    {
+        PmuDataFrame pdf;
+        ASSERT_EQ(parseDataFrame(frame.data(), frame.size(), cfg, pdf), ParseResult::parse_complete);
+        // frames are sent at the frame times of the data rate
+        EXPECT_NE(std::find(sequence.ticks().begin(), sequence.ticks().end(), pdf.fracSecTicks),
+                  sequence.ticks().end());
+        // every session receiving a frame gets the same encoded bytes
+        for (std::size_t ii = 1; ii < clients.size(); ++ii)
+        {
+            auto other = clients[ii]->dataFrames();
+            auto match = std::find_if(other.begin(), other.end(), [&frame](const auto &otherFrame) {
+                return std::equal(frame.begin() + 6, frame.begin() + 14, otherFrame.begin() + 6);
+            });
+            if (match != other.end())
+            {
+                EXPECT_EQ(*match, frame);
+            }
+        }
+    }
+    // each frame is encoded once for all the sessions
+    std::size_t received{0U};
+    for (auto &client : clients)
+    {
+        received = std::max(received, client->frameCount(PmuPacketType::data));
+    }
+    EXPECT_LT(server->framesEncoded(), 2U * received);
+    EXPECT_EQ(idle.frameCount(PmuPacketType::data), 0U);
+    EXPECT_EQ(server->sessionCount(), 4U);
+
+    clients[0]->command(PmuCommand::data_off);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const auto before = clients[0]->readFrames(PmuPacketType::data, 1000U, std::chrono::milliseconds(50));
+    EXPECT_EQ(clients[0]->readFrames(PmuPacketType::data, 1000U, std::chrono::milliseconds(100)), before);
+}
+
+TEST_F(tcpPmu, slow_client_drop_oldest) { slowClient(pmu::SlowClientPolicy::drop_oldest); }
+
+TEST_F(tcpPmu, slow_client_drop_newest) { slowClient(pmu::SlowClientPolicy::drop_newest); }
+
+TEST_F(tcpPmu, slow_client_disconnect) { slowClient(pmu::SlowClientPolicy::disconnect); }
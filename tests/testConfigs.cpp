@@ -0,0 +1,104 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "testConfigs.h"
+
+#include <asio/executor_work_guard.hpp>
+
+#include <string>
+
+using namespace c37118;
+
+Config loadCaptureConfig(const PcapPacketParser &p, std::size_t index)
+{
+    const auto &pkt = p.getPacket(index);
+    Config cfg;
+    auto result = parseConfig2(pkt.data(), pkt.size(), cfg);
+    if (result == ParseResult::length_mismatch)
+    {
+        std::vector<std::uint8_t> buffer(pkt.begin(), pkt.end());
+        buffer.insert(buffer.end(), p.getPacket(index + 1).begin(), p.getPacket(index + 1).end());
+        parseConfig2(buffer.data(), buffer.size(), cfg);
+    }
+    return cfg;
+}
+
+Config streamConfig(std::uint16_t idcode,
+                    std::int16_t dataRate,
+                    std::uint8_t phasorFormat,
+                    std::uint16_t analogCount,
+                    std::uint16_t phasorCount)
+{
+    Config cfg;
+    cfg.idcode = idcode;
+    cfg.dataRate = dataRate;
+    cfg.timeBase = 1000000;
+    PmuConfig pmu;
+    pmu.sourceID = idcode;
+    pmu.stationName = "STREAM" + std::to_string(idcode);
+    pmu.phasorCount = phasorCount;
+    for (std::uint16_t ii = 0; ii < phasorCount; ++ii)
+    {
+        const bool voltage = (ii % 2 == 0);
+        pmu.phasorNames.push_back((voltage ? "V" : "I") + std::to_string(ii / 2 + 1));
+        pmu.phasorType.push_back(voltage ? PhasorType::voltage : PhasorType::current);
+        pmu.phasorConversion.push_back(1000);
+    }
+    pmu.phasorFormat = phasorFormat;
+    pmu.freqFormat = floating_point_format;
+    pmu.analogCount = analogCount;
+    for (std::uint16_t ii = 0; ii < analogCount; ++ii)
+    {
+        pmu.analogNames.push_back("A" + std::to_string(ii + 1));
+        pmu.analogConversion.push_back(1);
+    }
+    pmu.digitalWordCount = 0;
+    cfg.pmus.push_back(std::move(pmu));
+    return cfg;
+}
+
+std::shared_ptr<pmu::StableSource> stableSource(const Config &config, double voltage)
+{
+    PmuDataFrame pdf;
+    pdf.idcode = config.idcode;
+    for (const auto &pmu : config.pmus)
+    {
+        PmuData pd;
+        for (const auto type : pmu.phasorType)
+        {
+            pd.phasors.push_back((type == PhasorType::voltage) ? std::polar(voltage, 0.0) : std::polar(5.0, -0.3));
+        }
+        pd.analog.assign(pmu.analogCount, 0.0);
+        pd.digital.assign(pmu.digitalWordCount, 0U);
+        pd.freq = 0.0;
+        pd.rocof = 0.0;
+        pd.stat = 0;
+        pdf.pmus.push_back(pd);
+    }
+
+    auto source = std::make_shared<pmu::StableSource>();
+    source->setConfig(config);
+    source->setData(pdf);
+    return source;
+}
+
+void IoRunner::start(asio::io_context &context)
+{
+    mContext = &context;
+    mThread = std::thread([&context]() {
+        auto guard = asio::make_work_guard(context);
+        context.run();
+    });
+}
+
+void IoRunner::stop()
+{
+    if (mThread.joinable())
+    {
+        mContext->stop();
+        mThread.join();
+    }
+}
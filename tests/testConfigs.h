@@ -0,0 +1,75 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+#include "PcapPacketParser.h"
+#include "../src/pmu/StableSource.hpp"
+#include "../src/pmu/c37118.h"
+
+#include <asio/io_context.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+/** parse the config2 frame of a capture
+@details a configuration split across two packets is joined with the packet after it*/
+c37118::Config loadCaptureConfig(const PcapPacketParser &p, std::size_t index);
+
+/** a configuration of a single PMU with alternating voltage and current phasors and floating point frequencies
+@param phasorFormat the format of the phasors,  integer phasors have a step of 0.01
+@param analogCount the number of analog channels
+@param phasorCount the number of phasors*/
+c37118::Config streamConfig(std::uint16_t idcode,
+                            std::int16_t dataRate,
+                            std::uint8_t phasorFormat = c37118::floating_point_format,
+                            std::uint16_t analogCount = 0U,
+                            std::uint16_t phasorCount = 2U);
+
+/** a source sending the same data in every frame of a configuration
+@details the voltage phasors have the given magnitude and no angle,  the current phasors are 5 at -0.3 radians and
+the other fields are 0*/
+std::shared_ptr<pmu::StableSource> stableSource(const c37118::Config &config, double voltage = 120.0);
+
+/** the time a test waits for something to happen on another thread before failing*/
+static constexpr std::chrono::seconds wait_timeout{5};
+
+/** run an io_context on its own thread
+@details the context keeps running when it has no work until stop is called or the runner is destroyed*/
+class IoRunner
+{
+  public:
+    IoRunner() = default;
+    IoRunner(const IoRunner &) = delete;
+    IoRunner &operator=(const IoRunner &) = delete;
+    ~IoRunner() { stop(); }
+
+    void start(asio::io_context &context);
+    /** stop the context and wait for the thread to finish*/
+    void stop();
+    std::thread::id threadId() const { return mThread.get_id(); }
+
+  private:
+    asio::io_context *mContext{nullptr};
+    std::thread mThread;
+};
+
+/** poll a predicate until it is true or the timeout expires
+@return the final value of the predicate*/
+template <class Predicate>
+bool waitFor(std::chrono::steady_clock::duration timeout, Predicate predicate)
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!predicate())
+    {
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            return predicate();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return true;
+}
@@ -0,0 +1,182 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <gtest/gtest.h>
+#include "../src/pmu/c37118.h"
+#include "../src/pmu/FrameLayout.hpp"
+#include "../src/pmu/FrameTimeSequence.hpp"
+
+#include <random>
+
+using namespace c37118;
+
+TEST(timeCodes, round_trip)
+{
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<std::uint32_t> soc(0U, 0x7FFFFFFFU);
+    for (std::uint32_t timeBase : {1000U, 1000000U, 16777215U, 3U, 60U})
+    {
+        std::uniform_int_distribution<std::uint32_t> ticks(0U, timeBase - 1U);
+        for (int ii = 0; ii < 1000; ++ii)
+        {
+            const auto seconds = soc(gen);
+            const auto count = ticks(gen);
+            const auto tp = toNanoseconds(seconds, count, timeBase);
+            const auto code = toTimeCode(tp, timeBase);
+            EXPECT_EQ(code.soc, seconds);
+            ASSERT_EQ(code.ticks, count) << "time base " << timeBase;
+            // one nanosecond earlier is the previous count
+            if (count > 0U)
+            {
+                EXPECT_EQ(toTimeCode(tp - std::chrono::nanoseconds(1), timeBase).ticks, count - 1U);
+            }
+        }
+    }
+}
+
+TEST(timeCodes, generate_time_codes)
+{
+    const std::chrono::nanoseconds tp{1'600'000'123'333'333'999LL};
+    auto tc = generateTimeCodes(tp, 1'000'000U);
+    EXPECT_EQ(tc.first, 1600000123U);
+    EXPECT_EQ(tc.second, 333333U);
+
+    tc = generateTimeCodes(std::chrono::seconds(1600000124), 1'000'000U, 0.5F);
+    EXPECT_EQ(tc.first, 1600000124U);
+    EXPECT_EQ(tc.second & 0x00FFFFFFU, 0U);
+    EXPECT_NE(tc.second >> 24U, 0U);
+}
+
+TEST(timeCodes, exact_frame_time)
+{
+    Config cfg;
+    cfg.idcode = 5;
+    cfg.timeBase = 16777215U;
+    PmuConfig pmu{};
+    pmu.phasorFormat = floating_point_format;
+    pmu.analogFormat = floating_point_format;
+    pmu.freqFormat = floating_point_format;
+    pmu.phasorCount = 1;
+    cfg.pmus.push_back(pmu);
+    updateFrameLayout(cfg);
+
+    PmuDataFrame frame;
+    frame.timeQuality = 0;
+    frame.pmus.resize(1);
+    frame.pmus[0].stat = 0;
+    frame.pmus[0].freq = 0.0;
+    frame.pmus[0].rocof = 0.0;
+    frame.pmus[0].phasors = {{1.0, 0.0}};
+
+    std::vector<std::uint8_t> buffer(cfg.layout->frameSize);
+    PmuDataFrame decoded;
+    for (std::uint32_t ticks = 16777000U; ticks < 16777215U; ++ticks)
+    {
+        setFrameTime(frame, 1600000000U, ticks, cfg.timeBase);
+        ASSERT_EQ(generateDataFrame(buffer.data(), buffer.size(), cfg, frame), buffer.size());
+        ASSERT_EQ(parseDataFrame(buffer.data(), buffer.size(), cfg, decoded), ParseResult::parse_complete);
+        EXPECT_EQ(decoded.fracSecTicks, ticks);
+        EXPECT_TRUE(decoded.exactTime);
+        // a parsed frame encodes the same time again
+        std::vector<std::uint8_t> again(buffer.size());
+        ASSERT_EQ(generateDataFrame(again.data(), again.size(), cfg, decoded), again.size());
+        EXPECT_EQ(again, buffer);
+    }
+}
+
+TEST(timeCodes, changed_frame_time)
+{
+    Config cfg;
+    cfg.idcode = 5;
+    cfg.timeBase = 1000000U;
+    PmuConfig pmu{};
+    pmu.phasorFormat = floating_point_format;
+    pmu.analogFormat = floating_point_format;
+    pmu.freqFormat = floating_point_format;
+    pmu.phasorCount = 1;
+    cfg.pmus.push_back(pmu);
+    updateFrameLayout(cfg);
+
+    PmuDataFrame frame;
+    frame.timeQuality = 0;
+    frame.pmus.resize(1);
+    frame.pmus[0].stat = 0;
+    frame.pmus[0].freq = 0.0;
+    frame.pmus[0].rocof = 0.0;
+    frame.pmus[0].phasors = {{1.0, 0.0}};
+    std::vector<std::uint8_t> buffer(cfg.layout->frameSize);
+    PmuDataFrame decoded;
+
+    // the count is encoded while exactTime is set
+    setFrameTime(frame, 1600000000U, 250000U, cfg.timeBase);
+    frame.fracSec = 0.5;
+    ASSERT_EQ(generateDataFrame(buffer.data(), buffer.size(), cfg, frame), buffer.size());
+    ASSERT_EQ(parseDataFrame(buffer.data(), buffer.size(), cfg, decoded), ParseResult::parse_complete);
+    EXPECT_EQ(decoded.fracSecTicks, 250000U);
+
+    // an edited fracSec replaces the count once exactTime is cleared
+    frame.exactTime = false;
+    ASSERT_EQ(generateDataFrame(buffer.data(), buffer.size(), cfg, frame), buffer.size());
+    ASSERT_EQ(parseDataFrame(buffer.data(), buffer.size(), cfg, decoded), ParseResult::parse_complete);
+    EXPECT_EQ(decoded.fracSecTicks, 500000U);
+
+    // a count from a stream with another time base is rescaled
+    setFrameTime(frame, 1600000000U, 15U, 60U);
+    ASSERT_EQ(generateDataFrame(buffer.data(), buffer.size(), cfg, frame), buffer.size());
+    ASSERT_EQ(parseDataFrame(buffer.data(), buffer.size(), cfg, decoded), ParseResult::parse_complete);
+    EXPECT_EQ(decoded.soc, 1600000000U);
+    EXPECT_EQ(decoded.fracSecTicks, 250000U);
+
+    // rounding to the end of the second carries into the next second
+    setFrameTime(frame, 1600000000U, 16777214U, 16777215U);
+    ASSERT_EQ(generateDataFrame(buffer.data(), buffer.size(), cfg, frame), buffer.size());
+    ASSERT_EQ(parseDataFrame(buffer.data(), buffer.size(), cfg, decoded), ParseResult::parse_complete);
+    EXPECT_EQ(decoded.soc, 1600000001U);
+    EXPECT_EQ(decoded.fracSecTicks, 0U);
+}
+
+TEST(timeCodes, sequence)
+{
+    for (std::int16_t rate : {1, 10, 25, 30, 50, 60, 120, 240})
+    {
+        FrameTimeSequence seq(rate, 1000000U);
+        ASSERT_EQ(seq.ticks().size(), static_cast<std::size_t>(rate));
+        seq.start(std::chrono::seconds(1600000000));
+        for (int ii = 0; ii < 3 * rate; ++ii)
+        {
+            const auto code = seq.current();
+            EXPECT_EQ(code.soc, 1600000000U + static_cast<std::uint32_t>(ii / rate));
+            const double exact = static_cast<double>(ii % rate) * 1000000.0 / static_cast<double>(rate);
+            EXPECT_LE(std::abs(static_cast<double>(code.ticks) - exact), 0.5);
+            EXPECT_EQ(seq.currentTime(),
+                      std::chrono::seconds(code.soc) +
+                        std::chrono::nanoseconds((2LL * (ii % rate) * 1000000000LL + rate) / (2LL * rate)));
+            seq.advance();
+        }
+    }
+}
+
+TEST(timeCodes, sequence_start)
+{
+    FrameTimeSequence seq(30, 1000000U);
+    seq.start(std::chrono::seconds(100) + std::chrono::milliseconds(40));
+    EXPECT_EQ(seq.current().soc, 100U);
+    EXPECT_EQ(seq.current().ticks, 66667U);
+    seq.start(std::chrono::seconds(100) + std::chrono::milliseconds(990));
+    EXPECT_EQ(seq.current().soc, 101U);
+    EXPECT_EQ(seq.current().ticks, 0U);
+    seq.start(std::chrono::seconds(100));
+    EXPECT_EQ(seq.current().ticks, 0U);
+
+    // negative rates are seconds per frame
+    FrameTimeSequence slow(-5, 1000000U);
+    slow.start(std::chrono::seconds(101) + std::chrono::milliseconds(1));
+    EXPECT_EQ(slow.current().soc, 105U);
+    slow.advance();
+    EXPECT_EQ(slow.current().soc, 110U);
+    EXPECT_EQ(slow.current().ticks, 0U);
+    EXPECT_EQ(slow.currentTime(), std::chrono::seconds(110));
+}
@@ -0,0 +1,207 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <gtest/gtest.h>
+#include "testConfigs.h"
+#include "../src/pmu/UdpPmu.hpp"
+
+#include <asio/io_context.hpp>
+#include <asio/ip/multicast.hpp>
+#include <asio/ip/udp.hpp>
+
+#include <algorithm>
+#include <thread>
+
+using udp = asio::ip::udp;
+using namespace c37118;
+
+static constexpr std::uint16_t server_idcode{9U};
+
+static std::shared_ptr<pmu::StableSource> serverSource() { return stableSource(streamConfig(server_idcode, 60)); }
+
+/* a PDC receiving datagrams from the server*/
+class TestReceiver
+{
+  public:
+    explicit TestReceiver(asio::io_context &context):
+        mSocket(context, udp::endpoint(asio::ip::make_address("127.0.0.1"), 0))
+    {
+    }
+    TestReceiver(asio::io_context &context, const asio::ip::address &group, std::uint16_t port): mSocket(context)
+    {
+        mSocket.open(udp::v4());
+        mSocket.set_option(asio::socket_base::reuse_address(true));
+        mSocket.bind(udp::endpoint(asio::ip::address_v4::any(), port));
+        mSocket.set_option(
+          asio::ip::multicast::join_group(group.to_v4(), asio::ip::make_address_v4("127.0.0.1")), joinError);
+    }
+
+    std::uint16_t port() const { return mSocket.local_endpoint().port(); }
+
+    void command(PmuCommand cmd, std::uint16_t serverPort)
+    {
+        std::uint8_t buffer[64];
+        const auto size = generateCommand(buffer, sizeof(buffer), cmd, server_idcode);
+        mSocket.send_to(asio::buffer(buffer, size), udp::endpoint(asio::ip::make_address("127.0.0.1"), serverPort));
+    }
+
+    /* receive datagrams until count frames of a type have been received or the timeout expires*/
+    std::size_t receive(PmuPacketType type,
+                        std::size_t count,
+                        std::chrono::milliseconds timeout = std::chrono::milliseconds(5000))
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        std::vector<std::uint8_t> buffer(max_frame_size);
+        while (frameCount(type) < count && std::chrono::steady_clock::now() < deadline)
+        {
+            asio::error_code ec;
+            if (mSocket.available(ec) == 0U)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                continue;
+            }
+            udp::endpoint sender;
+            const auto bytes = mSocket.receive_from(asio::buffer(buffer.data(), buffer.size()), sender, 0, ec);
+            if (!ec)
+            {
+                frames.emplace_back(buffer.begin(), buffer.begin() + bytes);
+            }
+        }
+        return frameCount(type);
+    }
+
+    std::size_t frameCount(PmuPacketType type) const
+    {
+        return static_cast<std::size_t>(std::count_if(frames.begin(), frames.end(), [type](const auto &frame) {
+            return getPacketType(frame.data(), frame.size()) == type;
+        }));
+    }
+
+    std::vector<std::vector<std::uint8_t>> frames;
+    asio::error_code joinError;
+
+  private:
+    udp::socket mSocket;
+};
+
+class udpPmu: public ::testing::Test
+{
+  protected:
+    void startServer()
+    {
+        ASSERT_TRUE(server->startServer(*context));
+        ASSERT_NE(server->getPort(), 0U);
+        runner.start(*context);
+    }
+    void SetUp() override
+    {
+        server = std::make_unique<pmu::UdpPmu>(source, context);
+        server->setInterface("127.0.0.1", "0");
+        server->setHeader("udp test server");
+    }
+    void TearDown() override
+    {
+        server.reset();
+        runner.stop();
+    }
+
+    std::shared_ptr<pmu::StableSource> source{serverSource()};
+    std::shared_ptr<asio::io_context> context{std::make_shared<asio::io_context>()};
+    std::unique_ptr<pmu::UdpPmu> server;
+    IoRunner runner;
+    asio::io_context clientContext;
+};
+
+TEST_F(udpPmu, unicast_batch)
+{
+    std::vector<std::unique_ptr<TestReceiver>> receivers;
+    for (int ii = 0; ii < 3; ++ii)
+    {
+        receivers.push_back(std::make_unique<TestReceiver>(clientContext));
+        server->addDestination("127.0.0.1", std::to_string(receivers.back()->port()));
+    }
+    startServer();
+    for (auto &receiver : receivers)
+    {
+        ASSERT_GE(receiver->receive(PmuPacketType::data, 10U), 10U);
+    }
+    const auto &cfg = source->getConfig();
+    for (const auto &frame : receivers[0]->frames)
+    {
+        PmuDataFrame pdf;
+        ASSERT_EQ(parseDataFrame(frame.data(), frame.size(), cfg, pdf), ParseResult::parse_complete);
+        EXPECT_EQ(pdf.pmus[0].phasors.size(), 2U);
+        // the same encoded frame goes to every destination
+        for (std::size_t ii = 1; ii < receivers.size(); ++ii)
+        {
+            const auto &other = receivers[ii]->frames;
+            auto match = std::find_if(other.begin(), other.end(), [&frame](const auto &otherFrame) {
+                return std::equal(frame.begin() + 6, frame.begin() + 14, otherFrame.begin() + 6);
+            });
+            if (match != other.end())
+            {
+                EXPECT_EQ(*match, frame);
+            }
+        }
+    }
+    const auto calls = server->sendCalls();
+    const auto sent = server->datagramsSent();
+    EXPECT_GE(sent, 30U);
+    EXPECT_EQ(server->sendErrors(), 0U);
+#ifdef __linux__
+    // the datagrams for all the destinations of a tick are sent in one call
+    EXPECT_LE(2U * calls, sent);
+#else
+    EXPECT_GE(calls, sent);
+#endif
+}
+
+TEST_F(udpPmu, commands)
+{
+    startServer();
+    TestReceiver client(clientContext);
+    client.command(PmuCommand::send_config2, server->getPort());
+    ASSERT_EQ(client.receive(PmuPacketType::config2, 1U), 1U);
+    Config cfg;
+    EXPECT_EQ(parseConfig2(client.frames[0].data(), client.frames[0].size(), cfg), ParseResult::parse_complete);
+    EXPECT_EQ(cfg.idcode, server_idcode);
+    client.command(PmuCommand::send_header, server->getPort());
+    EXPECT_EQ(client.receive(PmuPacketType::header, 1U), 1U);
+
+    // a data on command does not add a destination by default
+    client.command(PmuCommand::data_on, server->getPort());
+    EXPECT_EQ(client.receive(PmuPacketType::data, 1U, std::chrono::milliseconds(200)), 0U);
+}
+
+TEST_F(udpPmu, command_destinations)
+{
+    server->setCommandDestinations(true);
+    startServer();
+    TestReceiver client(clientContext);
+    // nothing is sent until the client asks for data
+    EXPECT_EQ(client.receive(PmuPacketType::data, 1U, std::chrono::milliseconds(100)), 0U);
+    client.command(PmuCommand::data_on, server->getPort());
+    EXPECT_GE(client.receive(PmuPacketType::data, 5U), 5U);
+    client.command(PmuCommand::data_off, server->getPort());
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const auto before = client.receive(PmuPacketType::data, 1000U, std::chrono::milliseconds(20));
+    EXPECT_EQ(client.receive(PmuPacketType::data, 1000U, std::chrono::milliseconds(100)), before);
+}
+
+TEST_F(udpPmu, multicast)
+{
+    const auto group = asio::ip::make_address("239.255.71.18");
+    TestReceiver probe(clientContext);
+    const auto port = probe.port();
+    TestReceiver receiver(clientContext, group, static_cast<std::uint16_t>(port + 1U));
+    if (receiver.joinError)
+    {
+        GTEST_SKIP() << "multicast is not available: " << receiver.joinError.message();
+    }
+    server->addDestination(group.to_string(), std::to_string(receiver.port()));
+    startServer();
+    EXPECT_GE(receiver.receive(PmuPacketType::data, 5U), 5U);
+}
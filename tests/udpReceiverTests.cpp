@@ -0,0 +1,280 @@
+/*
+Copyright (c) 2021,
+Battelle Memorial Institute; Lawrence Livermore National Security, LLC; Alliance for Sustainable Energy, LLC.  See
+the top-level NOTICE for additional details. All rights reserved. SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <gtest/gtest.h>
+#include "testConfigs.h"
+#include "../src/pmu/UdpReceiver.hpp"
+
+#include <asio/io_context.hpp>
+#include <asio/ip/udp.hpp>
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using udp = asio::ip::udp;
+using namespace c37118;
+
+/* the streams differ in format so routing a frame to the wrong configuration fails to parse*/
+static Config mixedStreamConfig(std::uint16_t idcode)
+{
+    return streamConfig(idcode, 60, (idcode % 2 == 0) ? floating_point_format : integer_format);
+}
+
+static std::vector<std::uint8_t> dataFrame(const Config &cfg, std::uint32_t soc)
+{
+    PmuDataFrame pdf;
+    pdf.idcode = cfg.idcode;
+    pdf.soc = soc;
+    PmuData pd;
+    pd.phasors = {std::polar(120.0, 0.0), std::polar(5.0, -0.3)};
+    pd.freq = 0.0;
+    pd.rocof = 0.0;
+    pd.stat = 0;
+    pdf.pmus.push_back(pd);
+    std::vector<std::uint8_t> frame(1024);
+    frame.resize(generateDataFrame(frame.data(), frame.size(), cfg, pdf));
+    return frame;
+}
+
+static std::vector<std::uint8_t> config2Frame(const Config &cfg)
+{
+    std::vector<std::uint8_t> frame(1024);
+    frame.resize(generateConfig2(frame.data(), frame.size(), cfg));
+    return frame;
+}
+
+class udpReceiver: public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        receiver.setInterface("127.0.0.1", "0");
+        receiver.setReceiveBufferSize(1 << 22);
+        receiver.setFrameCall([this](const pmu::ReceivedFrame &received) { onFrame(received); });
+    }
+    void TearDown() override
+    {
+        receiver.stopReceiving();
+        runner.stop();
+    }
+    void run() { runner.start(context); }
+    void send(const std::vector<std::uint8_t> &datagram)
+    {
+        sender.send_to(asio::buffer(datagram), udp::endpoint(asio::ip::make_address("127.0.0.1"), receiver.getPort()));
+    }
+    bool waitForFrames(std::uint64_t count)
+    {
+        return waitFor(wait_timeout, [this, count]() { return receiver.framesReceived() >= count; });
+    }
+    void onFrame(const pmu::ReceivedFrame &received)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto now = std::chrono::system_clock::now().time_since_epoch();
+        if (received.receiveTime > now || now - received.receiveTime > std::chrono::seconds(5))
+        {
+            ++badTimes;
+        }
+        if (received.type != PmuPacketType::data)
+        {
+            return;
+        }
+        if (received.config == nullptr)
+        {
+            ++unrouted;
+            return;
+        }
+        PmuDataFrame pdf;
+        if (received.config->idcode == received.idcode &&
+            parseDataFrame(received.frame.data, received.frame.size, *received.config, pdf) ==
+              ParseResult::parse_complete &&
+            pdf.pmus.size() == 1U && std::abs(pdf.pmus[0].phasors[0] - std::polar(120.0, 0.0)) < 0.05)
+        {
+            ++routed[received.idcode];
+        }
+        else
+        {
+            ++misrouted;
+        }
+    }
+
+    asio::io_context context;
+    asio::io_context senderContext;
+    udp::socket sender{senderContext, udp::endpoint(udp::v4(), 0)};
+    pmu::UdpReceiver receiver;
+    IoRunner runner;
+
+    std::mutex mutex;
+    std::map<std::uint16_t, int> routed;
+    int misrouted{0};
+    int unrouted{0};
+    int badTimes{0};
+};
+
+TEST_F(udpReceiver, learned_streams)
+{
+    constexpr std::uint16_t stream_count{500U};
+    ASSERT_TRUE(receiver.startReceiving(context));
+    ASSERT_NE(receiver.getPort(), 0U);
+    run();
+
+    std::vector<Config> configs;
+    for (std::uint16_t ii = 0; ii < stream_count; ++ii)
+    {
+        configs.push_back(mixedStreamConfig(static_cast<std::uint16_t>(1000U + ii)));
+        send(config2Frame(configs.back()));
+    }
+    ASSERT_TRUE(waitForFrames(stream_count));
+    for (std::uint32_t soc = 1; soc <= 2; ++soc)
+    {
+        for (const auto &cfg : configs)
+        {
+            // two frames in each datagram
+            auto datagram = dataFrame(cfg, soc * 2U);
+            auto second = dataFrame(cfg, soc * 2U + 1U);
+            datagram.insert(datagram.end(), second.begin(), second.end());
+            send(datagram);
+            if (cfg.idcode % 100 == 0)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+    // a stream which has not sent its configuration
+    send(dataFrame(mixedStreamConfig(60000U), 1U));
+    const std::uint64_t expected = stream_count + stream_count * 4U + 1U;
+    ASSERT_TRUE(waitForFrames(expected));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(receiver.framesReceived(), expected);
+    EXPECT_EQ(receiver.datagramsReceived(), stream_count * 3U + 1U);
+    EXPECT_EQ(receiver.unknownFrames(), 1U);
+    EXPECT_EQ(misrouted, 0);
+    EXPECT_EQ(unrouted, 1);
+    EXPECT_EQ(badTimes, 0);
+    ASSERT_EQ(routed.size(), stream_count);
+    for (const auto &stream : routed)
+    {
+        EXPECT_EQ(stream.second, 4);
+    }
+}
+
+TEST_F(udpReceiver, batched_receive)
+{
+    constexpr std::uint16_t stream_count{64U};
+    std::vector<Config> configs;
+    for (std::uint16_t ii = 0; ii < stream_count; ++ii)
+    {
+        configs.push_back(mixedStreamConfig(static_cast<std::uint16_t>(ii + 1U)));
+        receiver.addStream(configs.back());
+    }
+    receiver.setConfigLearning(false);
+    ASSERT_TRUE(receiver.startReceiving(context));
+    // the datagrams are queued on the socket before the receiver runs
+    for (const auto &cfg : configs)
+    {
+        send(dataFrame(cfg, 1U));
+    }
+    // a config2 frame is not applied with learning disabled
+    auto changed = mixedStreamConfig(5U);
+    changed.pmus[0].phasorFormat ^= floating_point_format;
+    send(config2Frame(changed));
+    send(dataFrame(configs[4], 2U));
+    run();
+    ASSERT_TRUE(waitForFrames(stream_count + 2U));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(receiver.datagramsReceived(), stream_count + 2U);
+    EXPECT_EQ(misrouted, 0);
+    EXPECT_EQ(routed.size(), stream_count);
+    EXPECT_EQ(routed[5], 2);
+    EXPECT_EQ(badTimes, 0);
+#ifdef __linux__
+    // the queued datagrams are drained with a few recvmmsg calls
+    EXPECT_LE(receiver.receiveCalls(), 8U);
+#endif
+}
+
+TEST_F(udpReceiver, sharded)
+{
+    constexpr std::uint16_t stream_count{200U};
+    constexpr std::uint32_t frame_count{5U};
+    constexpr int shard_count{4};
+    std::vector<Config> configs;
+    for (std::uint16_t ii = 0; ii < stream_count; ++ii)
+    {
+        configs.push_back(mixedStreamConfig(static_cast<std::uint16_t>(2000U + ii)));
+        receiver.addStream(configs.back());
+    }
+    receiver.setConfigLearning(false);
+    receiver.setShardCount(shard_count);
+
+    std::map<std::uint16_t, std::vector<std::uint32_t>> socs;
+    std::map<std::uint16_t, std::set<std::size_t>> streamShards;
+    std::set<std::size_t> usedShards;
+    std::set<std::thread::id> callThreads;
+    std::size_t delivered{0U};
+    receiver.setFrameCall([&](const pmu::ReceivedFrame &received) {
+        std::lock_guard<std::mutex> lock(mutex);
+        CommonFrame common;
+        if (received.config != nullptr &&
+            parseCommon(received.frame.data, received.frame.size, common) == ParseResult::parse_complete)
+        {
+            socs[received.idcode].push_back(common.soc);
+        }
+        streamShards[received.idcode].insert(received.shard);
+        usedShards.insert(received.shard);
+        callThreads.insert(std::this_thread::get_id());
+        ++delivered;
+    });
+    ASSERT_TRUE(receiver.startReceiving(context));
+    run();
+
+    // each stream sends from several sockets so distributing by address would spread it over the shards
+    std::vector<std::unique_ptr<udp::socket>> senders;
+    for (int ii = 0; ii < shard_count; ++ii)
+    {
+        senders.push_back(std::make_unique<udp::socket>(senderContext, udp::endpoint(udp::v4(), 0)));
+    }
+    const udp::endpoint destination(asio::ip::make_address("127.0.0.1"), receiver.getPort());
+    for (std::uint32_t soc = 1; soc <= frame_count; ++soc)
+    {
+        for (std::size_t ii = 0; ii < configs.size(); ++ii)
+        {
+            senders[(ii + soc) % senders.size()]->send_to(asio::buffer(dataFrame(configs[ii], soc)), destination);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const std::size_t expected = stream_count * frame_count;
+    waitFor(wait_timeout, [&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return delivered >= expected;
+    });
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(delivered, expected);
+    EXPECT_EQ(receiver.framesReceived(), expected);
+    ASSERT_EQ(socs.size(), stream_count);
+    const std::vector<std::uint32_t> inOrder{1U, 2U, 3U, 4U, 5U};
+    for (const auto &stream : socs)
+    {
+        EXPECT_EQ(stream.second, inOrder) << "stream " << stream.first;
+    }
+    // the merge stage delivers every frame on the thread running the receiver's io_context
+    ASSERT_EQ(callThreads.size(), 1U);
+    EXPECT_EQ(*callThreads.begin(), runner.threadId());
+#ifdef __linux__
+    // the frames of each stream are all received by the shard selected by the idcode
+    for (const auto &stream : streamShards)
+    {
+        ASSERT_EQ(stream.second.size(), 1U);
+        EXPECT_EQ(*stream.second.begin(), stream.first % shard_count);
+    }
+    EXPECT_EQ(usedShards.size(), static_cast<std::size_t>(shard_count));
+#endif
+}